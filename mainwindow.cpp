@@ -132,6 +132,8 @@ void MainWindow::initConnections()
     // 设备管理模块信号连接
     connect(m_deviceManagement, &DeviceManagementModule::statusChanged,
             this, &MainWindow::updateStatusBar);
+    connect(m_deviceManagement, &DeviceManagementModule::streamGeometryChanged,
+            m_calibration, &CalibrationModule::setStreamGeometry);
     // connect(m_deviceManagement, &DeviceManagementModule::deviceConnected,
     //         m_dataAcquisition, &DataAcquisitionModule::onDeviceConnected);
     
@@ -146,6 +148,10 @@ void MainWindow::initConnections()
             this, &MainWindow::updateStatusBar);
     connect(m_calibration, &CalibrationModule::calibrationComplete,
             m_resultVerification, &ResultVerificationModule::onCalibrationCompleted);
+    connect(m_calibration, &CalibrationModule::calibrationComplete,
+            m_dataAcquisition, [this](const CalibrationResult& result) {
+                m_dataAcquisition->setViewErrors(result.viewFrameIds, result.perViewErrors);
+            });
     
     // 结果验证模块信号连接
     connect(m_resultVerification, &ResultVerificationModule::statusChanged,
@@ -160,6 +166,12 @@ void MainWindow::initConnections()
             this, &MainWindow::updateSetting);
     connect(m_setting, &SettingsModule::settingsChanged,
             m_calibration, &CalibrationModule::updateCalibSetting);
+    connect(m_setting, &SettingsModule::settingsChanged,
+            m_deviceManagement, &DeviceManagementModule::updateCaptureSetting);
+    connect(m_setting, &SettingsModule::settingsChanged,
+            m_dataAcquisition, &DataAcquisitionModule::updateAcquisitionSetting);
+    m_deviceManagement->updateCaptureSetting(m_setting->getCurrentSettings());
+    m_dataAcquisition->updateAcquisitionSetting(m_setting->getCurrentSettings());
 }
 
 
@@ -0,0 +1,402 @@
+#include "acquisition_engine.h"
+#include <QDeadlineTimer>
+#include <QMetaMethod>
+#include <QDebug>
+#include <chrono>
+
+/*-------------------------------- GrabWorker --------------------------------*/
+// 链路统计采样间隔(us)
+static const qint64 LINK_SAMPLE_INTERVAL_US = 1000000;
+// 画面统计的采样行间隔：12 MP 下约 1/4 的像素参与，统计量足够稳定
+static const int ANALYTICS_ROW_STEP = 4;
+
+GrabWorker::GrabWorker(CMvCamera* camera, int cameraIndex, PixelConverter::OutputMode outputMode,
+                       std::shared_ptr<StreamTelemetry> telemetry, std::shared_ptr<FrameRing> rawRing)
+    : m_camera(camera), m_cameraIndex(cameraIndex), m_abort(0), m_outputMode(outputMode)
+    , m_telemetry(std::move(telemetry))
+    , m_rawRing(std::move(rawRing))
+{}
+
+// 读取 SDK 的链路统计：GigE 取丢包/重发，U3V 取错误帧；首次调用时探测接口类型
+void GrabWorker::sampleLinkStats()
+{
+    if (!m_telemetry || m_linkType == 0) return;
+
+    StreamTelemetry::LinkStats link;
+    if (m_linkType != 2) {
+        MV_MATCH_INFO_NET_DETECT net{};
+        if (m_camera->GetGevAllMatchInfo(&net) == MV_OK) {
+            m_linkType = 1;
+            link.valid          = true;
+            link.gige           = true;
+            link.receivedBytes  = net.nReceiveDataSize;
+            link.lostPackets    = net.nLostPacketCount;
+            link.lostFrames     = net.nLostFrameCount;
+            link.receivedFrames = net.nNetRecvFrameCount;
+            link.resendRequests = net.nRequestResendPacketCount;
+            link.resends        = net.nResendPacketCount;
+        }
+    }
+    if (!link.valid && m_linkType != 1) {
+        MV_MATCH_INFO_USB_DETECT usb{};
+        if (m_camera->GetU3VAllMatchInfo(&usb) == MV_OK) {
+            m_linkType = 2;
+            link.valid          = true;
+            link.receivedBytes  = usb.nReceiveDataSize;
+            link.receivedFrames = usb.nReceivedFrameCount;
+            link.errorFrames    = usb.nErrorFrameCount;
+        }
+    }
+    if (!link.valid) {
+        if (m_linkType < 0) m_linkType = 0;
+        return;
+    }
+    link.sampledAt = AcquisitionEngine::hostTimestampUs();
+    m_telemetry->updateLink(link);
+}
+
+// 首帧或像素格式/尺寸变化时选定转换内核，并按输出尺寸分配结果缓存
+bool GrabWorker::configureConverter(const MV_FRAME_OUT_INFO_EX& info)
+{
+    if (!m_converter.configure(info.enPixelType, info.nWidth, info.nHeight, m_outputMode))
+        return false;
+    if (m_converter.isPassthrough()) {
+        m_outputPool.release();
+        return true;
+    }
+    const int count = qMax(m_camera->GetFramePool()->bufferCount(), 2);
+    if (!m_outputPool.allocate(m_converter.outputBytes(), count)) {
+        m_converter.reset();
+        return false;
+    }
+    return true;
+}
+
+// 录制等原始帧消费者：无人注册时不发布，并释放队列里残留的槽
+void GrabWorker::publishRaw(const FrameHandle& buffer)
+{
+    if (!m_rawRing) return;
+    if (m_rawRing->consumerCount() > 0) {
+        m_rawRing->push(buffer);
+        m_rawRingHolding = true;
+    } else if (m_rawRingHolding) {
+        m_rawRing->clear();
+        m_rawRingHolding = false;
+    }
+}
+
+void GrabWorker::abort()
+{
+    m_abort.storeRelease(1);
+}
+
+void GrabWorker::doWork()
+{
+    quint64 sequence = 0;
+    bool errorReported = false;
+    bool formatReported = false;
+    qint64 nextLinkSample = 0;
+
+    FramePool* pool = m_camera->GetFramePool();
+    while (!m_abort.loadAcquire()) {
+        if (m_telemetry && AcquisitionEngine::hostTimestampUs() >= nextLinkSample) {
+            sampleLinkStats();
+            nextLinkSample = AcquisitionEngine::hostTimestampUs() + LINK_SAMPLE_INTERVAL_US;
+        }
+
+        // SDK 直接写入池中的槽，取流路径上不再分配和拷贝
+        FrameHandle buffer = pool->acquire();
+        if (buffer.isNull()) {
+            // 所有槽都被消费者占用，稍等消费者归还
+            QThread::usleep(500);
+            continue;
+        }
+
+        // 超时取短一些，保证停止请求能及时响应
+        MV_FRAME_OUT_INFO_EX info{};
+        int ret = m_camera->GetOneFrameTimeout(buffer.data(), static_cast<unsigned int>(buffer.capacity()),
+                                               &info, 100);
+        if (ret != MV_OK) {
+            if (static_cast<unsigned int>(ret) != MV_E_NODATA && !errorReported) {
+                errorReported = true;
+                emit errorOccurred(tr("取图失败: 0x%1").arg(static_cast<unsigned int>(ret), 0, 16));
+            }
+            if (static_cast<unsigned int>(ret) != MV_E_NODATA)
+                QThread::msleep(10);
+            continue;
+        }
+        errorReported = false;
+        const qint64 arrival = AcquisitionEngine::hostTimestampUs();
+
+        // 与输出格式无关的元信息先写入原始槽，转换结果沿用
+        FrameMeta& rawMeta      = buffer.mutableMeta();
+        rawMeta.width           = info.nWidth;
+        rawMeta.height          = info.nHeight;
+        rawMeta.type            = CV_8UC1;
+        rawMeta.step            = 0;
+        rawMeta.cameraIndex     = m_cameraIndex;
+        rawMeta.sequence        = ++sequence;
+        rawMeta.frameNumber     = info.nFrameNum;
+        rawMeta.deviceTimestamp = (quint64(info.nDevTimeStampHigh) << 32) | info.nDevTimeStampLow;
+        rawMeta.hostTimestamp   = arrival;
+        rawMeta.pixelType       = info.enPixelType;
+        rawMeta.dataSize        = info.nFrameLen;
+        rawMeta.exposureTime    = info.fExposureTime;
+        rawMeta.gain            = info.fGain;
+        rawMeta.analytics.valid = false;
+
+        if (!m_converter.matches(info.enPixelType, info.nWidth, info.nHeight)
+            && !configureConverter(info)) {
+            publishRaw(buffer);     // 不支持转换的格式仍可录制
+            if (!formatReported) {
+                formatReported = true;
+                emit errorOccurred(tr("不支持的像素格式: 0x%1").arg(static_cast<unsigned int>(info.enPixelType), 0, 16));
+            }
+            continue;
+        }
+        formatReported = false;
+
+        // Mono8 直接分发原始缓存，其余格式转换到结果缓存后立即归还原始槽
+        qint64 convertUs = 0;
+        if (!m_converter.isPassthrough()) {
+            publishRaw(buffer);     // 原始槽此后只读
+            FrameHandle converted = m_outputPool.acquire();
+            if (converted.isNull()) {
+                // 结果缓存全部被消费者占用，丢弃本帧
+                if (m_telemetry) m_telemetry->recordLocalDrop();
+                continue;
+            }
+            const cv::Size size = m_converter.outputSize();
+            cv::Mat dst = converted.toMat(size.height, size.width, m_converter.outputType());
+            const qint64 convertStart = AcquisitionEngine::hostTimestampUs();
+            if (!m_converter.convert(buffer.data(), dst)) {
+                if (m_telemetry) m_telemetry->recordLocalDrop();
+                continue;
+            }
+            converted.mutableMeta() = buffer.meta();
+            buffer = std::move(converted);
+            convertUs = AcquisitionEngine::hostTimestampUs() - convertStart;
+        }
+
+        // 输出格式相关的元信息，发布到环形队列后消费者只读
+        const cv::Size size  = m_converter.outputSize();
+        FrameMeta& meta      = buffer.mutableMeta();
+        meta.width           = size.width;
+        meta.height          = size.height;
+        meta.type            = m_converter.outputType();
+        meta.step            = size.width * CV_ELEM_SIZE(meta.type);
+        meta.dataSize        = static_cast<unsigned int>(meta.step * size.height);
+
+        const qint64 analyzeStart = AcquisitionEngine::hostTimestampUs();
+        m_analyzer.analyze(buffer.toMat(), ANALYTICS_ROW_STEP, meta.analytics);
+        const qint64 analyzeUs = AcquisitionEngine::hostTimestampUs() - analyzeStart;
+        if (m_converter.isPassthrough())
+            publishRaw(buffer);     // 元信息写完再发布，避免与原始帧消费者竞争
+
+        const qint64 dispatchStart = AcquisitionEngine::hostTimestampUs();
+        emit frameGrabbed(AcquisitionEngine::frameFromHandle(buffer));
+
+        if (m_telemetry) {
+            StreamTelemetry::FrameRecord record;
+            record.sequence        = meta.sequence;
+            record.frameNumber     = meta.frameNumber;
+            record.lostPackets     = info.nLostPacket;
+            record.deviceTimestamp = meta.deviceTimestamp;
+            record.hostTimestamp   = arrival;
+            record.convertUs       = qint32(convertUs);
+            record.dispatchUs      = qint32(AcquisitionEngine::hostTimestampUs() - dispatchStart);
+            m_telemetry->recordFrame(record);
+            if (!m_converter.isPassthrough())
+                m_telemetry->recordStage(StreamTelemetry::Convert, record.convertUs);
+            m_telemetry->recordStage(StreamTelemetry::Analyze, analyzeUs);
+            m_telemetry->recordStage(StreamTelemetry::Dispatch, record.dispatchUs);
+        }
+    }
+}
+
+/*-------------------------------- AcquisitionEngine --------------------------------*/
+AcquisitionEngine::AcquisitionEngine(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<AcquiredFrame>("AcquiredFrame");
+}
+
+AcquisitionEngine::~AcquisitionEngine()
+{
+    stopAll();
+}
+
+AcquiredFrame AcquisitionEngine::frameFromHandle(const FrameHandle& handle)
+{
+    AcquiredFrame frame;
+    if (handle.isNull()) return frame;
+    const FrameMeta& meta = handle.meta();
+    frame.image           = handle.toMat();
+    frame.buffer          = handle;
+    frame.cameraIndex     = meta.cameraIndex;
+    frame.sequence        = meta.sequence;
+    frame.frameNumber     = meta.frameNumber;
+    frame.deviceTimestamp = meta.deviceTimestamp;
+    frame.hostTimestamp   = meta.hostTimestamp;
+    frame.pixelType       = meta.pixelType;
+    return frame;
+}
+
+qint64 AcquisitionEngine::hostTimestampUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool AcquisitionEngine::start(CMvCamera* camera, int cameraIndex, PixelConverter::OutputMode outputMode)
+{
+    if (!camera || isRunning(cameraIndex)) return false;
+
+    StreamPtr stream = std::make_shared<Stream>();
+    stream->ring = std::make_shared<FrameRing>();
+    stream->rawRing = std::make_shared<FrameRing>();
+    stream->telemetry = std::make_shared<StreamTelemetry>(cameraIndex);
+    GrabWorker* worker = new GrabWorker(camera, cameraIndex, outputMode, stream->telemetry, stream->rawRing);
+    stream->worker = worker;
+    // 抓图循环即线程主体，循环退出线程即结束
+    stream->thread = QThread::create([worker]() { worker->doWork(); });
+
+    connect(stream->worker, &GrabWorker::errorOccurred, this, &AcquisitionEngine::errorOccurred);
+    // 直连：在抓图线程中分发，避免每帧都经过 GUI 事件循环
+    connect(stream->worker, &GrabWorker::frameGrabbed, stream->worker,
+            [this, stream](const AcquiredFrame& frame) { dispatchFrame(stream, frame); },
+            Qt::DirectConnection);
+
+    {
+        QMutexLocker locker(&m_streamsMutex);
+        m_streams.insert(cameraIndex, stream);
+        m_telemetry.insert(cameraIndex, stream->telemetry);
+    }
+    stream->thread->start();
+    return true;
+}
+
+void AcquisitionEngine::stop(int cameraIndex)
+{
+    StreamPtr stream;
+    {
+        QMutexLocker locker(&m_streamsMutex);
+        stream = m_streams.take(cameraIndex);
+    }
+    if (!stream) return;
+
+    stream->worker->abort();
+    if (!stream->thread->wait(3000))
+        qDebug() << "Grab thread termination timed out.";
+
+    {
+        QMutexLocker locker(&stream->mutex);
+        stream->stopped = true;
+        stream->latest = AcquiredFrame();
+        stream->frameArrived.wakeAll();
+    }
+    stream->ring->clear();      // 归还队列持有的缓存槽
+    stream->rawRing->clear();
+    delete stream->worker;
+    delete stream->thread;
+    stream->worker = nullptr;
+    stream->thread = nullptr;
+}
+
+void AcquisitionEngine::stopAll()
+{
+    QList<int> indices;
+    {
+        QMutexLocker locker(&m_streamsMutex);
+        indices = m_streams.keys();
+    }
+    for (int index : indices)
+        stop(index);
+}
+
+bool AcquisitionEngine::isRunning(int cameraIndex) const
+{
+    QMutexLocker locker(&m_streamsMutex);
+    return m_streams.contains(cameraIndex);
+}
+
+AcquisitionEngine::StreamPtr AcquisitionEngine::findStream(int cameraIndex) const
+{
+    QMutexLocker locker(&m_streamsMutex);
+    return m_streams.value(cameraIndex);
+}
+
+std::shared_ptr<StreamTelemetry> AcquisitionEngine::telemetry(int cameraIndex) const
+{
+    QMutexLocker locker(&m_streamsMutex);
+    return m_telemetry.value(cameraIndex);
+}
+
+std::shared_ptr<FrameRing> AcquisitionEngine::frameRing(int cameraIndex) const
+{
+    StreamPtr stream = findStream(cameraIndex);
+    return stream ? stream->ring : nullptr;
+}
+
+std::shared_ptr<FrameRing> AcquisitionEngine::rawFrameRing(int cameraIndex) const
+{
+    StreamPtr stream = findStream(cameraIndex);
+    return stream ? stream->rawRing : nullptr;
+}
+
+bool AcquisitionEngine::latestFrame(int cameraIndex, AcquiredFrame& frame) const
+{
+    StreamPtr stream = findStream(cameraIndex);
+    if (!stream) return false;
+
+    QMutexLocker locker(&stream->mutex);
+    if (stream->latest.image.empty()) return false;
+    frame = stream->latest;
+    return true;
+}
+
+bool AcquisitionEngine::waitForFrame(int cameraIndex, quint64 afterSequence,
+                                     AcquiredFrame& frame, int timeoutMs)
+{
+    StreamPtr stream = findStream(cameraIndex);
+    if (!stream) return false;
+
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&stream->mutex);
+    while (!stream->stopped && stream->latest.sequence <= afterSequence) {
+        if (!stream->frameArrived.wait(&stream->mutex, deadline))
+            return false;
+    }
+    if (stream->stopped) return false;
+    frame = stream->latest;
+    return true;
+}
+
+void AcquisitionEngine::dispatchFrame(const StreamPtr& stream, const AcquiredFrame& frame)
+{
+    {
+        QMutexLocker locker(&stream->mutex);
+        stream->latest = frame;
+        stream->frameArrived.wakeAll();
+    }
+
+    // 队列中的消费者各按自己的策略取帧，不会反压到这里（Block 策略除外）
+    stream->ring->push(frame.buffer);
+
+    emit frameAcquired(frame);
+
+    // 预览合并：GUI 还没处理完上一帧就不再投递，投递时取当时最新的一帧；无人接收时不投递
+    static const QMetaMethod previewSignal = QMetaMethod::fromSignal(&AcquisitionEngine::previewFrameReady);
+    if (isSignalConnected(previewSignal) && stream->previewPending.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, [this, stream]() {
+            AcquiredFrame latest;
+            {
+                QMutexLocker locker(&stream->mutex);
+                if (stream->stopped) return;
+                latest = stream->latest;
+            }
+            stream->previewPending.storeRelease(0);
+            emit previewFrameReady(latest);
+        }, Qt::QueuedConnection);
+    }
+}
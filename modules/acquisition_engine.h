@@ -0,0 +1,140 @@
+#ifndef ACQUISITION_ENGINE_H
+#define ACQUISITION_ENGINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QHash>
+#include <QMetaType>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "cmvcamera.h"
+#include "frame_pool.h"
+#include "frame_ring.h"
+#include "pixel_convert.h"
+#include "telemetry.h"
+
+// 采集帧：图像数据 + 时间戳等元信息
+// image 是 buffer 所指缓存槽的视图，帧对象全部析构后槽自动归还缓存池
+// image 已按流的输出模式转换（默认 8 位灰度），pixelType 记录相机原始格式
+struct AcquiredFrame {
+    cv::Mat      image;                 // 图像数据（视图）
+    FrameHandle  buffer;                // 缓存槽引用
+    int          cameraIndex = -1;      // 相机编号
+    quint64      sequence = 0;          // 本地递增序号
+    unsigned int frameNumber = 0;       // 设备帧号
+    quint64      deviceTimestamp = 0;   // 设备时间戳
+    qint64       hostTimestamp = 0;     // 主机到达时间(us)
+    unsigned int pixelType = 0;         // MvGvspPixelType
+};
+Q_DECLARE_METATYPE(AcquiredFrame)
+
+// 抓图工作线程：每台相机一个，循环 GetImageBuffer
+class GrabWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    GrabWorker(CMvCamera* camera, int cameraIndex,
+               PixelConverter::OutputMode outputMode = PixelConverter::Gray8,
+               std::shared_ptr<StreamTelemetry> telemetry = nullptr,
+               std::shared_ptr<FrameRing> rawRing = nullptr);
+
+public slots:
+    void doWork();
+    void abort();
+
+signals:
+    // 在抓图线程中发出，接收方需自行决定连接方式
+    void frameGrabbed(const AcquiredFrame& frame);
+    void errorOccurred(QString error);
+
+private:
+    bool configureConverter(const MV_FRAME_OUT_INFO_EX& info);
+    void sampleLinkStats();
+    void publishRaw(const FrameHandle& buffer);
+
+    CMvCamera* m_camera;
+    int m_cameraIndex;
+    QAtomicInt m_abort;
+    PixelConverter::OutputMode m_outputMode;
+    PixelConverter m_converter;         // 只在抓图线程中使用
+    FrameAnalyzer m_analyzer;           // 逐帧画面统计，写入 FrameMeta::analytics
+    FramePool m_outputPool;             // 转换结果缓存（直通格式不使用）
+    std::shared_ptr<StreamTelemetry> m_telemetry;
+    std::shared_ptr<FrameRing> m_rawRing;   // 转换前的 SDK 原始帧，仅在有消费者时发布
+    bool m_rawRingHolding = false;          // 原始帧队列仍持有缓存槽
+    int m_linkType = -1;                // 链路统计接口：-1 未探测，0 不支持，1 GigE，2 U3V
+};
+
+// 采集引擎：管理各相机抓图线程并向预览/采集/分析分发帧
+class AcquisitionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AcquisitionEngine(QObject* parent = nullptr);
+    ~AcquisitionEngine() override;
+
+    // 启动/停止指定相机的抓图线程（相机需已 StartGrabbing，缓存池已分配）
+    // outputMode 决定分发帧的格式，转换内核按流选定一次
+    bool start(CMvCamera* camera, int cameraIndex,
+               PixelConverter::OutputMode outputMode = PixelConverter::Gray8);
+    void stop(int cameraIndex);
+    void stopAll();
+    bool isRunning(int cameraIndex) const;
+
+    // 最新一帧（线程安全，不阻塞）
+    bool latestFrame(int cameraIndex, AcquiredFrame& frame) const;
+
+    // 等待序号大于 afterSequence 的新帧，供非 GUI 线程使用
+    bool waitForFrame(int cameraIndex, quint64 afterSequence,
+                      AcquiredFrame& frame, int timeoutMs);
+
+    // 帧环形队列：录制、实时检测等消费者在此注册自己的游标和丢帧策略
+    std::shared_ptr<FrameRing> frameRing(int cameraIndex) const;
+    // 原始帧队列：SDK 输出的未转换数据（按 meta.dataSize 读取，不能 toMat），供录制使用
+    std::shared_ptr<FrameRing> rawFrameRing(int cameraIndex) const;
+    // 采集遥测：停止后仍保留最近一次的统计，供导出
+    std::shared_ptr<StreamTelemetry> telemetry(int cameraIndex) const;
+
+    // 单调主机时钟(us)
+    static qint64 hostTimestampUs();
+
+    // 由缓存槽及其元信息构造采集帧（不拷贝）
+    static AcquiredFrame frameFromHandle(const FrameHandle& handle);
+
+signals:
+    // 每帧都发出（抓图线程上下文），分析类消费者用 QueuedConnection 接收
+    void frameAcquired(const AcquiredFrame& frame);
+    // 预览帧：GUI 线程中最多只有一帧待处理，处理不过来时直接丢弃旧帧
+    void previewFrameReady(const AcquiredFrame& frame);
+    void errorOccurred(const QString& error);
+
+private:
+    struct Stream {
+        QThread*       thread = nullptr;
+        GrabWorker*    worker = nullptr;
+        QMutex         mutex;
+        QWaitCondition frameArrived;
+        AcquiredFrame  latest;
+        std::shared_ptr<FrameRing> ring;
+        std::shared_ptr<FrameRing> rawRing;
+        std::shared_ptr<StreamTelemetry> telemetry;
+        bool           stopped = false;
+        QAtomicInt     previewPending;
+    };
+    using StreamPtr = std::shared_ptr<Stream>;
+
+    // 在抓图线程中执行：更新最新帧、唤醒等待者、分发
+    void dispatchFrame(const StreamPtr& stream, const AcquiredFrame& frame);
+    StreamPtr findStream(int cameraIndex) const;
+
+    mutable QMutex m_streamsMutex;
+    QHash<int, StreamPtr> m_streams;
+    QHash<int, std::shared_ptr<StreamTelemetry>> m_telemetry;   // 按相机保留
+};
+
+#endif // ACQUISITION_ENGINE_H
@@ -0,0 +1,175 @@
+#include "board_tracker.h"
+#include <QDebug>
+#include <algorithm>
+
+// 预测区域超过整帧的这一比例时直接整帧检测
+static const double MAX_ROI_AREA_RATIO = 0.8;
+
+BoardTracker::BoardTracker(QObject* parent)
+    : QObject(parent)
+    , m_abort(0)
+    , m_processed(0)
+    , m_found(0)
+    , m_tracked(0)
+    , m_detectNs(0)
+{
+    qRegisterMetaType<BoardTracker::Overlay>();
+}
+
+BoardTracker::~BoardTracker()
+{
+    stop();
+}
+
+bool BoardTracker::start(std::shared_ptr<FrameRing> ring, const Options& options)
+{
+    if (!ring || m_thread) return false;
+    if (options.boardSize.width < 2 || options.boardSize.height < 2) return false;
+
+    m_consumerId = ring->addConsumer(QStringLiteral("overlay"), FrameRing::LatestOnly);
+    if (m_consumerId < 0) return false;
+
+    m_ring = std::move(ring);
+    m_options = options;
+    m_previous.clear();
+    m_abort.storeRelease(0);
+    m_processed.storeRelease(0);
+    m_found.storeRelease(0);
+    m_tracked.storeRelease(0);
+    m_detectNs.storeRelease(0);
+    m_clock.start();
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    return true;
+}
+
+void BoardTracker::stop()
+{
+    if (!m_thread) return;
+
+    m_abort.storeRelease(1);
+    if (!m_thread->wait(3000))
+        qDebug() << "Board tracker thread termination timed out.";
+    delete m_thread;
+    m_thread = nullptr;
+
+    m_ring->removeConsumer(m_consumerId);
+    m_consumerId = -1;
+    m_ring.reset();
+}
+
+BoardTracker::Stats BoardTracker::stats() const
+{
+    Stats out;
+    out.processed = m_processed.loadAcquire();
+    out.found     = m_found.loadAcquire();
+    out.tracked   = m_tracked.loadAcquire();
+    if (out.processed > 0)
+        out.avgDetectMs = m_detectNs.loadAcquire() / 1e6 / out.processed;
+    const qint64 elapsedMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+    if (elapsedMs > 0)
+        out.fps = out.processed * 1000.0 / elapsedMs;
+    return out;
+}
+
+void BoardTracker::run()
+{
+    while (!m_abort.loadAcquire()) {
+        FrameHandle frame;
+        if (!m_ring->waitPop(m_consumerId, frame, 100))
+            continue;
+
+        const cv::Mat src = frame.toMat();
+        if (src.empty() || (src.type() != CV_8UC1 && src.type() != CV_16UC1))
+            continue;
+
+        QElapsedTimer timer;
+        timer.start();
+        const cv::Rect full(0, 0, src.cols, src.rows);
+        std::vector<cv::Point2f> corners;
+        Overlay overlay;
+
+        // 先在上一帧角点外框 + 运动余量内检测
+        if (!m_previous.empty()) {
+            cv::Rect roi = cv::boundingRect(m_previous);
+            const int margin = int(std::max(roi.width, roi.height) * m_options.roiMargin);
+            roi = cv::Rect(roi.x - margin, roi.y - margin, roi.width + 2 * margin, roi.height + 2 * margin) & full;
+            if (roi.area() < full.area() * MAX_ROI_AREA_RATIO)
+                overlay.tracked = detectIn(src, roi, corners);
+        }
+        overlay.found = overlay.tracked || detectIn(src, full, corners);
+
+        overlay.boardSize = m_options.boardSize;
+        overlay.hostTimestamp = frame.meta().hostTimestamp;
+        if (overlay.found) {
+            overlay.corners.reserve(int(corners.size()));
+            for (const cv::Point2f& p : corners)
+                overlay.corners.append(QPointF((p.x + 0.5) / src.cols, (p.y + 0.5) / src.rows));
+            m_previous.swap(corners);
+        } else {
+            m_previous.clear();
+        }
+        frame.reset();
+
+        const qint64 ns = timer.nsecsElapsed();
+        overlay.detectMs = ns / 1e6;
+        m_detectNs.fetchAndAddRelaxed(ns);
+        m_processed.fetchAndAddRelaxed(1);
+        if (overlay.found) m_found.fetchAndAddRelaxed(1);
+        if (overlay.tracked) m_tracked.fetchAndAddRelaxed(1);
+        emit overlayReady(overlay);
+    }
+}
+
+// 在 roi 内检测：金字塔逐级减半到 detectWidth 以下，角点换算回原分辨率后在区域内做亚像素细化
+bool BoardTracker::detectIn(const cv::Mat& image, const cv::Rect& roi, std::vector<cv::Point2f>& corners)
+{
+    cv::Mat level = image(roi);
+    double factor = 1.0;
+    int next = 0;
+    while (level.cols > m_options.detectWidth && level.rows > 16) {
+        cv::pyrDown(level, m_levels[next]);     // 两个缓存交替，避免原地缩小
+        level = m_levels[next];
+        next ^= 1;
+        factor *= 2.0;
+    }
+    if (level.type() == CV_16UC1) {
+        level.convertTo(m_reduced, CV_8U, 1.0 / 256);
+        level = m_reduced;
+    }
+
+    if (!cv::findChessboardCorners(level, m_options.boardSize, corners,
+                                   cv::CALIB_CB_ADAPTIVE_THRESH + cv::CALIB_CB_NORMALIZE_IMAGE
+                                       + cv::CALIB_CB_FAST_CHECK))
+        return false;
+    for (cv::Point2f& p : corners) {
+        p.x = float(p.x * factor + roi.x);
+        p.y = float(p.y * factor + roi.y);
+    }
+
+    // 细化窗口取相邻角点间距的 0.4 倍，只覆盖角点外框附近的原分辨率像素
+    double spacing = cv::norm(corners[0] - corners[1]);
+    spacing = std::min(spacing, double(cv::norm(corners[0] - corners[size_t(m_options.boardSize.width)])));
+    const int win = std::max(2, std::min(11, int(spacing * 0.4)));
+    cv::Rect refine = cv::boundingRect(corners);
+    refine = cv::Rect(refine.x - win - 2, refine.y - win - 2, refine.width + 2 * win + 4, refine.height + 2 * win + 4)
+             & cv::Rect(0, 0, image.cols, image.rows);
+    cv::Mat gray = image(refine);
+    if (gray.type() == CV_16UC1) {
+        gray.convertTo(m_gray, CV_8U, 1.0 / 256);
+        gray = m_gray;
+    }
+
+    for (cv::Point2f& p : corners) {
+        p.x -= refine.x;
+        p.y -= refine.y;
+    }
+    cv::cornerSubPix(gray, corners, cv::Size(win, win), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::MAX_ITER, 20, 0.05));
+    for (cv::Point2f& p : corners) {
+        p.x += refine.x;
+        p.y += refine.y;
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef BOARD_TRACKER_H
+#define BOARD_TRACKER_H
+
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QPointF>
+#include <QMetaType>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "frame_ring.h"
+
+// 实时棋盘格跟踪：在独立线程中按 LatestOnly 从帧队列取帧，结果用于预览叠加
+//   - 上一帧检测到时，按其角点外框加运动余量预测本帧区域，只在该区域内检测；
+//     预测失败再退回整帧
+//   - 检测在金字塔缩小到 detectWidth 以下的图像上进行
+//   - 亚像素细化只在原分辨率的区域内进行
+// 取帧不占用预览的游标，跟不上帧率时只是跳过中间帧，不影响预览
+class BoardTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        cv::Size boardSize = cv::Size(9, 6);    // 内角点数
+        int      detectWidth = 800;             // 检测图像最大宽度
+        double   roiMargin = 0.25;              // 预测区域在角点外框基础上的外扩比例
+    };
+
+    struct Overlay {
+        bool             found = false;
+        bool             tracked = false;   // 由预测区域检测到（未做整帧搜索）
+        QVector<QPointF> corners;           // 归一化到 [0,1] 的图像坐标，按行排列
+        cv::Size         boardSize;
+        qint64           hostTimestamp = 0;
+        double           detectMs = 0;
+    };
+
+    struct Stats {
+        quint64 processed = 0;
+        quint64 found = 0;
+        quint64 tracked = 0;            // 预测区域命中次数
+        double  avgDetectMs = 0;
+        double  fps = 0;
+    };
+
+    explicit BoardTracker(QObject* parent = nullptr);
+    ~BoardTracker() override;
+
+    bool start(std::shared_ptr<FrameRing> ring, const Options& options = Options());
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    Stats stats() const;
+
+signals:
+    // 在跟踪线程中发出
+    void overlayReady(const BoardTracker::Overlay& overlay);
+
+private:
+    void run();
+    bool detectIn(const cv::Mat& image, const cv::Rect& roi, std::vector<cv::Point2f>& corners);
+
+    std::shared_ptr<FrameRing> m_ring;
+    int        m_consumerId = -1;
+    QThread*   m_thread = nullptr;
+    QAtomicInt m_abort;
+    Options    m_options;
+
+    // 以下只在跟踪线程中访问
+    std::vector<cv::Point2f> m_previous;    // 上一帧的角点（原分辨率）
+    cv::Mat m_levels[2];                    // 金字塔各级
+    cv::Mat m_reduced;
+    cv::Mat m_gray;
+
+    QAtomicInteger<quint64> m_processed;
+    QAtomicInteger<quint64> m_found;
+    QAtomicInteger<quint64> m_tracked;
+    QAtomicInteger<qint64>  m_detectNs;
+    QElapsedTimer m_clock;                  // 自 start() 起的运行时间
+};
+
+Q_DECLARE_METATYPE(BoardTracker::Overlay)
+
+#endif // BOARD_TRACKER_H
@@ -1,5 +1,6 @@
 #include "calibration.h"
 #include "ui_calibration.h"
+#include "duplicate_filter.h"
 #include <QMessageBox>
 #include <QDateTime>
 #include <QFileDialog>
@@ -13,6 +14,25 @@
 #include <QtCharts/QChartView>
 
 
+cv::Mat cameraMatrixForStream(const CalibrationParameters& params, const StreamGeometry& geometry)
+{
+    if (params.cameraMatrix.empty() || !geometry.isValid()) return params.cameraMatrix.clone();
+
+    cv::Mat K;
+    params.cameraMatrix.convertTo(K, CV_64F);
+    // 标定尺寸与当前传感器尺寸不同（如旧文件按其他分辨率标定）时先按比例换算到传感器尺寸
+    if (params.imageSize.width > 0 && params.imageSize != geometry.sensorSize()) {
+        const double sx = double(geometry.sensorWidth) / params.imageSize.width;
+        const double sy = double(geometry.sensorHeight) / params.imageSize.height;
+        K.at<double>(0, 0) *= sx;
+        K.at<double>(0, 1) *= sx;
+        K.at<double>(1, 1) *= sy;
+        K.at<double>(0, 2) = (K.at<double>(0, 2) + 0.5) * sx - 0.5;
+        K.at<double>(1, 2) = (K.at<double>(1, 2) + 0.5) * sy - 0.5;
+    }
+    return geometry.cameraMatrixFromSensor(K);
+}
+
 /*-------------------------------- CalibrationWorker --------------------------------*/
 CalibrationWorker::CalibrationWorker(const QList<CalibrationData>& data,
                                      const cv::Size& boardSize,
@@ -54,17 +74,57 @@ CalibrationResult CalibrationWorker::performCalibration()
         for (int j = 0; j < m_boardSize.width; ++j)
             obj.emplace_back(j * m_squareSize, i * m_squareSize, 0.0f);
 
+    // 降采样/区域采集的图像把角点换算到全分辨率坐标，各种模式的图像可以一起标定
+    cv::Size imageSize = m_data.first().imageSize();
+    for (const auto& data : m_data) {
+        if (data.geometry.isValid()) {
+            imageSize = data.geometry.sensorSize();
+            break;
+        }
+    }
+
+    // 近似重复帧：外观重复的在读取像素前跳过，位姿重复的在提取角点后跳过
+    DuplicateFilter duplicates;
+    int skipped = 0;
     int progress = 0;
     for (const auto& data : m_data) {
         if (m_abort) break;
+        emit progressUpdated(++progress * 100 / m_data.size());
+
+        // 哈希随缩略图生成，尚未生成的帧与数据列表一样只按位姿判定
+        quint64 hash = 0;
+        const bool hasHash = !m_keepDuplicates && data.frame && data.frame->perceptualHash(hash);
+        if (hasHash && duplicates.matchHash(hash)) {
+            ++skipped;
+            continue;
+        }
+
+        // 像素经数据集缓存按需读取，用完即释放，内存不随图像数增长
+        const cv::Mat image = data.image();
 
         std::vector<cv::Point2f> corners;
-        bool ok = findChessboardCorners(data.image, m_boardSize, corners);
+        bool ok = findChessboardCorners(image, m_boardSize, corners);
+        // 与数据列表相同的规则：位姿按输出图像坐标、左上角起始的角点计算；未检到标定板的帧也保留为比较对象
+        CaptureGate::Pose pose = {};
+        if (ok && !m_keepDuplicates) {
+            std::vector<cv::Point2f> outline = corners;
+            CaptureGate::normalizeCorners(outline);
+            pose = CaptureGate::poseOf(outline, m_boardSize, image.size());
+            if (duplicates.matchPose(pose)) {
+                ++skipped;
+                continue;
+            }
+        }
+        if (!m_keepDuplicates)
+            duplicates.keep(quint64(progress), hasHash ? &hash : nullptr, ok ? &pose : nullptr);
+
         if (ok) {
+            if (data.geometry.isValid() && !data.geometry.isFullSensor())
+                for (cv::Point2f& p : corners) p = data.geometry.toSensor(p);
             imagePoints.emplace_back(corners);
             objectPoints.emplace_back(obj);
+            out.viewFrameIds.push_back(data.frame ? data.frame->id() : 0);
         }
-        emit progressUpdated(++progress * 100 / m_data.size());
     }
 
     if (imagePoints.empty()) {
@@ -78,7 +138,7 @@ CalibrationResult CalibrationWorker::performCalibration()
     std::vector<cv::Mat> rvecs, tvecs;
 
     double reprojErr = cv::calibrateCamera(objectPoints, imagePoints,
-                                           m_data.first().image.size(),
+                                           imageSize,
                                            cameraMatrix, distCoeffs,
                                            rvecs, tvecs);
 
@@ -87,11 +147,14 @@ CalibrationResult CalibrationWorker::performCalibration()
     out.params.rvecs        = rvecs;
     out.params.tvecs        = tvecs;
     out.params.reprojectionError = reprojErr;
+    out.params.imageSize    = imageSize;
     out.params.boardSize    = m_boardSize;
     out.params.squareSize   = m_squareSize;
     out.params.timestamp    = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
     out.success = true;
     out.message = tr("标定完成，重投影误差：%1 像素").arg(reprojErr);
+    if (skipped > 0)
+        out.message += tr("，跳过 %1 张近似重复图像").arg(skipped);
 
     //计算每幅图的重投影误差
     for (size_t i = 0; i < objectPoints.size(); ++i) {
@@ -124,8 +187,10 @@ bool CalibrationWorker::findChessboardCorners(const cv::Mat& image,
     cv::Mat gray;
     if (image.channels() == 3)
         cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    else if (image.depth() == CV_16U)
+        image.convertTo(gray, CV_8U, 1.0 / 256);     // 16 位灰度文件，检测只需 8 位
     else
-        gray = image.clone();
+        gray = image;       // 只读使用，灰度图（可能是映射区视图）不再整帧拷贝
 
     bool ok = cv::findChessboardCorners(gray, boardSize, corners,
                                         cv::CALIB_CB_ADAPTIVE_THRESH +
@@ -186,6 +251,14 @@ void CalibrationModule::updateCalibSetting(const AppSettings& settings){
     ui->boardWidthSpin->setValue(settings.defaultBoardWidth);
     ui->boardHeightSpin->setValue(settings.defaultBoardHeight);
     ui->squareSizeSpin->setValue(settings.defaultSquareSize);
+    m_keepDuplicates = settings.keepDuplicateFrames;
+}
+
+void CalibrationModule::setStreamGeometry(const StreamGeometry& geometry)
+{
+    m_streamGeometry = geometry;
+    if (m_currentResult.success)
+        displayCalibrationParameters(m_currentResult.params);
 }
 void CalibrationModule::onDataReady(const QList<CalibrationData>& data)
 {
@@ -206,6 +279,7 @@ void CalibrationModule::onStartCalibrationClicked()
 
     m_workerThread = new QThread(this);
     m_worker = new CalibrationWorker(m_calibrationData, boardSize, squareSize);
+    m_worker->setKeepDuplicates(m_keepDuplicates);
     m_worker->moveToThread(m_workerThread);
 
     connect(m_workerThread, &QThread::started, m_worker, &CalibrationWorker::doWork);
@@ -250,9 +324,19 @@ bool CalibrationModule::saveCalibrationParameters(const CalibrationParameters& p
 
     fs << "camera_matrix" << params.cameraMatrix;
     fs << "dist_coeffs"   << params.distCoeffs;
+    fs << "image_size"    << params.imageSize;
     fs << "board_size"    << params.boardSize;
     fs << "square_size"   << params.squareSize;
     fs << "timestamp"     << params.timestamp.toStdString();
+    // 合并/区域模式下取流的图像直接使用换算后的内参，不必再按全分辨率换算
+    if (m_streamGeometry.isValid() && !m_streamGeometry.isFullSensor()) {
+        const StreamGeometry& g = m_streamGeometry;
+        fs << "stream_camera_matrix" << cameraMatrixForStream(params, g);
+        fs << "stream_image_size"    << cv::Size(g.width, g.height);
+        fs << "stream_binning"       << g.binning;
+        fs << "stream_decimation"    << g.decimation;
+        fs << "stream_offset"        << cv::Point(g.offsetX, g.offsetY);
+    }
     fs.release();
     QMessageBox::information(this, tr("提示"), tr("参数已保存"));
     return true;
@@ -306,7 +390,11 @@ void CalibrationModule::displayCalibrationParameters(const CalibrationParameters
 {
     std::stringstream ss;
     ss << "重投影误差: " << params.reprojectionError << " 像素\n";
+    ss << "图像尺寸: " << params.imageSize.width << "x" << params.imageSize.height << "\n";
     ss << "内参矩阵:\n" << params.cameraMatrix;
+    if (m_streamGeometry.isValid() && !m_streamGeometry.isFullSensor())
+        ss << "\n当前采集模式 " << m_streamGeometry.describe().toStdString() << " 内参:\n"
+           << cameraMatrixForStream(params, m_streamGeometry);
     ui->logTextEdit->setPlainText(QString::fromStdString(ss.str()));
 
     //填充表格
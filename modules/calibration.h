@@ -25,6 +25,8 @@ struct CalibrationParameters {
     std::vector<cv::Mat> tvecs;
     // 重投影误差
     double reprojectionError;
+    // 标定图像尺寸（全分辨率传感器尺寸，内参以此为准）
+    cv::Size imageSize;
     // 标定板尺寸
     cv::Size boardSize;
     // 棋盘格方块大小(mm)
@@ -35,10 +37,14 @@ struct CalibrationParameters {
     QString deviceInfo;
 };
 
+// 全分辨率内参换算到合并/抽样/区域取流下的内参（畸变系数不变）
+cv::Mat cameraMatrixForStream(const CalibrationParameters& params, const StreamGeometry& geometry);
+
 // 标定结果结构体
 struct CalibrationResult {
     CalibrationParameters params;
     std::vector<double> perViewErrors;
+    std::vector<quint64> viewFrameIds;     // perViewErrors 对应的帧 ID（DatasetFrame::id）
     cv::Mat errorHeatmap;
     bool success = false;
     QString message;
@@ -54,6 +60,8 @@ public:
                      const cv::Size& boardSize, 
                      float squareSize,
                      bool useUndistortion = true);
+    // 保留近似重复帧（默认跳过，与数据列表中标记的重复帧相同）
+    void setKeepDuplicates(bool keep) { m_keepDuplicates = keep; }
 
 public slots:
     void doWork();
@@ -70,6 +78,7 @@ private:
     float m_squareSize;
     int m_distortionModel;
     bool m_useUndistortion;
+    bool m_keepDuplicates = false;
     QMutex m_mutex;
     bool m_abort;
     
@@ -100,6 +109,8 @@ public slots:
     void onCancelCalibration();
     //更新标定设置
     void updateCalibSetting(const AppSettings& settings);
+    // 当前取流几何：合并/区域模式下同时显示和保存换算后的本流内参
+    void setStreamGeometry(const StreamGeometry& geometry);
 
 signals:
     // 状态变化信号
@@ -128,6 +139,8 @@ private:
     // 标定线程
     QThread* m_workerThread;
     CalibrationWorker* m_worker;
+    bool m_keepDuplicates = false;
+    StreamGeometry m_streamGeometry;
     
     // 初始化UI
     void initUI();
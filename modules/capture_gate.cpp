@@ -0,0 +1,262 @@
+#include "capture_gate.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// 明暗对比度低于此值（8 位灰度）时不评估清晰度，视为模糊
+static const int MIN_BOARD_CONTRAST = 16;
+
+// 直方图的分位数
+static int histogramPercentile(const cv::Mat& hist, double fraction)
+{
+    const double total = cv::sum(hist)[0];
+    double accumulated = 0;
+    for (int i = 0; i < hist.rows; ++i) {
+        accumulated += hist.at<float>(i);
+        if (accumulated >= total * fraction) return i;
+    }
+    return hist.rows - 1;
+}
+
+CaptureGate::CaptureGate(QObject* parent)
+    : QObject(parent)
+    , m_abort(0)
+    , m_evaluated(0)
+    , m_noBoard(0)
+    , m_blurred(0)
+    , m_duplicate(0)
+    , m_accepted(0)
+    , m_evalNs(0)
+{
+    qRegisterMetaType<CaptureGate::Candidate>();
+}
+
+CaptureGate::~CaptureGate()
+{
+    stop();
+}
+
+bool CaptureGate::start(std::shared_ptr<FrameRing> ring, const Options& options)
+{
+    if (!ring || m_thread) return false;
+    if (options.boardSize.width < 2 || options.boardSize.height < 2) return false;
+
+    m_consumerId = ring->addConsumer(QStringLiteral("autocapture"), FrameRing::LatestOnly);
+    if (m_consumerId < 0) return false;
+
+    m_ring = std::move(ring);
+    m_options = options;
+    m_abort.storeRelease(0);
+    m_evaluated.storeRelease(0);
+    m_noBoard.storeRelease(0);
+    m_blurred.storeRelease(0);
+    m_duplicate.storeRelease(0);
+    m_accepted.storeRelease(0);
+    m_evalNs.storeRelease(0);
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start(QThread::LowPriority);     // 不与抓图、预览争抢
+    return true;
+}
+
+void CaptureGate::stop()
+{
+    if (!m_thread) return;
+
+    m_abort.storeRelease(1);
+    if (!m_thread->wait(3000))
+        qDebug() << "Auto capture thread termination timed out.";
+    delete m_thread;
+    m_thread = nullptr;
+
+    m_ring->removeConsumer(m_consumerId);
+    m_consumerId = -1;
+    m_ring.reset();
+}
+
+void CaptureGate::clearPoses()
+{
+    QMutexLocker locker(&m_poseMutex);
+    m_poses.clear();
+}
+
+CaptureGate::Stats CaptureGate::stats() const
+{
+    Stats out;
+    out.evaluated = m_evaluated.loadAcquire();
+    out.noBoard   = m_noBoard.loadAcquire();
+    out.blurred   = m_blurred.loadAcquire();
+    out.duplicate = m_duplicate.loadAcquire();
+    out.accepted  = m_accepted.loadAcquire();
+    if (out.evaluated > 0)
+        out.avgEvalMs = m_evalNs.loadAcquire() / 1e6 / out.evaluated;
+    return out;
+}
+
+void CaptureGate::run()
+{
+    while (!m_abort.loadAcquire()) {
+        FrameHandle frame;
+        if (!m_ring->waitPop(m_consumerId, frame, 100))
+            continue;
+
+        const cv::Mat src = frame.toMat();      // 评估期间持有句柄，视图保持有效
+        if (src.empty() || (src.type() != CV_8UC1 && src.type() != CV_16UC1))
+            continue;
+
+        QElapsedTimer timer;
+        timer.start();
+        m_evaluated.fetchAndAddRelaxed(1);
+
+        std::vector<cv::Point2f> corners;
+        Candidate candidate;
+        bool accept = false;
+        if (!detect(src, corners)) {
+            m_noBoard.fetchAndAddRelaxed(1);
+        } else {
+            candidate.score.found = true;
+            candidate.score.sharpness = boardSharpness(src, corners);
+            if (candidate.score.sharpness < m_options.minSharpness) {
+                m_blurred.fetchAndAddRelaxed(1);
+            } else {
+                const Pose pose = poseOf(corners, m_options.boardSize, src.size());
+                candidate.score.novelty = novelty(pose);
+                if (candidate.score.novelty < m_options.minNovelty) {
+                    m_duplicate.fetchAndAddRelaxed(1);
+                } else {
+                    QMutexLocker locker(&m_poseMutex);
+                    m_poses.push_back(pose);
+                    accept = true;
+                }
+            }
+        }
+
+        if (accept) {
+            candidate.image = src.clone();
+            candidate.hostTimestamp = frame.meta().hostTimestamp;
+            candidate.meta = frame.meta();
+        }
+        frame.reset();
+        m_evalNs.fetchAndAddRelaxed(timer.nsecsElapsed());
+
+        if (accept) {
+            m_accepted.fetchAndAddRelaxed(1);
+            emit frameAccepted(candidate);
+        }
+    }
+}
+
+bool CaptureGate::detect(const cv::Mat& image, std::vector<cv::Point2f>& corners)
+{
+    return detectBoard(image, m_options.boardSize, m_options.detectWidth, corners, m_small, m_small8);
+}
+
+// 在缩小图上检测，角点换算回原分辨率；角点顺序统一为从左上开始
+bool CaptureGate::detectBoard(const cv::Mat& image, const cv::Size& boardSize, int detectWidth,
+                              std::vector<cv::Point2f>& corners, cv::Mat& smallBuffer, cv::Mat& small8Buffer)
+{
+    const double scale = image.cols > detectWidth ? double(detectWidth) / image.cols : 1.0;
+    const cv::Mat* small = &image;
+    if (scale < 1.0) {
+        cv::resize(image, smallBuffer, cv::Size(), scale, scale, cv::INTER_AREA);
+        small = &smallBuffer;
+    }
+    if (small->type() == CV_16UC1) {
+        small->convertTo(small8Buffer, CV_8U, 1.0 / 256);
+        small = &small8Buffer;
+    }
+
+    if (!cv::findChessboardCorners(*small, boardSize, corners,
+                                   cv::CALIB_CB_ADAPTIVE_THRESH + cv::CALIB_CB_NORMALIZE_IMAGE
+                                       + cv::CALIB_CB_FAST_CHECK))
+        return false;
+
+    for (cv::Point2f& p : corners) {
+        p.x = float((p.x + 0.5) / scale - 0.5);
+        p.y = float((p.y + 0.5) / scale - 0.5);
+    }
+    normalizeCorners(corners);
+    return true;
+}
+
+void CaptureGate::normalizeCorners(std::vector<cv::Point2f>& corners)
+{
+    if (!corners.empty() && corners.back().x + corners.back().y < corners.front().x + corners.front().y)
+        std::reverse(corners.begin(), corners.end());
+}
+
+// 清晰度：棋盘区域内梯度的 99% 分位 / 明暗对比度（5%~95% 分位差）
+// Sobel 3x3 对理想阶跃边缘的响应为 4 倍对比度，缩放后比值约为 1，模糊越重越小
+double CaptureGate::boardSharpness(const cv::Mat& image, const std::vector<cv::Point2f>& corners)
+{
+    const cv::Rect roi = cv::boundingRect(corners) & cv::Rect(0, 0, image.cols, image.rows);
+    if (roi.width < 8 || roi.height < 8) return 0;
+
+    cv::Mat gray;
+    if (image.type() == CV_16UC1)
+        image(roi).convertTo(gray, CV_8U, 1.0 / 256);
+    else
+        gray = image(roi);
+
+    const int histSize = 256;
+    const float range[] = { 0, 256 };
+    const float* ranges[] = { range };
+    const int channels = 0;
+
+    cv::Mat intensityHist;
+    cv::calcHist(&gray, 1, &channels, cv::Mat(), intensityHist, 1, &histSize, ranges);
+    const int contrast = histogramPercentile(intensityHist, 0.95) - histogramPercentile(intensityHist, 0.05);
+    if (contrast < MIN_BOARD_CONTRAST) return 0;
+
+    cv::Mat dx, dy, gx, gy;
+    cv::Sobel(gray, dx, CV_16S, 1, 0, 3);
+    cv::Sobel(gray, dy, CV_16S, 0, 1, 3);
+    cv::convertScaleAbs(dx, gx, 0.25);
+    cv::convertScaleAbs(dy, gy, 0.25);
+    cv::max(gx, gy, gx);
+
+    cv::Mat gradientHist;
+    cv::calcHist(&gx, 1, &channels, cv::Mat(), gradientHist, 1, &histSize, ranges);
+    return std::min(1.0, double(histogramPercentile(gradientHist, 0.99)) / contrast);
+}
+
+CaptureGate::Pose CaptureGate::poseOf(const std::vector<cv::Point2f>& corners, const cv::Size& boardSize,
+                                      const cv::Size& imageSize)
+{
+    const int w = boardSize.width;
+    const cv::Point2f tl = corners.front();
+    const cv::Point2f tr = corners[size_t(w - 1)];
+    const cv::Point2f bl = corners[corners.size() - size_t(w)];
+    const cv::Point2f br = corners.back();
+
+    const double W = imageSize.width, H = imageSize.height;
+    const std::vector<cv::Point2f> quad = { tl, tr, br, bl };
+    const double area = std::fabs(cv::contourArea(quad));
+    auto length = [](const cv::Point2f& a, const cv::Point2f& b) { return std::max(1e-3, double(cv::norm(a - b))); };
+
+    Pose pose;
+    pose.v[0] = (tl.x + tr.x + bl.x + br.x) / 4.0 / W;
+    pose.v[1] = (tl.y + tr.y + bl.y + br.y) / 4.0 / H;
+    pose.v[2] = std::sqrt(area / (W * H));
+    pose.v[3] = std::log(length(tl, tr) / length(bl, br));     // 绕水平轴倾斜
+    pose.v[4] = std::log(length(tl, bl) / length(tr, br));     // 绕竖直轴倾斜
+    return pose;
+}
+
+double CaptureGate::novelty(const Pose& pose) const
+{
+    QMutexLocker locker(&m_poseMutex);
+    double best = 1.0;
+    for (const Pose& other : m_poses)
+        best = std::min(best, poseDistance(pose, other));
+    return best;
+}
+
+double CaptureGate::poseDistance(const Pose& a, const Pose& b)
+{
+    double d2 = 0;
+    for (int i = 0; i < 5; ++i)
+        d2 += (a.v[i] - b.v[i]) * (a.v[i] - b.v[i]);
+    return std::sqrt(d2);
+}
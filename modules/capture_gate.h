@@ -0,0 +1,110 @@
+#ifndef CAPTURE_GATE_H
+#define CAPTURE_GATE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QMetaType>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "frame_ring.h"
+
+// 自动采集质量门限：在独立线程中按 LatestOnly 从帧队列取帧，逐帧评估
+//   1. 缩小到 detectWidth 后检测棋盘格（整板可见）
+//   2. 原分辨率下棋盘区域的清晰度：梯度峰值 / 明暗对比度，运动模糊和失焦都会拉低
+//   3. 位姿新颖度：外框四角描述的 位置/尺度/倾斜 与已采集帧的最小距离
+// 三项都通过才拷贝整帧并发出 frameAccepted，其余帧不产生任何拷贝
+class CaptureGate : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        cv::Size boardSize = cv::Size(9, 6);    // 内角点数
+        int      detectWidth = 640;             // 检测用缩小宽度
+        double   minSharpness = 0.30;           // 0..1，理想阶跃边缘约为 1
+        double   minNovelty = 0.10;             // 位姿描述空间中的最小距离
+    };
+
+    struct Score {
+        bool   found = false;
+        double sharpness = 0;
+        double novelty = 0;
+    };
+
+    struct Candidate {
+        cv::Mat image;                  // 整帧拷贝，已脱离采集缓存
+        qint64  hostTimestamp = 0;
+        FrameMeta meta;                 // 采集元信息（曝光、增益、像素格式）
+        Score   score;
+    };
+
+    // 位姿描述：中心 (cx, cy)、尺度、上下/左右边长对数比（倾斜）
+    struct Pose {
+        double v[5];
+    };
+
+    struct Stats {
+        quint64 evaluated = 0;
+        quint64 noBoard = 0;
+        quint64 blurred = 0;
+        quint64 duplicate = 0;
+        quint64 accepted = 0;
+        double  avgEvalMs = 0;
+    };
+
+    explicit CaptureGate(QObject* parent = nullptr);
+    ~CaptureGate() override;
+
+    bool start(std::shared_ptr<FrameRing> ring, const Options& options = Options());
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // 清空已采集位姿（标定数据被清空后调用）
+    void clearPoses();
+    Stats stats() const;
+
+    // 评估函数可在任意线程调用：small/small8 为调用方持有的缩小图缓存
+    static bool detectBoard(const cv::Mat& image, const cv::Size& boardSize, int detectWidth,
+                            std::vector<cv::Point2f>& corners, cv::Mat& small, cv::Mat& small8);
+    static double boardSharpness(const cv::Mat& image, const std::vector<cv::Point2f>& corners);
+    // findChessboardCorners 可能从任一端开始排列角点，统一为从左上角开始，位姿描述与检测方向无关
+    static void normalizeCorners(std::vector<cv::Point2f>& corners);
+    // 由外框四角计算位姿描述；poseDistance 为描述空间中的欧氏距离
+    static Pose poseOf(const std::vector<cv::Point2f>& corners, const cv::Size& boardSize, const cv::Size& imageSize);
+    static double poseDistance(const Pose& a, const Pose& b);
+
+signals:
+    // 在评估线程中发出
+    void frameAccepted(const CaptureGate::Candidate& candidate);
+
+private:
+    void run();
+    bool detect(const cv::Mat& image, std::vector<cv::Point2f>& corners);
+    double novelty(const Pose& pose) const;
+
+    std::shared_ptr<FrameRing> m_ring;
+    int        m_consumerId = -1;
+    QThread*   m_thread = nullptr;
+    QAtomicInt m_abort;
+    Options    m_options;
+
+    mutable QMutex    m_poseMutex;
+    std::vector<Pose> m_poses;
+
+    // 以下只在评估线程中写
+    cv::Mat m_small;
+    cv::Mat m_small8;
+    QAtomicInteger<quint64> m_evaluated;
+    QAtomicInteger<quint64> m_noBoard;
+    QAtomicInteger<quint64> m_blurred;
+    QAtomicInteger<quint64> m_duplicate;
+    QAtomicInteger<quint64> m_accepted;
+    QAtomicInteger<qint64>  m_evalNs;
+};
+
+Q_DECLARE_METATYPE(CaptureGate::Candidate)
+
+#endif // CAPTURE_GATE_H
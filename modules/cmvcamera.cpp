@@ -1,8 +1,14 @@
 ﻿#include "cmvcamera.h"
+#include "pixel_convert.h"
+
+// 帧缓存池槽数：环形队列(4)、最新帧、预览和各消费者各持有一两帧仍有余量
+static const int FRAME_POOL_SIZE = 12;
 
 CMvCamera::CMvCamera()
 {
     m_hDevHandle = MV_NULL;
+    m_nBufSizeForSaveImage = 0;
+    m_nPayloadSize = 0;
 }
 
 CMvCamera::~CMvCamera()
@@ -73,6 +79,8 @@ int CMvCamera::Close()
 
     int nRet = MV_CC_DestroyHandle(m_hDevHandle);
     m_hDevHandle = MV_NULL;
+    m_framePool.release();
+    m_nPayloadSize = 0;
 
     return nRet;
 }
@@ -92,9 +100,37 @@ int CMvCamera::RegisterImageCallBack(void(__stdcall* cbOutput)(unsigned char* pD
 // ch:开启抓图 | en:Start Grabbing
 int CMvCamera::StartGrabbing()
 {
+    // 只在开始取流时查询一次 PayloadSize，并据此预分配帧缓存池
+    MVCC_INTVALUE_EX stParam = { 0 };
+    int nRet = MV_CC_GetIntValueEx(m_hDevHandle, "PayloadSize", &stParam);
+    if (MV_OK != nRet)
+    {
+        return nRet;
+    }
+
+    nRet = AllocateFramePool((unsigned int)stParam.nCurValue);
+    if (MV_OK != nRet)
+    {
+        return nRet;
+    }
+
     return MV_CC_StartGrabbing(m_hDevHandle);
 }
 
+// ch:按单帧字节数分配帧缓存池(大小不变时复用) | en:Allocate frame pool for the given payload size
+int CMvCamera::AllocateFramePool(unsigned int nPayloadSize)
+{
+    m_nPayloadSize = nPayloadSize;
+    if (m_framePool.bufferSize() != m_nPayloadSize)
+    {
+        if (!m_framePool.allocate(m_nPayloadSize, FRAME_POOL_SIZE))
+        {
+            return MV_E_RESOURCE;
+        }
+    }
+    return MV_OK;
+}
+
 // ch:停止抓图 | en:Stop Grabbing
 int CMvCamera::StopGrabbing()
 {
@@ -107,6 +143,12 @@ int CMvCamera::GetImageBuffer(MV_FRAME_OUT* pFrame, int nMsec)
     return MV_CC_GetImageBuffer(m_hDevHandle, pFrame, nMsec);
 }
 
+// ch:获取一帧图像到用户缓存(如帧缓存池) | en:Get one frame into user buffer
+int CMvCamera::GetOneFrameTimeout(unsigned char* pData, unsigned int nDataSize, MV_FRAME_OUT_INFO_EX* pFrameInfo, int nMsec)
+{
+    return MV_CC_GetOneFrameTimeout(m_hDevHandle, pData, nDataSize, pFrameInfo, nMsec);
+}
+
 // ch:释放图像缓存 | en:Free image buffer
 int CMvCamera::FreeImageBuffer(MV_FRAME_OUT* pFrame)
 {
@@ -277,6 +319,24 @@ int CMvCamera::GetOptimalPacketSize(unsigned int* pOptimalPacketSize)
     return MV_OK;
 }
 
+// ch:设置丢包重传(只对GigE相机有效) | en:Set resend lost packets(It only works for the GigE camera)
+int CMvCamera::SetResend(unsigned int bEnable, unsigned int nMaxResendPercent, unsigned int nResendTimeout)
+{
+    return MV_GIGE_SetResend(m_hDevHandle, bEnable, nMaxResendPercent, nResendTimeout);
+}
+
+// ch:设置重传最大次数 | en:Set max retry times
+int CMvCamera::SetResendMaxRetryTimes(unsigned int nRetryTimes)
+{
+    return MV_GIGE_SetResendMaxRetryTimes(m_hDevHandle, nRetryTimes);
+}
+
+// ch:设置重传间隔 | en:Set resend interval
+int CMvCamera::SetResendTimeInterval(unsigned int nMillisec)
+{
+    return MV_GIGE_SetResendTimeInterval(m_hDevHandle, nMillisec);
+}
+
 // ch:注册消息异常回调 | en:Register Message Exception CallBack
 int CMvCamera::RegisterExceptionCallBack(void(__stdcall* cbException)(unsigned int nMsgType, void* pUser), void* pUser)
 {
@@ -340,58 +400,37 @@ int CMvCamera::DrawLines(MVCC_LINES_INFO* pLinesInfo)
 //读取相机中的图像
 int CMvCamera::ReadBuffer(cv::Mat& image, bool saveFlag, QByteArray imageName)
 {
-    unsigned nRecvBufSize = 0;
-    MVCC_INTVALUE stParam;
-    memset(&stParam, 0, sizeof(MVCC_INTVALUE));
-    int tempValue = MV_CC_GetIntValue(m_hDevHandle, "PayloadSize", &stParam);
-    if (tempValue != 0)
+    // 从帧缓存池借一个槽，函数返回时句柄析构自动归还
+    FrameHandle buffer = m_framePool.acquire();
+    if (buffer.isNull())
     {
         return -1;
     }
-    nRecvBufSize = stParam.nCurValue;
-
-    // 使用 unique_ptr 自动管理内存，避免手动 free
-    std::unique_ptr<unsigned char[]> pDate(new unsigned char[nRecvBufSize]);
 
     MV_FRAME_OUT_INFO_EX stImageInfo;
-    memset(&stImageInfo, 0, sizeof(MV_FRAME_OUT_INFO));
-    tempValue = MV_CC_GetOneFrameTimeout(m_hDevHandle, pDate.get(), nRecvBufSize, &stImageInfo, 700);
+    memset(&stImageInfo, 0, sizeof(MV_FRAME_OUT_INFO_EX));
+    int tempValue = GetOneFrameTimeout(buffer.data(), m_nPayloadSize, &stImageInfo, 700);
     if (tempValue != 0)
     {
-        return -1; // unique_ptr 会自动释放内存
+        return -1;
     }
 
-    bool isMono;
-    switch (stImageInfo.enPixelType)
+    // 按实际像素格式转换为 8 位灰度（Mono10/12、Packed、各 Bayer 相位）
+    PixelConverter converter;
+    if (!converter.configure(stImageInfo.enPixelType, stImageInfo.nWidth, stImageInfo.nHeight,
+                             PixelConverter::Gray8))
     {
-    case PixelType_Gvsp_Mono8:
-    case PixelType_Gvsp_Mono10:
-    case PixelType_Gvsp_Mono10_Packed:
-    case PixelType_Gvsp_Mono12:
-    case PixelType_Gvsp_Mono12_Packed:
-        isMono = true;
-        break;
-    default:
-        isMono = false;
-        break;
+        return -1;
     }
 
     cv::Mat getImage;
-    if (isMono)
-    {
-        getImage = cv::Mat(stImageInfo.nHeight, stImageInfo.nWidth, CV_8UC1, pDate.get());
-    }
-    else if (stImageInfo.enPixelType == PixelType_Gvsp_BayerGR8 ||
-        stImageInfo.enPixelType == PixelType_Gvsp_BayerRG8 ||
-        stImageInfo.enPixelType == PixelType_Gvsp_BayerGB8 ||
-        stImageInfo.enPixelType == PixelType_Gvsp_BayerBG8)
+    if (converter.isPassthrough())
     {
-        cv::Mat bayer(stImageInfo.nHeight, stImageInfo.nWidth, CV_8UC1, pDate.get());
-        cv::cvtColor(bayer, getImage, cv::COLOR_BayerBG2GRAY);
+        getImage = buffer.toMat(stImageInfo.nHeight, stImageInfo.nWidth, CV_8UC1);
     }
-    else
+    else if (!converter.convert(buffer.data(), getImage))
     {
-        return -1; // unique_ptr 会自动释放内存
+        return -1;
     }
 
     if (saveFlag)
@@ -9,6 +9,7 @@
 #include "MvCameraControl.h"
 #include "opencv2/opencv.hpp"
 #include <QDebug>
+#include "frame_pool.h"
 
 //会跟系统函数定义冲突
 //using namespace cv;
@@ -21,7 +22,7 @@ class CMvCamera
 {
 public:
     CMvCamera();
-    ~CMvCamera();
+    virtual ~CMvCamera();
 
     // ch:获取SDK版本号 | en:Get SDK Version
     static int GetSDKVersion();
@@ -33,28 +34,31 @@ public:
     static bool IsDeviceAccessible(MV_CC_DEVICE_INFO* pstDevInfo, unsigned int nAccessMode);
 
     // ch:打开设备 | en:Open Device
-    int Open(MV_CC_DEVICE_INFO* pstDeviceInfo);
+    virtual int Open(MV_CC_DEVICE_INFO* pstDeviceInfo);
 
     // ch:关闭设备 | en:Close Device
-    int Close();
+    virtual int Close();
 
     // ch:判断相机是否处于连接状态 | en:Is The Device Connected
-    bool IsDeviceConnected();
+    virtual bool IsDeviceConnected();
 
     // ch:注册图像数据回调 | en:Register Image Data CallBack
     int RegisterImageCallBack(void(__stdcall* cbOutput)(unsigned char * pData, MV_FRAME_OUT_INFO_EX* pFrameInfo, void* pUser), void* pUser);
 
     // ch:开启抓图 | en:Start Grabbing
-    int StartGrabbing();
+    virtual int StartGrabbing();
 
     // ch:停止抓图 | en:Stop Grabbing
-    int StopGrabbing();
+    virtual int StopGrabbing();
 
     // ch:主动获取一帧图像数据 | en:Get one frame initiatively
-    int GetImageBuffer(MV_FRAME_OUT* pFrame, int nMsec);
+    virtual int GetImageBuffer(MV_FRAME_OUT* pFrame, int nMsec);
+
+    // ch:获取一帧图像到用户缓存(如帧缓存池) | en:Get one frame into user buffer
+    virtual int GetOneFrameTimeout(unsigned char* pData, unsigned int nDataSize, MV_FRAME_OUT_INFO_EX* pFrameInfo, int nMsec);
 
     // ch:释放图像缓存 | en:Free image buffer
-    int FreeImageBuffer(MV_FRAME_OUT* pFrame);
+    virtual int FreeImageBuffer(MV_FRAME_OUT* pFrame);
 
     // ch:显示一帧图像 | en:Display one frame image
     int DisplayOneFrame(MV_DISPLAY_FRAME_INFO* pDisplayInfo);
@@ -63,37 +67,37 @@ public:
     int SetImageNodeNum(unsigned int nNum);
 
     // ch:获取设备信息 | en:Get device information
-    int GetDeviceInfo(MV_CC_DEVICE_INFO* pstDevInfo);
+    virtual int GetDeviceInfo(MV_CC_DEVICE_INFO* pstDevInfo);
 
     // ch:获取GEV相机的统计信息 | en:Get detect info of GEV camera
-    int GetGevAllMatchInfo(MV_MATCH_INFO_NET_DETECT* pMatchInfoNetDetect);
+    virtual int GetGevAllMatchInfo(MV_MATCH_INFO_NET_DETECT* pMatchInfoNetDetect);
 
     // ch:获取U3V相机的统计信息 | en:Get detect info of U3V camera
-    int GetU3VAllMatchInfo(MV_MATCH_INFO_USB_DETECT* pMatchInfoUSBDetect);
+    virtual int GetU3VAllMatchInfo(MV_MATCH_INFO_USB_DETECT* pMatchInfoUSBDetect);
 
     // ch:获取和设置Int型参数，如 
     // 
     // 和Height，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件
     // en:Get Int type parameters, such as Width and Height, for details please refer to MvCameraNode.xlsx file under SDK installation directory
-    int GetIntValue(IN const char* strKey, OUT MVCC_INTVALUE_EX *pIntValue);
-    int SetIntValue(IN const char* strKey, IN int64_t nValue);
+    virtual int GetIntValue(IN const char* strKey, OUT MVCC_INTVALUE_EX *pIntValue);
+    virtual int SetIntValue(IN const char* strKey, IN int64_t nValue);
 
     // ch:获取和设置Enum型参数，如 PixelFormat，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件
     // en:Get Enum type parameters, such as PixelFormat, for details please refer to MvCameraNode.xlsx file under SDK installation directory
-    int GetEnumValue(IN const char* strKey, OUT MVCC_ENUMVALUE *pEnumValue);
-    int SetEnumValue(IN const char* strKey, IN unsigned int nValue);
-    int SetEnumValueByString(IN const char* strKey, IN const char* sValue);
+    virtual int GetEnumValue(IN const char* strKey, OUT MVCC_ENUMVALUE *pEnumValue);
+    virtual int SetEnumValue(IN const char* strKey, IN unsigned int nValue);
+    virtual int SetEnumValueByString(IN const char* strKey, IN const char* sValue);
     int GetEnumEntrySymbolic(IN const char* strKey, IN MVCC_ENUMENTRY* pstEnumEntry);
 
     // ch:获取和设置Float型参数，如 ExposureTime和Gain，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件
     // en:Get Float type parameters, such as ExposureTime and Gain, for details please refer to MvCameraNode.xlsx file under SDK installation directory
-    int GetFloatValue(IN const char* strKey, OUT MVCC_FLOATVALUE *pFloatValue);
-    int SetFloatValue(IN const char* strKey, IN float fValue);
+    virtual int GetFloatValue(IN const char* strKey, OUT MVCC_FLOATVALUE *pFloatValue);
+    virtual int SetFloatValue(IN const char* strKey, IN float fValue);
 
     // ch:获取和设置Bool型参数，如 ReverseX，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件
     // en:Get Bool type parameters, such as ReverseX, for details please refer to MvCameraNode.xlsx file under SDK installation directory
-    int GetBoolValue(IN const char* strKey, OUT bool *pbValue);
-    int SetBoolValue(IN const char* strKey, IN bool bValue);
+    virtual int GetBoolValue(IN const char* strKey, OUT bool *pbValue);
+    virtual int SetBoolValue(IN const char* strKey, IN bool bValue);
 
     // ch:获取和设置String型参数，如 DeviceUserID，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件UserSetSave
     // en:Get String type parameters, such as DeviceUserID, for details please refer to MvCameraNode.xlsx file under SDK installation directory
@@ -102,10 +106,17 @@ public:
 
     // ch:执行一次Command型命令，如 UserSetSave，详细内容参考SDK安装目录下的 MvCameraNode.xlsx 文件
     // en:Execute Command once, such as UserSetSave, for details please refer to MvCameraNode.xlsx file under SDK installation directory
-    int CommandExecute(IN const char* strKey);
+    virtual int CommandExecute(IN const char* strKey);
 
     // ch:探测网络最佳包大小(只对GigE相机有效) | en:Detection network optimal package size(It only works for the GigE camera)
-    int GetOptimalPacketSize(unsigned int* pOptimalPacketSize);
+    virtual int GetOptimalPacketSize(unsigned int* pOptimalPacketSize);
+
+    // ch:设置丢包重传(只对GigE相机有效) | en:Set resend lost packets(It only works for the GigE camera)
+    virtual int SetResend(unsigned int bEnable, unsigned int nMaxResendPercent, unsigned int nResendTimeout);
+
+    // ch:设置重传最大次数和重传间隔，须在开启重传后调用 | en:Set max retry times and interval, must be called after enabling resend
+    virtual int SetResendMaxRetryTimes(unsigned int nRetryTimes);
+    virtual int SetResendTimeInterval(unsigned int nMillisec);
 
     // ch:注册消息异常回调 | en:Register Message Exception CallBack
     int RegisterExceptionCallBack(void(__stdcall* cbException)(unsigned int nMsgType, void* pUser), void* pUser);
@@ -140,8 +151,20 @@ public:
     //读取buffer
     int ReadBuffer(cv::Mat &image,bool saveFlag,QByteArray imageName);
 
+    // ch:帧缓存池，StartGrabbing 时按 PayloadSize 分配 | en:Frame buffer pool, sized from PayloadSize at StartGrabbing
+    FramePool* GetFramePool() { return &m_framePool; }
+    unsigned int GetPayloadSize() const { return m_nPayloadSize; }
+
     void *m_hDevHandle;
 
+protected:
+    // ch:按单帧字节数分配帧缓存池(大小不变时复用) | en:Allocate frame pool for the given payload size
+    int AllocateFramePool(unsigned int nPayloadSize);
+
+    //帧缓存池及单帧大小
+    FramePool    m_framePool;
+    unsigned int m_nPayloadSize;
+
 private:
 
     //用于保存图像的缓存
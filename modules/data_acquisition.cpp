@@ -2,6 +2,7 @@
 #include "ui_data_acquisition.h"
 #include "../mainwindow.h"
 #include "device_management.h"
+#include "raw_dataset.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDateTime>
@@ -11,11 +12,23 @@
 #include <opencv2/opencv.hpp>
 #include <QBuffer>
 #include <QImageWriter>
+#include <QProgressDialog>
+#include <QScrollBar>
+#include <QTimer>
+
+// 预取可见区前后各若干行
+static const int PREFETCH_MARGIN_ROWS = 8;
 
 DataAcquisitionModule::DataAcquisitionModule(MainWindow* mainWindow, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::DataAcquisitionModule)
     , m_mainWindow(mainWindow)
+    , m_model(new DatasetModel(this))
+    , m_store(DatasetStore::create())
+    , m_loader(new ImageLoader(this))
+    , m_thumbnails(new ThumbnailCache(this))
+    , m_prefetchTimer(new QTimer(this))
+    , m_exporter(new DatasetExporter(this))
 {
     ui->setupUi(this);
     initUI();
@@ -35,8 +48,13 @@ void DataAcquisitionModule::initUI()
     ui->previewLabel->setStyleSheet("background-color:#222;color:white;");
     ui->previewLabel->setText(tr("图像预览"));
 
+    ui->dataListWidget->setModel(m_model);
+    ui->dataListWidget->setUniformItemSizes(true);
     ui->dataListWidget->setAlternatingRowColors(true);
     ui->dataListWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_thumbnails->setWidth(m_store->options().thumbnailWidth);
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(100);
 
 
     ui->deleteImageButton->setEnabled(false);
@@ -50,11 +68,20 @@ void DataAcquisitionModule::initConnections()
     connect(ui->clearAllButton,      &QPushButton::clicked, this, &DataAcquisitionModule::onClearAllClicked);
     connect(ui->loadImagesButton,    &QPushButton::clicked, this, &DataAcquisitionModule::onLoadImagesClicked);
     connect(ui->saveImagesButton,    &QPushButton::clicked, this, &DataAcquisitionModule::onSaveImagesClicked);
-    // 连接 itemClicked 信号到槽函数
-    QObject::connect(ui->dataListWidget, &QListWidget::itemClicked, [this](QListWidgetItem *item) {
-        int index = item->data(Qt::UserRole).toInt();
-        const auto& d = m_calibrationData[index];
-        ui->previewLabel->setPixmap(QPixmap::fromImage(d.qImage));
+    connect(m_loader, &ImageLoader::imageLoaded, this, &DataAcquisitionModule::onImageLoaded, Qt::QueuedConnection);
+    connect(m_loader, &ImageLoader::finished, this, &DataAcquisitionModule::onLoadFinished, Qt::QueuedConnection);
+    connect(m_exporter, &DatasetExporter::progress, this, &DataAcquisitionModule::onExportProgress, Qt::QueuedConnection);
+    connect(m_exporter, &DatasetExporter::finished, this, &DataAcquisitionModule::onExportFinished, Qt::QueuedConnection);
+    connect(m_thumbnails, &ThumbnailCache::thumbnailReady, this, &DataAcquisitionModule::onThumbnailReady, Qt::QueuedConnection);
+    connect(m_model, &DatasetModel::duplicatesChanged, this, &DataAcquisitionModule::onDuplicatesChanged);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &DataAcquisitionModule::prefetchVisible);
+    connect(ui->dataListWidget->verticalScrollBar(), &QScrollBar::valueChanged,
+            m_prefetchTimer, qOverload<>(&QTimer::start));
+    connect(ui->dataListWidget->selectionModel(), &QItemSelectionModel::currentChanged,
+            m_prefetchTimer, qOverload<>(&QTimer::start));
+    connect(ui->dataListWidget, &QListView::clicked, this, [this](const QModelIndex& index) {
+        if (!index.isValid()) return;
+        ui->previewLabel->setPixmap(QPixmap::fromImage(m_model->at(index.row()).qImage()));
     });
 }
 
@@ -62,17 +89,16 @@ void DataAcquisitionModule::initConnections()
 // 删除列表选中
 void DataAcquisitionModule::onDeleteImageClicked()
 {
-    QList<QListWidgetItem*> sel = ui->dataListWidget->selectedItems();
+    const QModelIndexList sel = ui->dataListWidget->selectionModel()->selectedRows();
     if (sel.isEmpty()) { QMessageBox::warning(this, tr("警告"), tr("请先选择要删除的图像")); return; }
     if (QMessageBox::question(this, tr("确认"), tr("确定删除选中的 %1 张图像？").arg(sel.size()))
         != QMessageBox::Yes) return;
 
-    QList<int> idxs;
-    for (auto* it : sel) idxs.append(it->data(Qt::UserRole).toInt());
-    std::sort(idxs.begin(), idxs.end(), std::greater<int>());
-    for (int i : idxs) m_calibrationData.removeAt(i);
-    updateDataList();
-    if (m_calibrationData.isEmpty()) {
+    // 按帧 ID 删除，不依赖行号
+    QList<quint64> ids;
+    for (const QModelIndex& index : sel) ids.append(index.data(DatasetModel::FrameIdRole).toULongLong());
+    m_model->remove(ids);
+    if (m_model->isEmpty()) {
         ui->deleteImageButton->setEnabled(false);
         ui->clearAllButton->setEnabled(false);
         ui->saveImagesButton->setEnabled(false);
@@ -82,11 +108,11 @@ void DataAcquisitionModule::onDeleteImageClicked()
 // 清空列表
 void DataAcquisitionModule::onClearAllClicked()
 {
-    if (m_calibrationData.isEmpty()) return;
-    if (QMessageBox::question(this, tr("确认"), tr("确定清除所有 %1 张图像？").arg(m_calibrationData.size()))
+    if (m_model->isEmpty()) return;
+    if (QMessageBox::question(this, tr("确认"), tr("确定清除所有 %1 张图像？").arg(m_model->size()))
         != QMessageBox::Yes) return;
-    m_calibrationData.clear();
-    updateDataList();
+    m_thumbnails->cancel();
+    m_model->clear();
     ui->deleteImageButton->setEnabled(false);
     ui->clearAllButton->setEnabled(false);
     ui->saveImagesButton->setEnabled(false);
@@ -95,36 +121,144 @@ void DataAcquisitionModule::onClearAllClicked()
 
 void DataAcquisitionModule::onLoadImagesClicked()
 {
+    if (m_loader->isLoading()) return;
     QString dir = QFileDialog::getExistingDirectory(this, tr("选择图像目录"));
     if (dir.isEmpty()) return;
     QDir d(dir);
     QStringList files = d.entryList({"*.jpg","*.jpeg","*.png","*.bmp","*.tif","*.tiff"}, QDir::Files);
-    if (files.isEmpty()) { QMessageBox::information(this, tr("提示"), tr("目录中没有图像")); return; }
-
-    int loaded = 0;
-    for (const QString& f : files) {
-        QImage img(d.filePath(f));
-        if (img.isNull()) continue;
-        CalibrationData data;
-        data.qImage    = img;
-        data.image     = qImageToCvMat(img);
-        data.timestamp = QFileInfo(d.filePath(f)).lastModified().toString("yyyy-MM-dd HH:mm:ss");
-        data.filename   =  QFileInfo(d.filePath(f)).fileName();
-        m_calibrationData.append(data); ++loaded;
+    const QStringList recordings = d.entryList({"*.uwcraw"}, QDir::Files);
+    if (files.isEmpty() && recordings.isEmpty()) { QMessageBox::information(this, tr("提示"), tr("目录中没有图像")); return; }
+
+    m_loadBase = m_model->size();
+    QList<CalibrationData> recorded;
+    // 录制文件：只读索引并映射数据，帧在使用时才从映射区读取
+    for (const QString& f : recordings) {
+        QString error;
+        std::shared_ptr<RawDataset> dataset = RawDataset::open(d.filePath(f), &error);
+        if (!dataset) { emit statusChanged(error); continue; }
+        const QString base = QFileInfo(f).completeBaseName();
+        for (int i = 0; i < dataset->frameCount(); ++i) {
+            CalibrationData data;
+            data.frame = m_store->addRecording(dataset, i);
+            if (!data.frame) continue;
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(dataset->frameTimeMs(i)).toString("yyyy-MM-dd HH:mm:ss.zzz");
+            data.filename  = QString("%1#%2").arg(base).arg(dataset->entry(i).frameNumber);
+            data.exposureTime = dataset->entry(i).exposureTime;
+            data.gain         = dataset->entry(i).gain;
+            data.pixelType    = dataset->entry(i).pixelType;
+            recorded.append(data);
+        }
     }
-    updateDataList();
-    if (!m_calibrationData.isEmpty()) {
-        ui->deleteImageButton->setEnabled(true);
-        ui->clearAllButton->setEnabled(true);
-        ui->saveImagesButton->setEnabled(true);
+    m_loadedBefore = recorded.size();
+    m_model->append(recorded);
+    if (files.isEmpty()) {
+        onLoadFinished(0, 0, 0, false);
+        return;
     }
-    emit statusChanged(tr("已加载 %1 张图像").arg(loaded));
-    emit dataReady(m_calibrationData);
+
+    // 图像文件：线程池并行读取文件头，完成一张加入一张；像素在使用时解码，缩略图在加载完成后于后台生成
+    QStringList paths;
+    for (const QString& f : files) paths << d.filePath(f);
+    setEditable(false);
+    m_loadProgress = new QProgressDialog(tr("正在加载图像..."), tr("取消"), 0, paths.size(), this);
+    m_loadProgress->setAttribute(Qt::WA_DeleteOnClose);
+    m_loadProgress->setMinimumDuration(500);
+    m_loadProgress->setValue(0);
+    connect(m_loadProgress, &QProgressDialog::canceled, m_loader, &ImageLoader::cancel);
+    ImageLoader::Options options;
+    options.keepColor = m_keepColorImages;
+    options.thumbnailWidth = m_store->options().thumbnailWidth;     // 只读文件头失败而完整解码时顺带生成
+    options.headerOnly = true;
+    m_loader->start(paths, options);
+}
+
+void DataAcquisitionModule::updateAcquisitionSetting(const AppSettings& settings)
+{
+    m_keepColorImages = settings.keepColorImages;
+    m_keepDuplicates = settings.keepDuplicateFrames;
+    m_exportFormat = qBound(int(DatasetExporter::Png), settings.exportFormat, int(DatasetExporter::Raw));
+    m_exportCompression = settings.exportCompression;
+    m_model->setBoardSize(cv::Size(settings.defaultBoardWidth, settings.defaultBoardHeight));
+}
+
+void DataAcquisitionModule::setViewErrors(const std::vector<quint64>& frameIds, const std::vector<double>& errors)
+{
+    m_model->setViewErrors(frameIds, errors);
+}
+
+void DataAcquisitionModule::onImageLoaded(const ImageLoader::Result& result)
+{
+    const ImageLoader::Options& options = m_loader->options();
+    CalibrationData data;
+    data.frame     = m_store->addFile(result.path, options.keep16Bit, options.keepColor,
+                                      result.size, result.thumbnail, result.image);
+    data.timestamp = result.timestamp;
+    data.filename  = QFileInfo(result.path).fileName();
+    m_model->append(data);
+    if (m_loadProgress)
+        m_loadProgress->setValue(m_model->size() - m_loadBase - m_loadedBefore);
+}
+
+void DataAcquisitionModule::onLoadFinished(int loaded, int failed, qint64 elapsedMs, bool canceled)
+{
+    Q_UNUSED(loaded);
+    if (m_loadProgress) {
+        disconnect(m_loadProgress, nullptr, m_loader, nullptr);      // 关闭对话框会发出 canceled
+        m_loadProgress->close();
+        m_loadProgress = nullptr;
+    }
+    // 并行完成的顺序不定，按文件名恢复目录顺序（录制帧在前）
+    const int fileBase = m_loadBase + m_loadedBefore;
+    m_model->sortFrom(fileBase, [](const CalibrationData& a, const CalibrationData& b) {
+        return a.filename.compare(b.filename, Qt::CaseInsensitive) < 0;
+    });
+    setEditable(true);
+    prefetchVisible();
+    // 缩略图按列表顺序生成，已在磁盘缓存中的直接读取
+    QList<DatasetFramePtr> frames;
+    for (int i = m_loadBase; i < m_model->size(); ++i)
+        frames << m_model->at(i).frame;
+    m_thumbnails->request(frames);
+
+    const int total = m_model->size() - m_loadBase;
+    if (canceled)
+        emit statusChanged(tr("已取消加载，已加载 %1 张图像").arg(total));
+    else if (failed > 0)
+        emit statusChanged(tr("已加载 %1 张图像，%2 张无法解码 (%3 ms)").arg(total).arg(failed).arg(elapsedMs));
+    else
+        emit statusChanged(tr("已加载 %1 张图像 (%2 ms)").arg(total).arg(elapsedMs));
+    emit dataReady(m_model->frames());
+}
+
+// 缩略图已存入帧，只需通知视图重绘该行
+void DataAcquisitionModule::onThumbnailReady(quint64 frameId, const QImage& thumbnail)
+{
+    Q_UNUSED(thumbnail);
+    m_model->thumbnailChanged(frameId);
+}
+
+void DataAcquisitionModule::onDuplicatesChanged(int count)
+{
+    if (count <= 0) return;
+    emit statusChanged(m_keepDuplicates
+                           ? tr("检测到 %1 张近似重复图像（灰色显示），已设置为全部参与标定").arg(count)
+                           : tr("检测到 %1 张近似重复图像（灰色显示），标定时将跳过").arg(count));
+}
+
+// 加载期间禁止增删，避免列表序号与数据集错位
+void DataAcquisitionModule::setEditable(bool editable)
+{
+    const bool hasData = !m_model->isEmpty();
+    ui->loadImagesButton->setEnabled(editable);
+    ui->deleteImageButton->setEnabled(editable && hasData);
+    ui->clearAllButton->setEnabled(editable && hasData);
+    ui->saveImagesButton->setEnabled(editable && hasData);
 }
 
 void DataAcquisitionModule::onSaveImagesClicked()
 {
-    if (m_calibrationData.isEmpty()) {
+    if (m_exporter->isRunning()) return;
+    if (m_model->isEmpty()) {
         QMessageBox::warning(this, tr("警告"), tr("没有图像可保存")); return;
     }
     QString dir = QFileDialog::getExistingDirectory(this, tr("选择保存目录"));
@@ -135,20 +269,60 @@ void DataAcquisitionModule::onSaveImagesClicked()
         QMessageBox::warning(this, tr("警告"), tr("无法创建保存目录")); return;
     }
 
-    QFile csv(saveDir + "/metadata.csv");
-    if (csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&csv);
-        out << "文件名,时间戳,备注\n";
-        for (int i = 0; i < m_calibrationData.size(); ++i) {
-            const auto& d = m_calibrationData[i];
-            QString fn = QString("%1_%2.jpg").arg(ts).arg(i + 1, 4, 10, QLatin1Char('0'));
-            d.qImage.save(saveDir + "/" + fn);
-            out << QString("\"%1\",\"%2\",%3,%4,\"%5\"\n")
-                       .arg(fn).arg(d.timestamp);
-        }
+    // 无损格式后台并行编码写盘，重新标定与原始数据一致
+    DatasetExporter::Options options;
+    options.format      = DatasetExporter::Format(m_exportFormat);
+    options.compression = m_exportCompression;
+    options.prefix      = ts;
+    setEditable(false);
+    m_exportDir = saveDir;
+    m_exportProgress = new QProgressDialog(tr("正在导出图像..."), tr("取消"), 0, m_model->size(), this);
+    m_exportProgress->setAttribute(Qt::WA_DeleteOnClose);
+    m_exportProgress->setMinimumDuration(500);
+    m_exportProgress->setValue(0);
+    connect(m_exportProgress, &QProgressDialog::canceled, m_exporter, &DatasetExporter::cancel);
+    if (!m_exporter->start(m_model->frames(), saveDir, options)) {
+        onExportFinished(0, 0, 0, 0, false, tr("导出启动失败"));
+        return;
+    }
+    emit statusChanged(tr("正在导出 %1 张图像到 %2").arg(m_model->size()).arg(saveDir));
+}
+
+void DataAcquisitionModule::onExportProgress(int done, int total, qint64 bytes)
+{
+    Q_UNUSED(total);
+    if (!m_exportProgress) return;
+    m_exportProgress->setValue(done);
+    m_exportProgress->setLabelText(tr("正在导出图像... %1 MB").arg(bytes >> 20));
+}
+
+void DataAcquisitionModule::onExportFinished(int written, int failed, qint64 bytes, qint64 elapsedMs, bool canceled,
+                                             const QString& error)
+{
+    if (m_exportProgress) {
+        disconnect(m_exportProgress, nullptr, m_exporter, nullptr);    // 关闭对话框会发出 canceled
+        m_exportProgress->close();
+        m_exportProgress = nullptr;
+    }
+    setEditable(true);
+
+    const double mbps = elapsedMs > 0 ? (bytes / 1048576.0) / (elapsedMs / 1000.0) : 0;
+    QString message;
+    if (canceled)
+        message = tr("已取消导出，已保存 %1 张图像到 %2").arg(written).arg(m_exportDir);
+    else
+        message = tr("已保存 %1 张图像到 %2").arg(written).arg(m_exportDir);
+    message += tr("（%1 MB，%2 MB/s）").arg(bytes >> 20).arg(mbps, 0, 'f', 1);
+    if (failed > 0) {
+        message += tr("，%1 张失败").arg(failed);
+        if (m_exportFormat == DatasetExporter::Raw)
+            message += tr("（原始帧容器只支持灰度图像）");
     }
-    emit statusChanged(tr("已保存 %1 张图像到 %2").arg(m_calibrationData.size()).arg(saveDir));
-    // emit dataReady(m_calibrationData);
+    if (!error.isEmpty())
+        message += tr("；%1").arg(error);
+    emit statusChanged(message);
+    if (!error.isEmpty())
+        QMessageBox::warning(this, tr("导出"), message);
 }
 
 
@@ -178,41 +352,25 @@ void DataAcquisitionModule::onSaveImagesClicked()
 
 /*-------------------------------- 工具函数 --------------------------------*/
 
-QImage DataAcquisitionModule::cvMatToQImage(const cv::Mat& mat)
-{
-    if (mat.type() == CV_8UC1)
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_Grayscale8).copy();
-    if (mat.type() == CV_8UC3) {
-        cv::Mat rgb; cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        return QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
-    }
-    return QImage();
-}
-
-cv::Mat DataAcquisitionModule::qImageToCvMat(const QImage& img)
+// 读取可见区及前后若干行的全分辨率像素，点击预览时多数已在缓存中
+void DataAcquisitionModule::prefetchVisible()
 {
-    QImage i = (img.format() != QImage::Format_RGB888) ?
-                   img.convertToFormat(QImage::Format_RGB888) : img;
-    cv::Mat mat(i.height(), i.width(), CV_8UC3,
-                const_cast<uchar*>(i.bits()), i.bytesPerLine());
-    cv::Mat ret; cv::cvtColor(mat, ret, cv::COLOR_RGB2BGR);
-    return ret.clone();
-}
+    QListView* list = ui->dataListWidget;
+    if (m_model->isEmpty()) return;
+    const QRect area = list->viewport()->rect();
+    int first = list->indexAt(area.topLeft()).row();
+    int last  = list->indexAt(area.bottomLeft()).row();
+    if (first < 0) first = 0;
+    if (last < 0) last = m_model->size() - 1;
+    first = qMax(0, first - PREFETCH_MARGIN_ROWS);
+    last  = qMin(m_model->size() - 1, last + PREFETCH_MARGIN_ROWS);
 
-
-//更新图像显示列表
-void DataAcquisitionModule::updateDataList()
-{
-    ui->dataListWidget->clear();
-    for (int i = 0; i < m_calibrationData.size(); ++i) {
-        const auto& d = m_calibrationData[i];
-        auto* item = new QListWidgetItem(tr("%1 : %2 \t %3").arg(i + 1).arg(d.filename).arg(d.timestamp));
-        item->setData(Qt::UserRole, i);
-        // item->setIcon(QIcon(QPixmap::fromImage(d.qImage)
-        //                         .scaled(64, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation)));
-        ui->dataListWidget->addItem(item);
-    }
+    QList<DatasetFramePtr> frames;
+    // 当前行最先读取
+    const int current = list->currentIndex().row();
+    if (current >= 0)
+        frames << m_model->at(current).frame;
+    for (int row = first; row <= last; ++row)
+        frames << m_model->at(row).frame;
+    m_store->prefetch(frames);
 }
-
-
-
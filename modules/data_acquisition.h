@@ -6,6 +6,15 @@
 #include <opencv2/opencv.hpp>
 #include <QImage>
 #include "device_management.h"
+#include "image_loader.h"
+#include "dataset_store.h"
+#include "thumbnail_cache.h"
+#include "dataset_model.h"
+#include "dataset_exporter.h"
+#include <memory>
+
+class QProgressDialog;
+class QTimer;
 
 namespace Ui { class DataAcquisitionModule; }
 
@@ -21,7 +30,12 @@ public:
     explicit DataAcquisitionModule(MainWindow* mainWindow, QWidget *parent = nullptr);
     ~DataAcquisitionModule() override;
 
-    QList<CalibrationData> getCalibrationData() const { return m_calibrationData; }
+    QList<CalibrationData> getCalibrationData() const { return m_model->frames(); }
+
+public slots:
+    void updateAcquisitionSetting(const AppSettings& settings);     //是否保留彩色原图、标定板规格（列表状态检测用）、是否保留重复图像
+    // 标定完成后回填每帧的重投影误差
+    void setViewErrors(const std::vector<quint64>& frameIds, const std::vector<double>& errors);
 
 signals:
     void statusChanged(const QString& message);
@@ -33,6 +47,12 @@ private slots:
     void onClearAllClicked();
     void onLoadImagesClicked();
     void onSaveImagesClicked();
+    void onImageLoaded(const ImageLoader::Result& result);
+    void onLoadFinished(int loaded, int failed, qint64 elapsedMs, bool canceled);
+    void onThumbnailReady(quint64 frameId, const QImage& thumbnail);
+    void onExportProgress(int done, int total, qint64 bytes);
+    void onExportFinished(int written, int failed, qint64 bytes, qint64 elapsedMs, bool canceled, const QString& error);
+    void onDuplicatesChanged(int count);
 
     // void onAcquisitionModeChanged();
     // void onAdjustParametersClicked();
@@ -40,15 +60,28 @@ private slots:
 private:
     void initUI();
     void initConnections();
-    void updateDataList();
-    QImage  cvMatToQImage(const cv::Mat& mat);
-    cv::Mat qImageToCvMat(const QImage& image);
+    void setEditable(bool editable);
+    void prefetchVisible();
     bool saveCalibrationData(const QString& dir);
     bool loadCalibrationData(const QString& dir);
 
     Ui::DataAcquisitionModule* ui;
     MainWindow*  m_mainWindow;
-    QList<CalibrationData> m_calibrationData;
+    DatasetModel*    m_model;                   // 数据集，列表视图只绘制可见行
+    std::shared_ptr<DatasetStore> m_store;     // 全分辨率像素缓存，列表只持有帧引用
+    ImageLoader*     m_loader;
+    ThumbnailCache*  m_thumbnails;
+    QTimer*          m_prefetchTimer;           // 滚动停顿后再预取
+    QProgressDialog* m_loadProgress = nullptr;
+    int              m_loadBase = 0;            // 本次加载的第一张在数据集中的位置
+    int              m_loadedBefore = 0;        // 本次加载前已加入的录制帧数
+    bool             m_keepColorImages = false;
+    bool             m_keepDuplicates = false;        // 只影响提示，跳过由标定模块执行
+    DatasetExporter* m_exporter;
+    QProgressDialog* m_exportProgress = nullptr;
+    QString          m_exportDir;
+    int              m_exportFormat = DatasetExporter::Png;
+    int              m_exportCompression = 3;
 
 };
 
@@ -0,0 +1,283 @@
+#include "dataset_exporter.h"
+#include "raw_container.h"
+#include "stream_recorder.h"
+#include <QDir>
+#include <QDateTime>
+#include <QTextStream>
+#include <cstring>
+
+// 时间戳字符串（采集/加载时写入）转为 ms；无法解析时返回 -1
+static qint64 timestampMs(const QString& text)
+{
+    QDateTime t = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss.zzz");
+    if (!t.isValid()) t = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss");
+    return t.isValid() ? t.toMSecsSinceEpoch() : -1;
+}
+
+static QString csvField(const QString& text)
+{
+    QString quoted = text;
+    quoted.replace('"', "\"\"");
+    return '"' + quoted + '"';
+}
+
+DatasetExporter::DatasetExporter(QObject* parent)
+    : QObject(parent)
+    , m_running(0)
+    , m_abort(0)
+{}
+
+DatasetExporter::~DatasetExporter()
+{
+    m_abort.storeRelease(1);
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+QString DatasetExporter::suffix(Format format)
+{
+    switch (format) {
+    case Tiff: return QStringLiteral("tif");
+    case Raw:  return QStringLiteral("uwcraw");
+    default:   return QStringLiteral("png");
+    }
+}
+
+bool DatasetExporter::start(const QList<CalibrationData>& frames, const QString& dir, const Options& options)
+{
+    if (isRunning() || frames.isEmpty()) return false;
+    if (m_thread) {             // 上一次导出的线程已在发出 finished 后结束
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    m_frames  = frames;
+    m_dir     = dir;
+    m_options = options;
+    m_rows.assign(size_t(frames.size()), Row());
+    m_done.store(0);
+    m_written.store(0);
+    m_failed.store(0);
+    m_bytes.store(0);
+    m_error.clear();
+    m_abort.storeRelease(0);
+
+    // 原始帧容器按顺序追加，只用一个线程；图像文件按核数并行编码
+    const int encoders = options.encoders > 0 ? options.encoders : QThread::idealThreadCount();
+    m_pool.setMaxThreadCount(options.format == Raw ? 1 : qMax(1, encoders));
+    const int depth = options.queueDepth > 0 ? options.queueDepth : 2 * m_pool.maxThreadCount();
+    m_slots.tryAcquire(m_slots.available());
+    m_slots.release(depth);
+
+    m_running.storeRelease(1);
+    m_clock.start();
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    return true;
+}
+
+// 不等待：正在编码的帧写完后由导出线程发出 finished
+void DatasetExporter::cancel()
+{
+    if (!isRunning()) return;
+    m_abort.storeRelease(1);
+    m_pool.clear();
+}
+
+void DatasetExporter::run()
+{
+    const int total = m_frames.size();
+    bool ok = true;
+    if (m_options.format == Raw) {
+        const QString name = (m_options.prefix.isEmpty() ? QStringLiteral("dataset") : m_options.prefix) + ".uwcraw";
+        ok = openContainer(QDir(m_dir).filePath(name));
+        if (!ok) {
+            m_failed.store(total);
+            setError(tr("无法创建原始帧容器 %1").arg(name));
+        }
+    }
+
+    for (int i = 0; ok && i < total; ++i) {
+        // 队列满时在这里等待，编码和写盘跟不上时不再读入更多帧
+        bool acquired = false;
+        while (!m_abort.loadAcquire() && !(acquired = m_slots.tryAcquire(1, 100))) {}
+        if (!acquired) break;
+        m_pool.start([this, i]() {
+            exportOne(i);
+            m_slots.release();
+        });
+    }
+    m_pool.waitForDone();
+
+    if (m_options.format == Raw) {
+        m_rawData.close();
+        m_rawIndex.close();
+    }
+    if (m_written.load() > 0 && !writeMetadata())
+        setError(tr("metadata.csv 写入失败"));
+
+    m_frames.clear();           // 不再持有数据集帧
+    const bool canceled = m_abort.loadAcquire() != 0;
+    m_running.storeRelease(0);
+    emit finished(m_written.load(), m_failed.load(), m_bytes.load(), m_clock.elapsed(), canceled, m_error);
+}
+
+void DatasetExporter::setError(const QString& error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    if (m_error.isEmpty()) m_error = error;
+}
+
+void DatasetExporter::exportOne(int index)
+{
+    if (m_abort.loadAcquire()) return;
+
+    const CalibrationData& data = m_frames.at(index);
+    Row& row = m_rows[size_t(index)];
+    const cv::Mat image = data.image();         // 经数据集缓存读取，写完即释放
+    qint64 bytes = 0;
+    bool ok = false;
+    if (!image.empty()) {
+        row.size     = image.size();
+        row.depth    = image.depth() == CV_16U ? 16 : 8;
+        row.channels = image.channels();
+        if (m_options.format == Raw) {
+            row.file = QString("%1#%2").arg(m_rawData.fileName().section('/', -1)).arg(index + 1);
+            ok = appendToContainer(index, image, bytes);
+        } else {
+            row.file = QString("%1_%2.%3").arg(m_options.prefix).arg(index + 1, 5, 10, QLatin1Char('0'))
+                           .arg(suffix(m_options.format));
+            ok = writeImage(image, QDir(m_dir).filePath(row.file), bytes);
+        }
+    }
+    row.written = ok;
+    if (ok) m_written.fetch_add(1);
+    else    m_failed.fetch_add(1);
+    const qint64 totalBytes = m_bytes.fetch_add(bytes) + bytes;
+    emit progress(m_done.fetch_add(1) + 1, m_frames.size(), totalBytes);
+}
+
+// 经 imencode 编码后由 QFile 写出：路径含中文时 cv::imwrite 在 Windows 上无法打开
+bool DatasetExporter::writeImage(const cv::Mat& image, const QString& path, qint64& bytes)
+{
+    std::vector<int> params;
+    const char* ext = ".png";
+    if (m_options.format == Tiff) {
+        ext = ".tif";
+        params = { cv::IMWRITE_TIFF_COMPRESSION, m_options.compression > 0 ? 5 : 1 };    // 5 = LZW, 1 = 不压缩
+    } else {
+        params = { cv::IMWRITE_PNG_COMPRESSION, qBound(0, m_options.compression, 9) };
+    }
+
+    std::vector<uchar> encoded;
+    try {
+        if (!cv::imencode(ext, image, encoded, params)) return false;
+    } catch (const cv::Exception& e) {
+        setError(tr("编码失败：%1").arg(QString::fromLocal8Bit(e.what())));
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    bytes = file.write(reinterpret_cast<const char*>(encoded.data()), qint64(encoded.size()));
+    return bytes == qint64(encoded.size());
+}
+
+bool DatasetExporter::openContainer(const QString& path)
+{
+    m_rawData.setFileName(path);
+    m_rawIndex.setFileName(StreamRecorder::indexPathFor(path));
+    if (!m_rawData.open(QIODevice::WriteOnly) || !m_rawIndex.open(QIODevice::WriteOnly)) {
+        m_rawData.close();
+        return false;
+    }
+
+    // 首帧时间作为容器创建时间，各帧的主机时间相对它，重新加载后时间戳不变
+    const qint64 firstMs = timestampMs(m_frames.first().timestamp);
+    const qint64 createdMs = firstMs >= 0 ? firstMs : QDateTime::currentMSecsSinceEpoch();
+    m_rawStartUs = createdMs * 1000;
+
+    std::vector<char> page(RawContainer::DataHeaderSize, 0);
+    RawContainer::DataHeader* header = reinterpret_cast<RawContainer::DataHeader*>(page.data());
+    memcpy(header->magic, RawContainer::DataMagic, sizeof(header->magic));
+    header->version   = RawContainer::Version;
+    header->alignment = RawContainer::Alignment;
+    header->chunkSize = RawContainer::Alignment;
+    header->createdMs = createdMs;
+    const QByteArray device = tr("数据集导出").toUtf8().left(sizeof(header->device) - 1);
+    memcpy(header->device, device.constData(), size_t(device.size()));
+
+    RawContainer::IndexHeader indexHeader{};
+    memcpy(indexHeader.magic, RawContainer::IndexMagic, sizeof(indexHeader.magic));
+    indexHeader.version   = RawContainer::Version;
+    indexHeader.entrySize = sizeof(RawContainer::IndexEntry);
+
+    m_rawOffset = RawContainer::DataHeaderSize;
+    return m_rawData.write(page.data(), qint64(page.size())) == qint64(page.size())
+           && m_rawIndex.write(reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader)) == qint64(sizeof(indexHeader));
+}
+
+// 容器格式与录制相同：帧数据按 4 KB 对齐，数据写完后才追加索引记录
+bool DatasetExporter::appendToContainer(int index, const cv::Mat& image, qint64& bytes)
+{
+    if (image.channels() != 1) return false;        // 容器读取端只解码灰度
+    const cv::Mat packed = image.isContinuous() ? image : image.clone();
+    const quint64 size = quint64(packed.total() * packed.elemSize());
+    const quint64 aligned = RawContainer::alignUp(size);
+
+    if (!m_rawData.seek(qint64(m_rawOffset))
+        || m_rawData.write(reinterpret_cast<const char*>(packed.data), qint64(size)) != qint64(size))
+        return false;
+    if (aligned > size) {
+        const std::vector<char> padding(size_t(aligned - size), 0);
+        if (m_rawData.write(padding.data(), qint64(padding.size())) != qint64(padding.size())) return false;
+    }
+
+    const qint64 ms = timestampMs(m_frames.at(index).timestamp);
+    RawContainer::IndexEntry entry{};
+    entry.offset        = m_rawOffset;
+    entry.size          = quint32(size);
+    entry.frameNumber   = quint32(index + 1);
+    entry.sequence      = quint64(index);
+    entry.hostTimestamp = ms >= 0 ? ms * 1000 - m_rawStartUs : 0;
+    entry.pixelType     = packed.depth() == CV_16U ? PixelType_Gvsp_Mono16 : PixelType_Gvsp_Mono8;
+    entry.width         = quint32(packed.cols);
+    entry.height        = quint32(packed.rows);
+    entry.exposureTime  = m_frames.at(index).exposureTime;
+    entry.gain          = m_frames.at(index).gain;
+    if (m_rawIndex.write(reinterpret_cast<const char*>(&entry), sizeof(entry)) != qint64(sizeof(entry)))
+        return false;
+
+    m_rawOffset += aligned;
+    bytes = qint64(aligned);
+    return true;
+}
+
+bool DatasetExporter::writeMetadata() const
+{
+    QFile csv(QDir(m_dir).filePath("metadata.csv"));
+    if (!csv.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream out(&csv);
+    out << "文件名,来源,时间戳,宽度,高度,位深,通道数,曝光(us),增益(dB),像素格式,合并,抽样,偏移X,偏移Y,传感器宽度,传感器高度\n";
+    for (int i = 0; i < m_frames.size(); ++i) {
+        const Row& row = m_rows[size_t(i)];
+        if (!row.written) continue;
+        const CalibrationData& d = m_frames.at(i);
+        // 没有取流几何（从文件加载）的按全分辨率记录
+        const StreamGeometry& g = d.geometry;
+        const bool hasGeometry = g.isValid();
+        out << csvField(row.file) << ',' << csvField(d.filename) << ',' << csvField(d.timestamp) << ','
+            << row.size.width << ',' << row.size.height << ',' << row.depth << ',' << row.channels << ','
+            << d.exposureTime << ',' << d.gain << ','
+            << (d.pixelType ? QString("0x%1").arg(d.pixelType, 8, 16, QLatin1Char('0')) : QString()) << ','
+            << (hasGeometry ? g.binning : 1) << ',' << (hasGeometry ? g.decimation : 1) << ','
+            << (hasGeometry ? g.offsetX : 0) << ',' << (hasGeometry ? g.offsetY : 0) << ','
+            << (hasGeometry ? g.sensorWidth : row.size.width) << ','
+            << (hasGeometry ? g.sensorHeight : row.size.height) << '\n';
+    }
+    // 写入缓冲中的内容要先刷到文件，才能得到写盘错误
+    out.flush();
+    return out.status() == QTextStream::Ok && csv.error() == QFileDevice::NoError;
+}
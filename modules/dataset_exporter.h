@@ -0,0 +1,94 @@
+#ifndef DATASET_EXPORTER_H
+#define DATASET_EXPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QList>
+#include <QStringList>
+#include <atomic>
+#include "device_management.h"
+
+// 数据集导出：独立线程按顺序投递任务，有界队列（queueDepth 个槽）限制同时在途的帧，
+// 线程池中并行读取像素、无损编码并写盘，编码与写盘重叠，写入速度达到磁盘上限时队列自然阻塞
+//   PNG / TIFF：保持原位深（8/16 位灰度或 BGR），每帧一个文件
+//   原始帧容器：按录制格式写入 *.uwcraw + 索引，可直接作为录制文件重新加载（只支持灰度）
+// 完成后写 metadata.csv：每帧的文件名、来源、时间戳、尺寸、位深、曝光、增益、像素格式和采集时的取流几何
+// 编码异常、容器或 metadata.csv 无法写入时，finished 的 error 为第一个错误的说明
+class DatasetExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format { Png = 0, Tiff, Raw };
+
+    struct Options {
+        Format format = Png;
+        int    compression = 3;         // PNG 0-9；TIFF 0 不压缩、大于 0 为 LZW；原始帧容器忽略
+        int    encoders = 0;            // 0 = CPU 核数
+        int    queueDepth = 0;          // 0 = 编码线程数的两倍
+        QString prefix;                 // 文件名前缀
+    };
+
+    explicit DatasetExporter(QObject* parent = nullptr);
+    ~DatasetExporter() override;
+
+    bool start(const QList<CalibrationData>& frames, const QString& dir, const Options& options = Options());
+    void cancel();
+    bool isRunning() const { return m_running.loadAcquire() != 0; }
+
+    static QString suffix(Format format);
+
+signals:
+    // 在导出线程中发出
+    void progress(int done, int total, qint64 bytes);
+    void finished(int written, int failed, qint64 bytes, qint64 elapsedMs, bool canceled, const QString& error);
+
+private:
+    struct Row {
+        QString file;
+        int     depth = 0;
+        int     channels = 0;
+        cv::Size size;
+        bool    written = false;
+    };
+
+    void run();
+    void exportOne(int index);
+    bool writeImage(const cv::Mat& image, const QString& path, qint64& bytes);
+    bool openContainer(const QString& path);
+    bool appendToContainer(int index, const cv::Mat& image, qint64& bytes);
+    bool writeMetadata() const;
+    void setError(const QString& error);
+
+    QThread*    m_thread = nullptr;
+    QThreadPool m_pool;
+    QSemaphore  m_slots;
+    QAtomicInt  m_running;
+    QAtomicInt  m_abort;
+    QElapsedTimer m_clock;
+
+    QList<CalibrationData> m_frames;
+    QString     m_dir;
+    Options     m_options;
+    std::vector<Row> m_rows;            // 每帧一项，各任务只写自己的一项
+
+    QFile       m_rawData;              // 原始帧容器（只在单个编码线程中写）
+    QFile       m_rawIndex;
+    quint64     m_rawOffset = 0;
+    qint64      m_rawStartUs = 0;
+
+    std::atomic<int>    m_done{0};
+    std::atomic<int>    m_written{0};
+    std::atomic<int>    m_failed{0};
+    std::atomic<qint64> m_bytes{0};
+    QMutex      m_errorMutex;
+    QString     m_error;                // 只保留第一个错误
+};
+
+#endif // DATASET_EXPORTER_H
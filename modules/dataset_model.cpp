@@ -0,0 +1,351 @@
+#include "dataset_model.h"
+#include "duplicate_filter.h"
+#include <QThread>
+#include <QColor>
+#include <QSet>
+#include <algorithm>
+#include <utility>
+
+// 检测用缩小宽度（同自动采集）
+static const int DETECT_WIDTH = 640;
+// 快速滚动时排队的检测超过此数则丢弃，只保留之后显示的行
+static const int MAX_PENDING_DETECTIONS = 256;
+// 删除的行分散成这么多段以上时整体重建，不逐段通知
+static const int MAX_REMOVE_RANGES = 64;
+// 重复判定的合并间隔 (ms)
+static const int DUPLICATE_UPDATE_MS = 300;
+
+DatasetModel::DatasetModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    m_duplicateTimer.setSingleShot(true);
+    m_duplicateTimer.setInterval(DUPLICATE_UPDATE_MS);
+    connect(&m_duplicateTimer, &QTimer::timeout, this, &DatasetModel::updateDuplicates);
+}
+
+DatasetModel::~DatasetModel()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int DatasetModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_frames.size();
+}
+
+QVariant DatasetModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_frames.size()) return QVariant();
+    const int row = index.row();
+    const CalibrationData& d = m_frames[row];
+    const quint64 id = frameId(row);
+    const Status status = m_status.value(id);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        requestStatus(row);             // 只有显示过的行才检测
+        return tr("%1 : %2 \t %3").arg(row + 1).arg(d.filename).arg(d.timestamp) + statusText(status);
+    case Qt::DecorationRole: {
+        const QImage thumbnail = d.thumbnail();
+        return thumbnail.isNull() ? QVariant() : QVariant(thumbnail);
+    }
+    case Qt::ToolTipRole: {
+        const cv::Size size = d.imageSize();
+        QString tip = QString("%1\n%2x%3").arg(d.filename).arg(size.width).arg(size.height);
+        if (d.geometry.isValid() && !d.geometry.isFullSensor())
+            tip += "  " + d.geometry.describe();
+        return tip + statusText(status);
+    }
+    case Qt::ForegroundRole:
+        if (status.state == Status::Done && !status.detected) return QColor(200, 60, 60);
+        if (status.duplicateOf) return QColor(150, 150, 150);
+        return QVariant();
+    case FrameIdRole:
+        return id;
+    case DetectedRole:
+        return status.state == Status::Done ? QVariant(status.detected) : QVariant();
+    case SharpnessRole:
+        return status.state == Status::Done && status.detected ? QVariant(status.sharpness) : QVariant();
+    case ErrorRole:
+        return status.error >= 0 ? QVariant(status.error) : QVariant();
+    case DuplicateRole:
+        return status.duplicateOf ? QVariant(status.duplicateOf) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+int DatasetModel::rowOf(quint64 frameId) const
+{
+    if (m_rowsDirty) {
+        m_rows.clear();
+        m_rows.reserve(m_frames.size());
+        for (int row = 0; row < m_frames.size(); ++row)
+            m_rows.insert(this->frameId(row), row);
+        m_rowsDirty = false;
+    }
+    return m_rows.value(frameId, -1);
+}
+
+quint64 DatasetModel::frameId(int row) const
+{
+    const DatasetFramePtr& frame = m_frames[row].frame;
+    return frame ? frame->id() : 0;
+}
+
+void DatasetModel::append(const CalibrationData& data)
+{
+    append(QList<CalibrationData>{ data });
+}
+
+void DatasetModel::append(const QList<CalibrationData>& data)
+{
+    if (data.isEmpty()) return;
+    const int first = m_frames.size();
+    beginInsertRows(QModelIndex(), first, first + data.size() - 1);
+    m_frames.append(data);
+    if (!m_rowsDirty) {
+        for (int row = first; row < m_frames.size(); ++row)
+            m_rows.insert(frameId(row), row);
+    }
+    endInsertRows();
+    scheduleDuplicates();           // 相机采集的帧和已有缩略图的文件加入时已有哈希
+}
+
+void DatasetModel::remove(const QList<quint64>& frameIds)
+{
+    std::vector<int> rows;
+    for (quint64 id : frameIds) {
+        const int row = rowOf(id);
+        if (row >= 0) rows.push_back(row);
+    }
+    if (rows.empty()) return;
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    // 连续的行合并为一段，从后往前删除，前面的行号不受影响
+    std::vector<std::pair<int, int>> ranges;
+    for (int row : rows) {
+        if (!ranges.empty() && ranges.back().second + 1 == row)
+            ranges.back().second = row;
+        else
+            ranges.emplace_back(row, row);
+    }
+    if (int(ranges.size()) > MAX_REMOVE_RANGES) {
+        beginResetModel();
+        QSet<quint64> removed;
+        for (int row : rows) removed.insert(frameId(row));
+        QList<CalibrationData> kept;
+        kept.reserve(m_frames.size() - int(rows.size()));
+        for (const CalibrationData& d : std::as_const(m_frames))
+            if (!d.frame || !removed.contains(d.frame->id())) kept.append(d);
+        m_frames.swap(kept);
+        m_rowsDirty = true;
+        endResetModel();
+    } else {
+        for (auto it = ranges.rbegin(); it != ranges.rend(); ++it) {
+            beginRemoveRows(QModelIndex(), it->first, it->second);
+            m_frames.erase(m_frames.begin() + it->first, m_frames.begin() + it->second + 1);
+            m_rowsDirty = true;
+            endRemoveRows();
+        }
+    }
+    for (quint64 id : frameIds) m_status.remove(id);
+    scheduleDuplicates();           // 删除的帧可能是其他帧保留的那一张
+}
+
+void DatasetModel::clear()
+{
+    beginResetModel();
+    m_pool.clear();
+    m_pending = 0;
+    m_frames.clear();
+    m_rows.clear();
+    m_rowsDirty = false;
+    m_status.clear();
+    endResetModel();
+    m_duplicateTimer.stop();
+    if (m_duplicates != 0) {
+        m_duplicates = 0;
+        emit duplicatesChanged(0);
+    }
+}
+
+void DatasetModel::sortFrom(int first, const std::function<bool(const CalibrationData&, const CalibrationData&)>& less)
+{
+    if (first < 0 || first >= m_frames.size() - 1) return;
+
+    emit layoutAboutToBeChanged();
+    // 选中项等持久索引按帧 ID 跟随到新位置
+    const QModelIndexList persistent = persistentIndexList();
+    QList<quint64> ids;
+    for (const QModelIndex& index : persistent) ids << frameId(index.row());
+    std::stable_sort(m_frames.begin() + first, m_frames.end(), less);
+    m_rowsDirty = true;
+    for (int i = 0; i < persistent.size(); ++i)
+        changePersistentIndex(persistent[i], index(rowOf(ids[i])));
+    emit layoutChanged();
+    scheduleDuplicates();           // 每组重复帧保留排在最前的一张
+}
+
+void DatasetModel::setBoardSize(const cv::Size& boardSize)
+{
+    if (boardSize == m_boardSize) return;
+    m_boardSize = boardSize;
+    ++m_generation;
+    m_pool.clear();
+    m_pending = 0;
+    for (Status& status : m_status) {
+        status.state   = Status::Unknown;
+        status.hasPose = false;
+    }
+    if (!m_frames.isEmpty())
+        emit dataChanged(index(0), index(m_frames.size() - 1));
+    scheduleDuplicates();
+}
+
+void DatasetModel::thumbnailChanged(quint64 frameId)
+{
+    notifyRow(frameId, { Qt::DecorationRole });
+    scheduleDuplicates();
+}
+
+void DatasetModel::setViewErrors(const std::vector<quint64>& frameIds, const std::vector<double>& errors)
+{
+    for (Status& status : m_status) status.error = -1;      // 新的标定结果替换上一次
+    const size_t n = qMin(frameIds.size(), errors.size());
+    for (size_t i = 0; i < n; ++i)
+        if (frameIds[i] && rowOf(frameIds[i]) >= 0)
+            m_status[frameIds[i]].error = errors[i];
+    if (!m_frames.isEmpty())
+        emit dataChanged(index(0), index(m_frames.size() - 1),
+                         { Qt::DisplayRole, Qt::ToolTipRole, ErrorRole });
+}
+
+void DatasetModel::requestStatus(int row) const
+{
+    if (m_boardSize.empty()) return;
+    const quint64 id = frameId(row);
+    Status& status = m_status[id];
+    if (status.state != Status::Unknown) return;
+
+    // 快速滚动时丢弃排队中的检测，移出视野的行再次显示时重新排队
+    if (m_pending >= MAX_PENDING_DETECTIONS) {
+        m_pool.clear();
+        for (Status& s : m_status)
+            if (s.state == Status::Pending) s.state = Status::Unknown;
+        m_pending = 0;
+    }
+    status.state = Status::Pending;
+    ++m_pending;
+
+    std::weak_ptr<const DatasetFrame> weak = m_frames[row].frame;
+    const cv::Size boardSize = m_boardSize;
+    const int generation = m_generation;
+    DatasetModel* self = const_cast<DatasetModel*>(this);
+    // 后显示的行优先
+    m_pool.start([self, weak, id, boardSize, generation]() {
+        bool detected = false;
+        double sharpness = 0;
+        CaptureGate::Pose pose = {};
+        if (DatasetFramePtr frame = weak.lock()) {
+            cv::Mat image = frame->image();
+            if (image.channels() == 3)
+                cv::cvtColor(image, image, cv::COLOR_BGR2GRAY);
+            std::vector<cv::Point2f> corners;
+            cv::Mat small, small8;
+            if (!image.empty()) {
+                detected = CaptureGate::detectBoard(image, boardSize, DETECT_WIDTH, corners, small, small8);
+                if (detected) {
+                    sharpness = CaptureGate::boardSharpness(image, corners);
+                    pose = CaptureGate::poseOf(corners, boardSize, image.size());
+                }
+            }
+        }
+        QMetaObject::invokeMethod(self, [self, id, generation, detected, sharpness, pose]() {
+            self->applyDetection(id, generation, detected, sharpness, pose);
+        }, Qt::QueuedConnection);
+    }, ++m_priority);
+}
+
+void DatasetModel::applyDetection(quint64 frameId, int generation, bool detected, double sharpness,
+                                  const CaptureGate::Pose& pose)
+{
+    m_pending = qMax(0, m_pending - 1);
+    if (generation != m_generation) return;
+    auto it = m_status.find(frameId);
+    if (it == m_status.end() || it->state != Status::Pending) return;      // 已删除或已被丢弃
+    it->state     = Status::Done;
+    it->detected  = detected;
+    it->sharpness = sharpness;
+    it->hasPose   = detected;
+    it->pose      = pose;
+    notifyRow(frameId, { Qt::DisplayRole, Qt::ToolTipRole, Qt::ForegroundRole, DetectedRole, SharpnessRole });
+    if (detected) scheduleDuplicates();
+}
+
+void DatasetModel::scheduleDuplicates()
+{
+    if (!m_duplicateTimer.isActive()) m_duplicateTimer.start();
+}
+
+// 按行顺序整体重新判定：哈希和位姿陆续到达，先出现的帧总是被保留，结果与到达顺序无关
+// 保留规则与 CalibrationWorker 相同：不重复的帧无论是否检到标定板都作为后续帧的比较对象
+void DatasetModel::updateDuplicates()
+{
+    DuplicateFilter filter;
+    int count = 0;
+    int first = -1, last = -1;
+    for (int row = 0; row < m_frames.size(); ++row) {
+        const DatasetFramePtr& frame = m_frames[row].frame;
+        if (!frame) continue;
+        quint64 hash = 0;
+        const bool hasHash = frame->perceptualHash(hash);
+        auto it = m_status.find(frame->id());
+        const bool hasPose = it != m_status.end() && it->hasPose;
+
+        quint64 duplicateOf = hasHash ? filter.matchHash(hash) : 0;
+        if (!duplicateOf && hasPose) duplicateOf = filter.matchPose(it->pose);
+        if (duplicateOf)
+            ++count;
+        else
+            filter.keep(frame->id(), hasHash ? &hash : nullptr, hasPose ? &it->pose : nullptr);
+
+        if (duplicateOf != (it != m_status.end() ? it->duplicateOf : 0)) {
+            if (it == m_status.end()) it = m_status.insert(frame->id(), Status());
+            it->duplicateOf = duplicateOf;
+            if (first < 0) first = row;
+            last = row;
+        }
+    }
+    if (first >= 0)
+        emit dataChanged(index(first), index(last), { Qt::DisplayRole, Qt::ToolTipRole, Qt::ForegroundRole, DuplicateRole });
+    if (count != m_duplicates) {
+        m_duplicates = count;
+        emit duplicatesChanged(count);
+    }
+}
+
+void DatasetModel::notifyRow(quint64 frameId, const QVector<int>& roles)
+{
+    const int row = rowOf(frameId);
+    if (row < 0) return;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, roles);
+}
+
+QString DatasetModel::statusText(const Status& status) const
+{
+    QString text;
+    if (status.state == Status::Done)
+        text = status.detected ? tr("  ✓ 清晰度 %1").arg(status.sharpness, 0, 'f', 2) : tr("  ✗ 无标定板");
+    if (status.error >= 0)
+        text += tr("  误差 %1 px").arg(status.error, 0, 'f', 3);
+    if (status.duplicateOf) {
+        const int original = rowOf(status.duplicateOf);
+        text += original >= 0 ? tr("  ≈ 与 #%1 重复").arg(original + 1) : tr("  ≈ 重复");
+    }
+    return text;
+}
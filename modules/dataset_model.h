@@ -0,0 +1,100 @@
+#ifndef DATASET_MODEL_H
+#define DATASET_MODEL_H
+
+#include <QAbstractListModel>
+#include <QThreadPool>
+#include <QTimer>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <functional>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "device_management.h"
+#include "capture_gate.h"
+
+// 数据集列表模型：行按帧 ID（DatasetFrame::id）定位，增删只通知变化的行，
+// 视图按统一行高只绘制可见行。逐帧状态在行第一次显示时于后台计算：
+//   标定板检测与棋盘区域清晰度（同自动采集的评估方法）
+//   重投影误差由标定完成后回填
+//   近似重复：缩略图哈希和已检测到的位姿变化后整体重新判定（DuplicateFilter，与标定时的跳过规则相同）
+class DatasetModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        FrameIdRole = Qt::UserRole + 1,
+        DetectedRole,               // 未检测时为无效 QVariant
+        SharpnessRole,
+        ErrorRole,                  // 未参与标定时为无效 QVariant
+        DuplicateRole,              // 与之重复的帧 ID；不重复时为无效 QVariant
+    };
+
+    explicit DatasetModel(QObject* parent = nullptr);
+    ~DatasetModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    const QList<CalibrationData>& frames() const { return m_frames; }
+    const CalibrationData& at(int row) const { return m_frames[row]; }
+    bool isEmpty() const { return m_frames.isEmpty(); }
+    int  size() const { return m_frames.size(); }
+    // 帧不存在时返回 -1
+    int  rowOf(quint64 frameId) const;
+    quint64 frameId(int row) const;
+
+    void append(const CalibrationData& data);
+    void append(const QList<CalibrationData>& data);
+    void remove(const QList<quint64>& frameIds);
+    void clear();
+    // 对 [first, size) 稳定排序，不增删行
+    void sortFrom(int first, const std::function<bool(const CalibrationData&, const CalibrationData&)>& less);
+
+    // 标定板规格改变时重新检测
+    void setBoardSize(const cv::Size& boardSize);
+    void thumbnailChanged(quint64 frameId);
+    // perViewErrors 与参与标定的帧一一对应
+    void setViewErrors(const std::vector<quint64>& frameIds, const std::vector<double>& errors);
+    int  duplicateCount() const { return m_duplicates; }
+
+signals:
+    void duplicatesChanged(int count);
+
+private:
+    struct Status {
+        enum State { Unknown, Pending, Done };
+        State  state = Unknown;
+        bool   detected = false;
+        double sharpness = 0;
+        double error = -1;
+        bool   hasPose = false;         // 检测到标定板后才有
+        CaptureGate::Pose pose;
+        quint64 duplicateOf = 0;
+    };
+
+    void requestStatus(int row) const;
+    void applyDetection(quint64 frameId, int generation, bool detected, double sharpness,
+                        const CaptureGate::Pose& pose);
+    void scheduleDuplicates();
+    void updateDuplicates();
+    void notifyRow(quint64 frameId, const QVector<int>& roles);
+    QString statusText(const Status& status) const;
+
+    QList<CalibrationData> m_frames;
+    mutable QHash<quint64, int> m_rows;         // 帧 ID -> 行，增删后按需重建
+    mutable bool m_rowsDirty = false;
+    mutable QHash<quint64, Status> m_status;
+
+    cv::Size m_boardSize;
+    int      m_generation = 0;                  // 标定板规格每改变一次加一，丢弃旧规格的结果
+    mutable QThreadPool m_pool;
+    mutable int m_pending = 0;
+    mutable int m_priority = 0;
+
+    QTimer   m_duplicateTimer;                  // 缩略图和检测结果成批到达，合并为一次判定
+    int      m_duplicates = 0;
+};
+
+#endif // DATASET_MODEL_H
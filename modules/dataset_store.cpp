@@ -0,0 +1,256 @@
+#include "dataset_store.h"
+#include "image_loader.h"
+#include "raw_dataset.h"
+#include "duplicate_filter.h"
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <climits>
+
+// 缓存代价按 KB 计，Qt5 的 QCache 代价为 int
+static int costOf(const cv::Mat& image)
+{
+    return int(qMax<qint64>(1, qint64(image.total() * image.elemSize()) >> 10));
+}
+
+// 帧 ID 在所有存储（含常驻帧）之间唯一
+static std::atomic<quint64> s_nextFrameId{1};
+
+/*-------------------------------- DatasetFrame --------------------------------*/
+DatasetFrame::~DatasetFrame()
+{
+    if (m_store)
+        m_store->remove(m_key, m_thumbnail.sizeInBytes());
+}
+
+cv::Mat DatasetFrame::image() const
+{
+    if (!m_resident.empty()) return m_resident;
+    if (!m_store) return cv::Mat();
+    // 映射区视图不需要缓存，页面由系统按需读入和回收
+    if (m_recording && m_recording->isZeroCopy(m_frameIndex))
+        return m_recording->image(m_frameIndex);
+
+    cv::Mat image;
+    if (m_store->lookup(m_key, image)) return image;
+    QElapsedTimer timer;
+    timer.start();
+    image = load();
+    m_store->recordLoad(timer.nsecsElapsed());
+    if (!image.empty())
+        m_store->insert(m_key, image);
+    return image;
+}
+
+cv::Mat DatasetFrame::load() const
+{
+    if (m_recording) return m_recording->image(m_frameIndex);
+    if (!m_path.isEmpty()) return ImageLoader::decode(m_path, m_keep16Bit, m_keepColor);
+    return cv::Mat();
+}
+
+QImage DatasetFrame::thumbnail() const
+{
+    QMutexLocker locker(&m_thumbnailMutex);
+    return m_thumbnail;
+}
+
+bool DatasetFrame::hasThumbnail() const
+{
+    QMutexLocker locker(&m_thumbnailMutex);
+    return !m_thumbnail.isNull();
+}
+
+bool DatasetFrame::perceptualHash(quint64& hash) const
+{
+    QMutexLocker locker(&m_thumbnailMutex);
+    hash = m_hash;
+    return m_hasHash;
+}
+
+// 在生成缩略图的线程中计算哈希，不占用界面线程
+void DatasetFrame::setThumbnail(const QImage& thumbnail) const
+{
+    const quint64 hash = DuplicateFilter::perceptualHash(thumbnail);
+    QMutexLocker locker(&m_thumbnailMutex);
+    if (m_store)
+        m_store->countThumbnail(thumbnail.sizeInBytes() - m_thumbnail.sizeInBytes());
+    m_thumbnail = thumbnail;
+    m_hash      = hash;
+    m_hasHash   = !thumbnail.isNull();
+}
+
+bool DatasetFrame::isCached() const
+{
+    if (!m_resident.empty()) return true;
+    if (!m_store) return false;
+    if (m_recording && m_recording->isZeroCopy(m_frameIndex)) return true;
+    QMutexLocker locker(&m_store->m_mutex);
+    return m_store->m_cache.contains(m_key);
+}
+
+/*-------------------------------- DatasetStore --------------------------------*/
+std::shared_ptr<DatasetStore> DatasetStore::create(const Options& options)
+{
+    return std::shared_ptr<DatasetStore>(new DatasetStore(options));
+}
+
+DatasetStore::DatasetStore(const Options& options)
+    : m_options(options)
+{
+    m_cache.setMaxCost(int(qBound<qint64>(1, options.cacheBytes >> 10, INT_MAX)));
+}
+
+// 预取任务只持有帧的弱引用，存储随最后一帧释放，不在这里等待
+DatasetStore::~DatasetStore()
+{
+    m_generation.fetch_add(1);
+}
+
+DatasetFramePtr DatasetStore::addFile(const QString& path, bool keep16Bit, bool keepColor,
+                                      const cv::Size& size, const QImage& thumbnail,
+                                      const cv::Mat& decoded)
+{
+    std::shared_ptr<DatasetFrame> frame(new DatasetFrame);
+    frame->m_store     = shared_from_this();
+    frame->m_path      = path;
+    frame->m_keep16Bit = keep16Bit;
+    frame->m_keepColor = keepColor;
+    frame->m_size      = size;
+    frame->m_thumbnail = thumbnail;
+    frame->m_hash      = DuplicateFilter::perceptualHash(thumbnail);
+    frame->m_hasHash   = !thumbnail.isNull();
+    frame->m_key       = s_nextFrameId.fetch_add(1);
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_frames;
+        m_thumbnailBytes += thumbnail.sizeInBytes();
+    }
+    if (!decoded.empty())
+        insert(frame->m_key, decoded);
+    return frame;
+}
+
+DatasetFramePtr DatasetStore::addRecording(const std::shared_ptr<RawDataset>& dataset, int index)
+{
+    if (!dataset || index < 0 || index >= dataset->frameCount() || !dataset->isDecodable(index))
+        return DatasetFramePtr();
+
+    const RawContainer::IndexEntry& e = dataset->entry(index);
+    std::shared_ptr<DatasetFrame> frame(new DatasetFrame);
+    frame->m_store      = shared_from_this();
+    frame->m_recording  = dataset;
+    frame->m_frameIndex = index;
+    frame->m_size       = cv::Size(int(e.width), int(e.height));
+    frame->m_key        = s_nextFrameId.fetch_add(1);
+    QMutexLocker locker(&m_mutex);
+    ++m_frames;
+    return frame;
+}
+
+DatasetFramePtr DatasetStore::resident(const cv::Mat& image, int thumbnailWidth)
+{
+    if (image.empty()) return DatasetFramePtr();
+    std::shared_ptr<DatasetFrame> frame(new DatasetFrame);
+    frame->m_key       = s_nextFrameId.fetch_add(1);
+    frame->m_resident  = image;
+    frame->m_size      = image.size();
+    frame->m_thumbnail = ImageLoader::thumbnail(image, thumbnailWidth);
+    frame->m_hash      = DuplicateFilter::perceptualHash(frame->m_thumbnail);
+    frame->m_hasHash   = !frame->m_thumbnail.isNull();
+    return frame;
+}
+
+void DatasetStore::prefetch(const QList<DatasetFramePtr>& frames)
+{
+    const int generation = m_generation.fetch_add(1) + 1;
+    for (const DatasetFramePtr& frame : frames) {
+        if (!frame || frame->m_store.get() != this || frame->isCached()) continue;
+        {
+            // 已排队的帧只更新所属批次，由原任务读取
+            QMutexLocker locker(&m_mutex);
+            const bool queued = m_loading.contains(frame->m_key);
+            m_loading.insert(frame->m_key, generation);
+            if (queued) continue;
+        }
+        std::weak_ptr<const DatasetFrame> weak = frame;
+        std::weak_ptr<DatasetStore> store = shared_from_this();
+        const quint64 key = frame->m_key;
+        QThreadPool::globalInstance()->start([weak, store, key]() {
+            std::shared_ptr<DatasetStore> self = store.lock();
+            if (!self) return;
+            bool current;
+            {
+                QMutexLocker locker(&self->m_mutex);
+                current = self->m_loading.value(key) == self->m_generation.load();
+            }
+            // 已被更新的预取替换或帧已删除的任务直接跳过
+            DatasetFramePtr f = current ? weak.lock() : DatasetFramePtr();
+            if (f && !f->image().empty())
+                self->m_prefetched.fetch_add(1, std::memory_order_relaxed);
+            QMutexLocker locker(&self->m_mutex);
+            self->m_loading.remove(key);
+        });
+    }
+}
+
+void DatasetStore::cancelPrefetch()
+{
+    m_generation.fetch_add(1);
+}
+
+DatasetStore::Stats DatasetStore::stats() const
+{
+    Stats out;
+    {
+        QMutexLocker locker(&m_mutex);
+        out.frames         = m_frames;
+        out.cached         = m_cache.count();
+        out.cachedBytes    = qint64(m_cache.totalCost()) << 10;
+        out.thumbnailBytes = m_thumbnailBytes;
+    }
+    out.cacheBytes = m_options.cacheBytes;
+    out.hits       = m_hits.load();
+    out.misses     = m_misses.load();
+    out.prefetched = m_prefetched.load();
+    if (out.misses > 0)
+        out.avgLoadMs = m_loadNs.load() / 1e6 / double(out.misses);
+    return out;
+}
+
+bool DatasetStore::lookup(quint64 key, cv::Mat& image)
+{
+    QMutexLocker locker(&m_mutex);
+    const cv::Mat* cached = m_cache.object(key);        // 同时移到最近使用
+    if (!cached) return false;
+    image = *cached;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// 淘汰只释放缓存的引用，使用方仍持有的 Mat 不受影响
+void DatasetStore::insert(quint64 key, const cv::Mat& image)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, new cv::Mat(image), costOf(image));
+}
+
+void DatasetStore::remove(quint64 key, qint64 thumbnailBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(key);
+    --m_frames;
+    m_thumbnailBytes -= thumbnailBytes;
+}
+
+void DatasetStore::countThumbnail(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_thumbnailBytes += bytes;
+}
+
+void DatasetStore::recordLoad(qint64 nsecs)
+{
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    m_loadNs.fetch_add(nsecs, std::memory_order_relaxed);
+}
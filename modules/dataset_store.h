@@ -0,0 +1,138 @@
+#ifndef DATASET_STORE_H
+#define DATASET_STORE_H
+
+#include <QString>
+#include <QImage>
+#include <QMutex>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <atomic>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+class RawDataset;
+class DatasetStore;
+
+// 数据集中的一帧：常驻的只有缩略图，全分辨率像素按需从来源读取
+//   图像文件：按加载时的解码选项重新解码
+//   录制文件：Mono8 / Mono16 帧为映射区视图（不占缓存），其他格式转换为灰度后进入缓存（超过 8 位的为 16 位）
+//   相机采集：没有可回读的来源，像素常驻
+// 帧不可变，副本之间共享；最后一个引用释放时从缓存中移除
+class DatasetFrame
+{
+public:
+    ~DatasetFrame();
+    DatasetFrame(const DatasetFrame&) = delete;
+    DatasetFrame& operator=(const DatasetFrame&) = delete;
+
+    // 进程内唯一，删除其他帧后不变
+    quint64 id() const { return m_key; }
+    // 全分辨率像素；缓存未命中时在调用线程中读取，失败返回空 Mat
+    cv::Mat image() const;
+    // 尚未生成时为空（录制帧和从文件加载的帧由 ThumbnailCache 在后台生成）
+    QImage thumbnail() const;
+    bool hasThumbnail() const;
+    // 缩略图的感知哈希（DuplicateFilter），随缩略图一起在后台生成，尚未生成时返回 false
+    bool perceptualHash(quint64& hash) const;
+    // 图像文件路径；录制帧和相机采集的帧为空
+    QString sourcePath() const { return m_path; }
+    int  recordingFrame() const { return m_recording ? m_frameIndex : -1; }
+    cv::Size size() const { return m_size; }
+    bool isResident() const { return !m_resident.empty(); }
+    bool isCached() const;
+
+private:
+    friend class DatasetStore;
+    friend class ThumbnailCache;
+    DatasetFrame() = default;
+    cv::Mat load() const;
+    void setThumbnail(const QImage& thumbnail) const;
+
+    std::shared_ptr<DatasetStore> m_store;     // 常驻帧为空
+    quint64  m_key = 0;
+    QString  m_path;
+    bool     m_keep16Bit = true;
+    bool     m_keepColor = false;
+    std::shared_ptr<RawDataset> m_recording;
+    int      m_frameIndex = -1;
+    cv::Mat  m_resident;
+    cv::Size m_size;
+
+    mutable QMutex m_thumbnailMutex;
+    mutable QImage m_thumbnail;
+    mutable quint64 m_hash = 0;
+    mutable bool   m_hasHash = false;
+};
+
+using DatasetFramePtr = std::shared_ptr<const DatasetFrame>;
+
+// 数据集存储：按字节数限制的 LRU 缓存保存最近读取的全分辨率像素，
+// 列表滚动时在后台预取可见区附近的帧。内存占用 = 缩略图 + 缓存上限，与帧数无关
+class DatasetStore : public std::enable_shared_from_this<DatasetStore>
+{
+public:
+    struct Options {
+        qint64 cacheBytes = qint64(512) << 20;  // 全分辨率缓存上限
+        int    thumbnailWidth = 160;
+    };
+
+    struct Stats {
+        int     frames = 0;             // 存储中的帧数
+        int     cached = 0;
+        qint64  cachedBytes = 0;
+        qint64  cacheBytes = 0;         // 缓存上限
+        qint64  thumbnailBytes = 0;
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 prefetched = 0;
+        double  avgLoadMs = 0;          // 未命中时的平均读取耗时
+    };
+
+    static std::shared_ptr<DatasetStore> create(const Options& options = Options());
+    ~DatasetStore();
+    DatasetStore(const DatasetStore&) = delete;
+    DatasetStore& operator=(const DatasetStore&) = delete;
+
+    const Options& options() const { return m_options; }
+
+    // decoded 为加载时已解码的图像，放入缓存省去首次访问时再次解码
+    DatasetFramePtr addFile(const QString& path, bool keep16Bit, bool keepColor,
+                            const cv::Size& size, const QImage& thumbnail,
+                            const cv::Mat& decoded = cv::Mat());
+    // 帧格式无法转换时返回空
+    DatasetFramePtr addRecording(const std::shared_ptr<RawDataset>& dataset, int index);
+    // 相机采集的帧：像素常驻，不经缓存
+    static DatasetFramePtr resident(const cv::Mat& image, int thumbnailWidth = Options().thumbnailWidth);
+
+    // 预取替换上一次尚未开始的预取；在全局线程池中读取
+    void prefetch(const QList<DatasetFramePtr>& frames);
+    void cancelPrefetch();
+
+    Stats stats() const;
+
+private:
+    friend class DatasetFrame;
+    explicit DatasetStore(const Options& options);
+
+    bool lookup(quint64 key, cv::Mat& image);
+    void insert(quint64 key, const cv::Mat& image);
+    void remove(quint64 key, qint64 thumbnailBytes);
+    void countThumbnail(qint64 bytes);
+    void recordLoad(qint64 nsecs);
+
+    Options m_options;
+    mutable QMutex m_mutex;
+    QCache<quint64, cv::Mat> m_cache;       // 代价以 KB 计
+    QHash<quint64, int> m_loading;          // 已排队预取的帧 -> 所属批次
+    int     m_frames = 0;
+    qint64  m_thumbnailBytes = 0;
+
+    std::atomic<int>     m_generation{0};
+    std::atomic<quint64> m_hits{0};
+    std::atomic<quint64> m_misses{0};
+    std::atomic<quint64> m_prefetched{0};
+    std::atomic<qint64>  m_loadNs{0};
+};
+
+#endif // DATASET_STORE_H
@@ -0,0 +1,188 @@
+#include "device_enumerator.h"
+#include <QSet>
+#include <QDebug>
+
+static QString ipToString(unsigned int ip)
+{
+    return QString("%1.%2.%3.%4")
+        .arg((ip >> 24) & 0xFF).arg((ip >> 16) & 0xFF)
+        .arg((ip >> 8) & 0xFF).arg(ip & 0xFF);
+}
+
+DeviceEnumerator::DeviceEnumerator(QObject* parent)
+    : QObject(parent)
+    , m_pollTimer(new QTimer(this))
+{
+    connect(m_pollTimer, &QTimer::timeout, this, &DeviceEnumerator::rescan);
+}
+
+DeviceEnumerator::~DeviceEnumerator()
+{
+    stop();
+}
+
+void DeviceEnumerator::start(int pollIntervalMs)
+{
+    if (pollIntervalMs > 0) {
+        m_pollTimer->setInterval(pollIntervalMs);
+        m_pollTimer->start();
+    }
+    rescan();
+}
+
+void DeviceEnumerator::stop()
+{
+    m_pollTimer->stop();
+    m_rescanPending = false;
+    if (!m_scanThread) return;
+    // SDK 枚举不能中断，只能等它返回；结果随线程一起丢弃
+    m_scanThread->wait();
+    delete m_scanThread;
+    m_scanThread = nullptr;
+}
+
+void DeviceEnumerator::rescan()
+{
+    if (m_scanThread) {
+        m_rescanPending = true;
+        return;
+    }
+    startScan();
+}
+
+QList<DeviceInfo*> DeviceEnumerator::devices() const
+{
+    QList<DeviceInfo*> list;
+    list.reserve(int(m_devices.size()));
+    for (const auto& dev : m_devices)
+        list.append(dev.get());
+    return list;
+}
+
+DeviceInfo* DeviceEnumerator::device(const QString& key) const
+{
+    for (const auto& dev : m_devices) {
+        if (dev->key == key) return dev.get();
+    }
+    return nullptr;
+}
+
+void DeviceEnumerator::startScan()
+{
+    auto result = std::make_shared<ScanResult>();
+    QThread* thread = QThread::create([result]() { enumerate(*result); });
+    connect(thread, &QThread::finished, this, [this, thread, result]() {
+        if (thread != m_scanThread) return;         // stop() 已回收
+        m_scanThread = nullptr;
+        delete thread;
+        applyScan(*result);
+        if (m_rescanPending) {
+            m_rescanPending = false;
+            startScan();
+        }
+    });
+    m_scanThread = thread;
+    thread->start();
+}
+
+// 工作线程：真实设备枚举失败时仍继续枚举模拟相机；设备信息立即拷出，
+// SDK/模拟相机的枚举缓存在下次枚举时会被覆盖
+void DeviceEnumerator::enumerate(ScanResult& result)
+{
+    MV_CC_DEVICE_INFO_LIST stDeviceList{};
+    int ret = CMvCamera::EnumDevices(MV_GIGE_DEVICE | MV_USB_DEVICE, &stDeviceList);
+    if (ret != MV_OK) {
+        result.error = QObject::tr("设备枚举失败: %1").arg(ret);
+        stDeviceList.nDeviceNum = 0;
+    }
+    for (unsigned int i = 0; i < stDeviceList.nDeviceNum; ++i) {
+        const MV_CC_DEVICE_INFO* info = stDeviceList.pDeviceInfo[i];
+        if (info && (info->nTLayerType == MV_GIGE_DEVICE || info->nTLayerType == MV_USB_DEVICE))
+            result.devices.append(describe(*info, false));
+    }
+
+    // 模拟相机：配置启用时追加在真实设备之后
+    result.simConfig = SimCameraConfig::load();
+    MV_CC_DEVICE_INFO_LIST stSimList{};
+    if (result.simConfig.enabled && CSimCamera::EnumDevices(result.simConfig, &stSimList) == MV_OK) {
+        for (unsigned int i = 0; i < stSimList.nDeviceNum; ++i)
+            result.devices.append(describe(*stSimList.pDeviceInfo[i], true));
+    }
+}
+
+DeviceEnumerator::Found DeviceEnumerator::describe(const MV_CC_DEVICE_INFO& info, bool simulated)
+{
+    Found found;
+    found.info      = info;
+    found.simulated = simulated;
+    if (info.nTLayerType == MV_GIGE_DEVICE) {
+        const MV_GIGE_DEVICE_INFO& gige = info.SpecialInfo.stGigEInfo;
+        found.ipAddress    = ipToString(gige.nCurrentIp);
+        found.model        = QString::fromLocal8Bit((const char*)gige.chModelName);
+        found.serialNumber = QString::fromLocal8Bit((const char*)gige.chSerialNumber);
+        found.name         = simulated ? QObject::tr("模拟相机: %1").arg(found.serialNumber)
+                                       : QObject::tr("GigE相机: %1").arg(found.model);
+    } else {
+        const MV_USB3_DEVICE_INFO& usb = info.SpecialInfo.stUsb3VInfo;
+        found.model        = QString::fromLocal8Bit((const char*)usb.chModelName);
+        found.serialNumber = QString::fromLocal8Bit((const char*)usb.chSerialNumber);
+        found.name         = QObject::tr("USB相机: %1").arg(found.model);
+        found.ipAddress    = QObject::tr("USB连接");
+    }
+    found.key = found.serialNumber.isEmpty() ? QString("%1@%2").arg(found.model, found.ipAddress)
+                                             : found.serialNumber;
+    return found;
+}
+
+// GUI 线程：与注册表比对，先报离开再报新增
+void DeviceEnumerator::applyScan(const ScanResult& result)
+{
+    if (!result.error.isEmpty())
+        emit scanError(result.error);
+
+    QSet<QString> present;
+    for (const Found& found : result.devices)
+        present.insert(found.key);
+
+    for (auto it = m_devices.begin(); it != m_devices.end();) {
+        DeviceInfo* dev = it->get();
+        // 已连接的设备取流时可能不响应发现报文，保留到断开后的下一次扫描
+        if (present.contains(dev->key) || dev->isConnected) {
+            ++it;
+            continue;
+        }
+        emit deviceRemoved(dev);
+        it = m_devices.erase(it);
+    }
+
+    for (const Found& found : result.devices) {
+        if (DeviceInfo* dev = device(found.key)) {
+            // 未连接的设备刷新枚举信息（如 IP 变化），已打开的保持不动
+            if (!dev->isConnected) {
+                dev->hikInfo   = found.info;
+                dev->ipAddress = found.ipAddress;
+            }
+            continue;
+        }
+
+        auto dev = std::make_unique<DeviceInfo>();
+        dev->nIndex       = m_nextIndex++;
+        dev->key          = found.key;
+        dev->name         = found.name;
+        dev->model        = found.model;
+        dev->serialNumber = found.serialNumber;
+        dev->ipAddress    = found.ipAddress;
+        dev->isSimulated  = found.simulated;
+        dev->hikInfo      = found.info;
+        dev->pHikInfo     = &dev->hikInfo;
+        if (found.simulated)
+            dev->camera = std::make_unique<CSimCamera>(result.simConfig);
+        else
+            dev->camera = std::make_unique<CMvCamera>();
+
+        DeviceInfo* added = dev.get();
+        m_devices.push_back(std::move(dev));
+        emit deviceArrived(added);
+    }
+    emit scanFinished(int(m_devices.size()));
+}
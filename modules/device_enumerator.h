@@ -0,0 +1,90 @@
+#ifndef DEVICE_ENUMERATOR_H
+#define DEVICE_ENUMERATOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QList>
+#include <memory>
+#include <vector>
+#include "cmvcamera.h"
+#include "simcamera.h"
+
+//设备信息
+struct DeviceInfo
+{
+    int         nIndex = -1;              // 到达时分配，设备离开前不变，用作采集引擎的相机编号
+    QString     key;                      // 注册表键：序列号（缺失时用型号@IP）
+    QString     name;
+    QString     model;
+    QString     serialNumber;
+    QString     ipAddress;
+    bool        isConnected = false;
+    bool        isSimulated = false;      // 模拟相机
+
+    // SDK 相关
+    std::unique_ptr<CMvCamera> camera;    // 真实相机为 CMvCamera，模拟相机为 CSimCamera
+    MV_CC_DEVICE_INFO  hikInfo{};         // 枚举结果的副本，不依赖 SDK 的枚举缓存
+    MV_CC_DEVICE_INFO* pHikInfo = nullptr;    // 指向 hikInfo
+};
+
+// 设备枚举服务：在后台线程枚举（GigE 发现要等超时，可能持续数秒），
+// 结果回到 GUI 线程与按序列号索引的注册表比对，只对新增/离开的设备发事件，
+// 已有的 DeviceInfo/CMvCamera 在重扫后保持不变；可定时重扫以跟踪热插拔
+class DeviceEnumerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceEnumerator(QObject* parent = nullptr);
+    ~DeviceEnumerator() override;
+
+    // 立即开始一次后台扫描；pollIntervalMs > 0 时之后按该间隔重扫
+    void start(int pollIntervalMs = 5000);
+    // 停止定时重扫并等待正在进行的扫描结束
+    void stop();
+    // 请求重扫，扫描进行中时在其结束后再扫一次
+    void rescan();
+    bool isScanning() const { return m_scanThread != nullptr; }
+
+    // 注册表中的设备，按到达顺序；指针在 deviceRemoved 之前有效
+    QList<DeviceInfo*> devices() const;
+    DeviceInfo* device(const QString& key) const;
+
+signals:
+    void deviceArrived(DeviceInfo* device);
+    // 发出后设备即被删除，接收方不得继续持有指针；已连接的设备不会被移除
+    void deviceRemoved(DeviceInfo* device);
+    void scanFinished(int deviceCount);
+    void scanError(const QString& error);
+
+private:
+    // 一次扫描发现的设备，在工作线程中生成
+    struct Found {
+        MV_CC_DEVICE_INFO info;
+        QString key;
+        QString name;
+        QString model;
+        QString serialNumber;
+        QString ipAddress;
+        bool    simulated = false;
+    };
+    struct ScanResult {
+        QList<Found> devices;
+        SimCameraConfig simConfig;
+        QString error;
+    };
+
+    void startScan();
+    void applyScan(const ScanResult& result);
+    static void enumerate(ScanResult& result);
+    static Found describe(const MV_CC_DEVICE_INFO& info, bool simulated);
+
+    QTimer*  m_pollTimer;
+    QThread* m_scanThread = nullptr;
+    bool     m_rescanPending = false;
+    int      m_nextIndex = 0;
+    std::vector<std::unique_ptr<DeviceInfo>> m_devices;
+};
+
+#endif // DEVICE_ENUMERATOR_H
@@ -2,6 +2,7 @@
 #include "device_management.h"
 #include "../Drawer.h"
 #include <QMessageBox>
+#include <QFileDialog>
 #include <QSettings>
 #include <QDateTime>
 #include <QFile>
@@ -10,122 +11,261 @@
 #include <QJsonArray>
 #include <opencv2/opencv.hpp>
 #include <QImage>
+#include <QtMath>
+#include <QSignalBlocker>
+#include <QPolygonF>
+#include <QApplication>
+
+// 临时切回全分辨率后等待第一帧的上限（含曝光和大幅面传输）
+static const int FULL_RESOLUTION_FRAME_TIMEOUT_MS = 3000;
+
+/*-------------------------------- CalibrationData --------------------------------*/
+namespace {
+struct ImageViewHolder {
+    cv::Mat image;
+    DatasetFramePtr frame;      // 录制帧的映射区视图需要数据集保持打开
+};
+
+void releaseImageView(void* info)
+{
+    delete static_cast<ImageViewHolder*>(info);
+}
+} // namespace
+
+QImage CalibrationData::qImage() const
+{
+    const cv::Mat image = this->image();
+    QImage::Format format;
+    switch (image.type()) {
+    case CV_8UC1:  format = QImage::Format_Grayscale8;  break;
+    case CV_16UC1: format = QImage::Format_Grayscale16; break;
+    case CV_8UC3:  format = QImage::Format_BGR888;      break;
+    default:       return QImage();
+    }
+    return QImage(image.data, image.cols, image.rows, int(image.step), format,
+                  releaseImageView, new ImageViewHolder{ image, frame });
+}
 
 DeviceManagementModule::DeviceManagementModule(QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::DeviceManagementModule)
-    , m_frameTimer(new QTimer(this))
+    , m_engine(new AcquisitionEngine(this))
+    , m_previewRenderer(new PreviewRenderer(this))
+    , m_recorder(new StreamRecorder(this))
+    , m_captureGate(new CaptureGate(this))
+    , m_boardTracker(new BoardTracker(this))
+    , m_exposureController(new ExposureController(m_engine, this))
+    , m_enumerator(new DeviceEnumerator(this))
     , m_connectedDevice(nullptr)
-    , m_previewTimer(new QTimer(this))
-    , m_autoCaptureTimer(new QTimer(this))
+    , m_telemetryTimer(new QTimer(this))
     , m_isPreviewing(false)
+    , m_isAutoCapturing(false)
 {
     ui->setupUi(this);
     ui->cam2->hide();
     ui->captureImageButton->setEnabled(false);
-    m_previewTimer->setInterval(33);          // ~30 fps
-    m_autoCaptureTimer->setInterval(5000);    // 默认 5 s
+    ui->autoCaptureButton->setEnabled(false);
+    ui->overlayButton->setEnabled(false);
+    ui->autoExposureButton->setEnabled(false);
+    m_sensorModes = SensorMode::presets();
+    for (const SensorMode& mode : m_sensorModes)
+        ui->resolutionComboBox->addItem(mode.name);
+    ui->resolutionComboBox->setEnabled(false);
+    m_telemetryTimer->setInterval(1000);
 
     // 按钮绑定
     connect(ui->refreshButton, &QPushButton::clicked, this, &DeviceManagementModule::onRefreshButtonClicked);
     connect(ui->connectButton, &QPushButton::clicked, this, &DeviceManagementModule::onConnectButtonClicked);
     connect(ui->disconnectButton, &QPushButton::clicked, this, &DeviceManagementModule::onDisconnectButtonClicked);
     connect(ui->applySettingsButton, &QPushButton::clicked, this, &DeviceManagementModule::onApplySettingsButtonClicked);
-    // connect(ui->deviceListWidget, &QListWidget::itemClicked, this, &DeviceManagementModule::onDeviceSelected);
-    connect(m_frameTimer, &QTimer::timeout, this, &DeviceManagementModule::updateFrame);
+    connect(ui->gige_listWidget, &QListWidget::itemClicked, this, &DeviceManagementModule::onDeviceSelected);
+    connect(ui->usb_listWidget, &QListWidget::itemClicked, this, &DeviceManagementModule::onDeviceSelected);
+    // 设备枚举在后台进行，启动时不等待 GigE 发现超时
+    connect(m_enumerator, &DeviceEnumerator::deviceArrived, this, &DeviceManagementModule::onDeviceArrived);
+    connect(m_enumerator, &DeviceEnumerator::deviceRemoved, this, &DeviceManagementModule::onDeviceRemoved);
+    connect(m_enumerator, &DeviceEnumerator::scanFinished, this, &DeviceManagementModule::onScanFinished);
+    connect(m_enumerator, &DeviceEnumerator::scanError, this, &DeviceManagementModule::statusChanged);
+    // 采集引擎：抓图在独立线程；预览渲染器从帧队列取最新帧，缩放后投递到 GUI 线程
+    connect(m_engine, &AcquisitionEngine::errorOccurred, this, &DeviceManagementModule::statusChanged);
+    connect(m_previewRenderer, &PreviewRenderer::frameReady, this, &DeviceManagementModule::onPreviewFrame,
+            Qt::QueuedConnection);
+    connect(ui->cam1, &PreviewLabel::targetSizeChanged, m_previewRenderer, &PreviewRenderer::setTargetSize);
 
     connect(ui->toggleBtn, &QPushButton::clicked, ui->drawer_widget, &Drawer::toggle);
     connect(ui->startPreviewButton,  &QPushButton::clicked, this, &DeviceManagementModule::onStartPreviewClicked);
     connect(ui->stopPreviewButton,   &QPushButton::clicked, this, &DeviceManagementModule::onStopPreviewClicked);
     connect(ui->captureImageButton,  &QPushButton::clicked, this, &DeviceManagementModule::onCaptureImageClicked);
+    connect(ui->recordButton,        &QPushButton::clicked, this, &DeviceManagementModule::onRecordClicked);
+    connect(ui->autoCaptureButton,   &QPushButton::toggled, this, &DeviceManagementModule::onAutoCaptureToggled);
+    connect(m_captureGate, &CaptureGate::frameAccepted, this, &DeviceManagementModule::onAutoCaptureAccepted,
+            Qt::QueuedConnection);
+    connect(ui->overlayButton,       &QPushButton::toggled, this, &DeviceManagementModule::onOverlayToggled);
+    connect(m_boardTracker, &BoardTracker::overlayReady, this, &DeviceManagementModule::onBoardOverlay,
+            Qt::QueuedConnection);
+    connect(ui->autoExposureButton,  &QPushButton::toggled, this, &DeviceManagementModule::onAutoExposureToggled);
+    connect(m_exposureController, &ExposureController::converged, this, &DeviceManagementModule::onAutoExposureConverged);
+    connect(m_exposureController, &ExposureController::errorOccurred, this, &DeviceManagementModule::statusChanged);
+    connect(ui->resolutionComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &DeviceManagementModule::onSensorModeChanged);
+    connect(m_recorder, &StreamRecorder::errorOccurred, this, &DeviceManagementModule::statusChanged);
+    connect(ui->exportTelemetryButton, &QPushButton::clicked, this, &DeviceManagementModule::onExportTelemetryClicked);
     // 计时器绑定
-    connect(m_previewTimer,    &QTimer::timeout, this, &DeviceManagementModule::onUpdateFrame);
-    connect(m_autoCaptureTimer,&QTimer::timeout, this, &DeviceManagementModule::autoCaptureImage);
-    scanHikVisionDevices();
+    connect(m_telemetryTimer, &QTimer::timeout, this, &DeviceManagementModule::updateTelemetryPanel);
+    m_enumerator->start();
 }
 
 DeviceManagementModule::~DeviceManagementModule()
 {
+    stopTransportTuning();
     stopStream();
-    qDeleteAll(m_deviceList);
+    delete m_nodeMap;
+    m_nodeMap = nullptr;
+    if (m_connectedDevice && m_connectedDevice->isConnected)
+        m_connectedDevice->camera->Close();
+    m_enumerator->stop();
     qDeleteAll(m_configList);
-    delete progressDialog;
     delete ui;
 }
 
 //  ---------------- 扫描/枚举 ----------------
-void DeviceManagementModule::scanHikVisionDevices()
-{
-    qDeleteAll(m_deviceList);
-    m_deviceList.clear();
-    ui->usb_listWidget->clear();
-    ui->gige_listWidget->clear();
-    MV_CC_DEVICE_INFO_LIST stDeviceList{};
-    int ret = CMvCamera::EnumDevices(MV_GIGE_DEVICE | MV_USB_DEVICE, &stDeviceList);
-    if (ret != MV_OK) {
-        emit statusChanged(tr("设备枚举失败: %1").arg(ret));
-        return;
-    }
+void DeviceManagementModule::onDeviceArrived(DeviceInfo* device)
+{
+    QListWidget* list = device->pHikInfo->nTLayerType == MV_USB_DEVICE ? ui->usb_listWidget
+                                                                       : ui->gige_listWidget;
+    QListWidgetItem* item = new QListWidgetItem(device->name, list);
+    item->setData(Qt::UserRole, device->key);
+    item->setToolTip(tr("序列号: %1\n地址: %2").arg(device->serialNumber, device->ipAddress));
+    emit statusChanged(tr("设备上线: %1").arg(device->name));
+}
 
-    for (unsigned int i = 0; i < stDeviceList.nDeviceNum; ++i) {
-        DeviceInfo* dev = new DeviceInfo;
-        dev->nIndex  = i;
-        dev->pHikInfo = stDeviceList.pDeviceInfo[i];
-
-        if (dev->pHikInfo->nTLayerType == MV_GIGE_DEVICE) {
-            MV_GIGE_DEVICE_INFO* gige = &dev->pHikInfo->SpecialInfo.stGigEInfo;
-            unsigned int ip = gige->nCurrentIp;
-            dev->ipAddress  = QString("%1.%2.%3.%4")
-                                 .arg((ip >> 24) & 0xFF).arg((ip >> 16) & 0xFF)
-                                 .arg((ip >> 8) & 0xFF).arg(ip & 0xFF);
-            dev->model      = QString::fromLocal8Bit((const char*)gige->chModelName);
-            dev->serialNumber = QString::fromLocal8Bit((const char*)gige->chSerialNumber);
-            dev->name       = tr("GigE相机: %1").arg(dev->model);
-            ui->gige_listWidget->addItem(dev->name);
-        } else if (dev->pHikInfo->nTLayerType == MV_USB_DEVICE) {
-            MV_USB3_DEVICE_INFO* usb = &dev->pHikInfo->SpecialInfo.stUsb3VInfo;
-            dev->model      = QString::fromLocal8Bit((const char*)usb->chModelName);
-            dev->serialNumber = QString::fromLocal8Bit((const char*)usb->chSerialNumber);
-            dev->name       = tr("USB相机: %1").arg(dev->model);
-            dev->ipAddress  = tr("USB连接");
-            ui->usb_listWidget->addItem(dev->name);
+void DeviceManagementModule::onDeviceRemoved(DeviceInfo* device)
+{
+    for (QListWidget* list : { ui->gige_listWidget, ui->usb_listWidget }) {
+        for (int row = list->count() - 1; row >= 0; --row) {
+            if (list->item(row)->data(Qt::UserRole).toString() == device->key)
+                delete list->takeItem(row);
         }
-        m_deviceList.append(dev);
     }
-    progressDialog->close();
-    emit statusChanged(tr("发现%1个设备").arg(m_deviceList.size()));
+    if (m_connectedDevice == device)        // 只会是未连接的选中设备
+        m_connectedDevice = nullptr;
+    emit statusChanged(tr("设备离线: %1").arg(device->name));
+}
 
+void DeviceManagementModule::onScanFinished(int deviceCount)
+{
+    ui->refreshButton->setEnabled(true);
+    if (m_scanRequested) {
+        m_scanRequested = false;
+        emit statusChanged(tr("发现%1个设备").arg(deviceCount));
+    }
+}
+
+void DeviceManagementModule::onDeviceSelected(QListWidgetItem* item)
+{
+    if (!item) return;
+    if (m_connectedDevice && m_connectedDevice->isConnected) {
+        emit statusChanged(tr("请先断开当前设备"));
+        return;
+    }
+    m_connectedDevice = m_enumerator->device(item->data(Qt::UserRole).toString());
 }
 
 //  ---------------- 连接/断开 ----------------
 bool DeviceManagementModule::connectHikVisionDevice(DeviceInfo* device)
 {
-    if (!device || !device->pHikInfo) return false;
+    if (!device || !device->pHikInfo || !device->camera) return false;
 
-    int ret = device->camera.Open(device->pHikInfo);
+    int ret = device->camera->Open(device->pHikInfo);
     if (ret != MV_OK) {
         emit statusChanged(tr("打开设备失败: %1").arg(ret));
         return false;
     }
 
-    // 千兆网相机设置包长
+    // 上次使用可能停在合并/区域模式，连接后先恢复全分辨率
+    m_sensorModeIndex = 0;
+    if (applySensorMode(device->camera.get(), m_sensorModes.first(), m_geometry) != MV_OK)
+        readStreamGeometry(device->camera.get(), m_geometry);
+    emit streamGeometryChanged(m_geometry);
+
+    // 千兆网相机在后台调优包长/包间延时/重传，并短时取流验证
     if (device->pHikInfo->nTLayerType == MV_GIGE_DEVICE) {
-        device->camera.SetIntValue("GevSCPSPacketSize", 1500);
+        startTransportTuning(device);
     }
     return true;
 }
 
+// 同一主机网口下的 GigE 相机按同时取流估算，平分链路带宽
+int DeviceManagementModule::camerasOnLink(const DeviceInfo* device) const
+{
+    if (!device || !device->pHikInfo || device->pHikInfo->nTLayerType != MV_GIGE_DEVICE) return 1;
+    const unsigned int netExport = device->pHikInfo->SpecialInfo.stGigEInfo.nNetExport;
+    int count = 0;
+    for (const DeviceInfo* other : m_enumerator->devices()) {
+        if (other->pHikInfo && other->pHikInfo->nTLayerType == MV_GIGE_DEVICE
+            && other->isSimulated == device->isSimulated
+            && other->pHikInfo->SpecialInfo.stGigEInfo.nNetExport == netExport)
+            ++count;
+    }
+    return qMax(1, count);
+}
+
+void DeviceManagementModule::startTransportTuning(DeviceInfo* device)
+{
+    stopTransportTuning();
+
+    TransportTuner::Options options;
+    options.camerasOnLink = camerasOnLink(device);
+    m_tuner = std::make_unique<TransportTuner>();
+    TransportTuner* tuner = m_tuner.get();
+    CMvCamera* camera = device->camera.get();
+    auto result = std::make_shared<TransportTuner::Result>();
+
+    QThread* thread = QThread::create([tuner, camera, options, result]() {
+        *result = tuner->tune(camera, options);
+    });
+    const int generation = ++m_tuningGeneration;
+    connect(thread, &QThread::finished, this, [this, generation, result]() {
+        if (generation != m_tuningGeneration) return;   // 已被断开连接中止，线程可能已回收
+        stopTransportTuning();
+        emit statusChanged(result->ok ? tr("传输参数已优化：%1").arg(result->summary())
+                                      : tr("传输参数优化失败：%1").arg(result->summary()));
+    });
+    m_tuningThread = thread;
+    ui->startPreviewButton->setEnabled(false);
+    emit statusChanged(tr("正在优化网络传输参数..."));
+    thread->start();
+}
+
+void DeviceManagementModule::stopTransportTuning()
+{
+    if (!m_tuningThread) return;
+    ++m_tuningGeneration;
+    m_tuner->abort();
+    m_tuningThread->wait();
+    delete m_tuningThread;
+    m_tuningThread = nullptr;
+    m_tuner.reset();
+    ui->startPreviewButton->setEnabled(true);
+}
+
 
 // ---------------- 断开hik工业摄像头链接 ----------------
 bool DeviceManagementModule::disconnectHikVisionDevice()
 {
     if (!m_connectedDevice) return true;
 
+    stopTransportTuning();
     stopStream();
-    m_connectedDevice->camera.Close();
+    delete m_nodeMap;                       // 等待进行中的参数批处理
+    m_nodeMap = nullptr;
+    m_connectedDevice->camera->Close();
 
     m_connectedDevice->isConnected = false;
     m_connectedDevice = nullptr;
+    m_geometry = StreamGeometry();
+    emit streamGeometryChanged(m_geometry);
+    ui->resolutionComboBox->setEnabled(false);
+    m_enumerator->rescan();                 // 断开期间离线的设备在此时移除
 
     ui->disconnectButton->setEnabled(false);
     ui->connectButton->setEnabled(true);
@@ -135,22 +275,59 @@ bool DeviceManagementModule::disconnectHikVisionDevice()
 }
 
 //  ---------------- 相机参数读取/设置 ----------------
-bool DeviceManagementModule::updateDeviceParameters()
+// 节点缓存：读写都在后台批处理，界面只读缓存
+void DeviceManagementModule::createNodeMap(DeviceInfo* device)
 {
-    if (!m_connectedDevice) return false;
-    CMvCamera& cam = m_connectedDevice->camera;
-
-    int ret = cam.SetIntValue("ExposureTime", ui->exposureSpinBox->value());
-    if (ret != MV_OK) { emit statusChanged(tr("设置曝光失败:%1").arg(ret)); return false; }
+    delete m_nodeMap;
+    m_nodeMap = new NodeMap(device->camera.get(), this);
+    // 声明顺序即写入顺序：先使能帧率控制，再写帧率，最后曝光和增益
+    m_nodeMap->declare("AcquisitionFrameRateEnable", NodeMap::Bool);
+    m_nodeMap->declare("AcquisitionFrameRate", NodeMap::Float, NodeMap::Dependent);
+    m_nodeMap->declare("ExposureTime", NodeMap::Float, NodeMap::Dependent);
+    m_nodeMap->declare("Gain", NodeMap::Float);
+    m_nodeMap->declare("ResultingFrameRate", NodeMap::Float, NodeMap::Volatile);
+    connect(m_nodeMap, &NodeMap::applied, this, &DeviceManagementModule::onParametersApplied);
+    connect(m_nodeMap, &NodeMap::refreshed, this, &DeviceManagementModule::onNodesRefreshed);
+    m_nodeMap->refresh(true);
+}
 
-    ret = cam.SetIntValue("Gain", ui->gainSpinBox->value());
-    if (ret != MV_OK) { emit statusChanged(tr("设置增益失败:%1").arg(ret)); return false; }
+bool DeviceManagementModule::updateDeviceParameters()
+{
+    if (!m_connectedDevice || !m_nodeMap) return false;
+
+    stopAutoExposure();                     // 手动设置优先
+    m_nodeMap->set("AcquisitionFrameRateEnable", 1);
+    m_nodeMap->set("AcquisitionFrameRate", ui->fpsSpinBox->value());
+    m_nodeMap->set("ExposureTime", ui->exposureSpinBox->value());
+    m_nodeMap->set("Gain", ui->gainSpinBox->value());
+    m_nodeMap->apply();
+    return true;
+}
 
-    ret = cam.SetFloatValue("AcquisitionFrameRate", ui->fpsSpinBox->value());
-    if (ret != MV_OK) { emit statusChanged(tr("设置帧率失败:%1").arg(ret)); return false; }
+void DeviceManagementModule::onParametersApplied(int written, const QStringList& errors, qint64 elapsedUs)
+{
+    if (!errors.isEmpty()) {
+        emit statusChanged(tr("部分参数设置失败: %1").arg(errors.join(", ")));
+        return;
+    }
+    if (m_exposureController->isRunning()) return;     // 自动曝光的写入只在收敛时报告
+    emit statusChanged(tr("设备参数已更新（写入 %1 项，%2 ms）").arg(written).arg(elapsedUs / 1000.0, 0, 'f', 1));
+}
 
-    emit statusChanged(tr("设备参数已更新"));
-    return true;
+void DeviceManagementModule::onNodesRefreshed()
+{
+    if (!m_nodeMap) return;
+    // 输入范围跟随节点范围（曝光改变后帧率上限也会变）
+    auto show = [this](const QString& name, QSpinBox* box) {
+        const NodeMap::Node node = m_nodeMap->node(name);
+        if (!node.available) return;
+        if (node.max > node.min)
+            box->setRange(qCeil(node.min), qFloor(node.max));
+        box->setValue(qRound(node.value));
+    };
+    show("ExposureTime", ui->exposureSpinBox);
+    show("Gain", ui->gainSpinBox);
+    show("AcquisitionFrameRate", ui->fpsSpinBox);
 }
 
 void DeviceManagementModule::displayDeviceInfo(DeviceInfo* device)
@@ -159,18 +336,7 @@ void DeviceManagementModule::displayDeviceInfo(DeviceInfo* device)
     // UI 展示同上，略
 
     if (device->isConnected) {
-        CMvCamera& cam = device->camera;
-        MVCC_INTVALUE_EX vInt = {};
-        MVCC_FLOATVALUE vFlt = {};
-
-        if (cam.GetIntValue("ExposureTime", &vInt) == MV_OK)
-            ui->exposureSpinBox->setValue(vInt.nCurValue);
-
-        if (cam.GetIntValue("Gain", &vInt) == MV_OK)
-            ui->gainSpinBox->setValue(vInt.nCurValue);
-
-        if (cam.GetFloatValue("AcquisitionFrameRate", &vFlt) == MV_OK)
-            ui->fpsSpinBox->setValue((int)vFlt.fCurValue);
+        onNodesRefreshed();     // 参数取自节点缓存，首次回读完成后会再刷新一次
 
         ui->id_value->setText(QString::number(device->nIndex));
         ui->name_value->setText(device->name);
@@ -184,13 +350,25 @@ void DeviceManagementModule::displayDeviceInfo(DeviceInfo* device)
 bool DeviceManagementModule::startStream()
 {
     if (!m_connectedDevice || m_isStreaming) return false;
-    int ret = m_connectedDevice->camera.StartGrabbing();
+    if (m_tuningThread) {
+        emit statusChanged(tr("正在优化网络传输参数，请稍候"));
+        return false;
+    }
+    int ret = m_connectedDevice->camera->StartGrabbing();
     if (ret != MV_OK) {
         emit statusChanged(tr("启动流失败:%1").arg(ret));
         return false;
     }
+    if (!m_engine->start(m_connectedDevice->camera.get(), m_connectedDevice->nIndex)) {
+        m_connectedDevice->camera->StopGrabbing();
+        emit statusChanged(tr("启动采集线程失败"));
+        return false;
+    }
     m_isStreaming = true;
-    m_frameTimer->start(30);
+    m_telemetryTimer->start();
+    ui->exportTelemetryButton->setEnabled(true);
+    ui->recordButton->setEnabled(true);
+    ui->autoExposureButton->setEnabled(true);
     emit statusChanged(tr("视频流已启动"));
     return true;
 }
@@ -198,66 +376,43 @@ bool DeviceManagementModule::startStream()
 bool DeviceManagementModule::stopStream()
 {
     if (!m_connectedDevice || !m_isStreaming) return true;
-    m_frameTimer->stop();
-    m_connectedDevice->camera.StopGrabbing();
+    stopRecording();                             // 录制、自动采集和渲染都是帧队列的消费者，先于采集停止
+    stopAutoCapture();
+    stopOverlay();
+    stopAutoExposure();
+    m_history.stop();
+    m_previewRenderer->stop();
+    m_engine->stop(m_connectedDevice->nIndex);   // 先停抓图线程再停 SDK 取流
+    m_connectedDevice->camera->StopGrabbing();
+    m_telemetryTimer->stop();
+    updateTelemetryPanel();                      // 保留最后一次统计，仍可导出
     m_isStreaming = false;
+    ui->recordButton->setEnabled(false);
+    ui->autoExposureButton->setEnabled(false);
     emit statusChanged(tr("视频流已停止"));
     return true;
 }
 
-// 更新视频帧
-void DeviceManagementModule::updateFrame()
-{
-    if (!m_connectedDevice || !m_isStreaming) return;
-
-    cv::Mat frame;
-    if (grabImage(frame) && !frame.empty()) {
-        // Mat -> QImage
-        QImage qimg(frame.data, frame.cols, frame.rows,
-                    frame.step, QImage::Format_Grayscale8);
-        emit newFrameReceived(qimg.copy());
-    }
-}
-
-bool DeviceManagementModule::grabImage(cv::Mat& frame)
+// 取最新一帧：由采集线程持续更新，这里不再阻塞等待 SDK
+bool DeviceManagementModule::grabImage(cv::Mat& frame, FrameMeta* meta)
 {
     if (!m_connectedDevice || !m_isStreaming) return false;
 
-    CMvCamera& cam = m_connectedDevice->camera;
-    MV_FRAME_OUT frameOut{};
-    int ret = cam.GetImageBuffer(&frameOut, 1000);
-    if (ret != MV_OK) return false;
-
-    // 构造 cv::Mat（浅拷贝）
-    cv::Mat raw(frameOut.stFrameInfo.nHeight,
-                frameOut.stFrameInfo.nWidth,
-                CV_8UC1, frameOut.pBufAddr);
-
-    raw.copyTo(frame);              // 深拷贝到外部
-    cam.FreeImageBuffer(&frameOut); // 归还 SDK 缓存
+    AcquiredFrame latest;
+    if (!m_engine->latestFrame(m_connectedDevice->nIndex, latest)) return false;
+    latest.image.copyTo(frame);     // 采集帧需长期保存，拷出后缓存槽即可归还
+    if (meta && !latest.buffer.isNull()) *meta = latest.buffer.meta();
     return true;
 }
 
 
-/*-------------------------------- 工具函数 --------------------------------*/
-
-QImage DeviceManagementModule::cvMatToQImage(const cv::Mat& mat)
-{
-    if (mat.type() == CV_8UC1)
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_Grayscale8).copy();
-    if (mat.type() == CV_8UC3) {
-        cv::Mat rgb; cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        return QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
-    }
-    return QImage();
-}
 // =============槽函数==========================
 void DeviceManagementModule::onRefreshButtonClicked()
 {
-    progressDialog->setWindowModality(Qt::WindowModal);
-    progressDialog->setCancelButton(nullptr);
-    progressDialog->show();
-    scanHikVisionDevices();
+    // 扫描在后台进行，完成前只禁用刷新按钮
+    ui->refreshButton->setEnabled(false);
+    m_scanRequested = true;
+    m_enumerator->rescan();
 }
 
 void DeviceManagementModule::onConnectButtonClicked()
@@ -268,6 +423,12 @@ void DeviceManagementModule::onConnectButtonClicked()
     }
     if (connectHikVisionDevice(m_connectedDevice)) {
         m_connectedDevice->isConnected = true;
+        createNodeMap(m_connectedDevice);
+        {
+            const QSignalBlocker blocker(ui->resolutionComboBox);
+            ui->resolutionComboBox->setCurrentIndex(m_sensorModeIndex);
+        }
+        ui->resolutionComboBox->setEnabled(true);
         ui->connectButton->setEnabled(false);
         ui->disconnectButton->setEnabled(true);
         displayDeviceInfo(m_connectedDevice);
@@ -299,39 +460,320 @@ void DeviceManagementModule::onStartPreviewClicked()
         QMessageBox::warning(this, tr("警告"), tr("请先在设备管理模块连接相机"));
         return;
     }
+    if (!m_isStreaming && !startStream()) return;
+    m_previewRenderer->setTargetSize(ui->cam1->targetSize());
+    if (!m_previewRenderer->isRunning()
+        && !m_previewRenderer->start(m_engine->frameRing(m_connectedDevice->nIndex),
+                                     m_engine->telemetry(m_connectedDevice->nIndex))) {
+        emit statusChanged(tr("启动预览线程失败"));
+        return;
+    }
+    if (!m_history.isRunning() && !m_history.start(m_engine->frameRing(m_connectedDevice->nIndex)))
+        emit statusChanged(tr("启动预触发历史失败，采集将使用最新一帧"));
     m_isPreviewing = true;
-    m_previewTimer->start();
     ui->startPreviewButton->setEnabled(false);
     ui->stopPreviewButton->setEnabled(true);
     ui->captureImageButton->setEnabled(true);
+    ui->autoCaptureButton->setEnabled(true);
+    ui->overlayButton->setEnabled(true);
     emit statusChanged(tr("预览已启动"));
 }
 
-void DeviceManagementModule::autoCaptureImage()
+void DeviceManagementModule::updateCaptureSetting(const AppSettings& settings)
+{
+    m_boardSize = cv::Size(settings.defaultBoardWidth, settings.defaultBoardHeight);
+}
+
+// 自动采集：每帧检测棋盘格、评估清晰度和位姿新颖度，只保留三项都通过的帧
+void DeviceManagementModule::onAutoCaptureToggled(bool checked)
+{
+    if (!checked) {
+        stopAutoCapture();
+        return;
+    }
+    if (m_isAutoCapturing) return;
+    if (!m_isPreviewing || !m_connectedDevice) {
+        ui->autoCaptureButton->setChecked(false);
+        return;
+    }
+    if (!startAutoCapture(true)) {      // 每次手动启动重新累计位姿
+        ui->autoCaptureButton->setChecked(false);
+        emit statusChanged(tr("启动自动采集失败"));
+        return;
+    }
+    emit statusChanged(tr("自动采集已启动：标定板 %1x%2").arg(m_boardSize.width).arg(m_boardSize.height));
+}
+
+bool DeviceManagementModule::startAutoCapture(bool clearPoses)
+{
+    CaptureGate::Options options;
+    options.boardSize = m_boardSize;
+    if (clearPoses)
+        m_captureGate->clearPoses();
+    if (!m_captureGate->start(m_engine->frameRing(m_connectedDevice->nIndex), options))
+        return false;
+    m_isAutoCapturing = true;
+    return true;
+}
+
+void DeviceManagementModule::onAutoCaptureAccepted(const CaptureGate::Candidate& candidate)
+{
+    if (!m_isAutoCapturing) return;
+
+    CalibrationData data;
+    data.frame      = DatasetStore::resident(candidate.image);     // 门限线程已拷贝
+    data.timestamp  = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    data.geometry   = m_geometry;           // 保持取流几何，标定时角点换算到全分辨率
+    data.setAcquisition(candidate.meta);
+    m_calibrationData.append(data);
+    emit statusChanged(tr("自动采集图像 %1：清晰度 %2，新颖度 %3")
+                           .arg(m_calibrationData.size())
+                           .arg(candidate.score.sharpness, 0, 'f', 2)
+                           .arg(candidate.score.novelty, 0, 'f', 2));
+}
+
+void DeviceManagementModule::stopAutoCapture()
 {
-    onCaptureImageClicked();
+    if (!m_isAutoCapturing) return;
+    m_isAutoCapturing = false;
+    m_captureGate->stop();
+    {
+        const QSignalBlocker blocker(ui->autoCaptureButton);
+        ui->autoCaptureButton->setChecked(false);
+    }
+    const CaptureGate::Stats s = m_captureGate->stats();
+    emit statusChanged(tr("自动采集结束：评估 %1 帧，保留 %2，无标定板 %3，模糊 %4，重复位姿 %5 (%6 ms/帧)")
+                           .arg(s.evaluated).arg(s.accepted).arg(s.noBoard).arg(s.blurred)
+                           .arg(s.duplicate).arg(s.avgEvalMs, 0, 'f', 1));
 }
 
 void DeviceManagementModule::onCaptureImageClicked()
 {
     cv::Mat frame;
-    if (!grabImage(frame) || frame.empty()) {
+    FrameMeta meta;
+    StreamGeometry geometry = m_geometry;
+    const bool reduced = m_geometry.isValid() && !m_geometry.isFullSensor();
+    // 全分辨率取流时从预触发历史中挑选板稳定、最清晰的一帧；降采样模式下历史帧不是全分辨率
+    FrameHistory::Selection selection;
+    const bool fromHistory = !reduced && m_history.isRunning() && m_history.select(m_boardSize, selection);
+    bool ok = true;
+    if (fromHistory) {
+        frame = selection.image;
+        meta  = selection.meta;
+    } else {
+        ok = reduced ? grabFullResolution(frame, geometry, &meta) : grabImage(frame, &meta);
+    }
+    if (!ok || frame.empty()) {
         QMessageBox::warning(this, tr("警告"), tr("无法获取图像帧"));
         return;
     }
     CalibrationData data;
-    data.image      = frame.clone();
-    data.qImage     = cvMatToQImage(frame);
+    data.frame      = DatasetStore::resident(frame);   // 以上各路径得到的都已是拷贝
     data.timestamp  = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    data.geometry   = geometry;
+    data.setAcquisition(meta);
 
     m_calibrationData.append(data);
     // updateDataList();
     // ui->deleteImageButton->setEnabled(true);
     // ui->clearAllButton->setEnabled(true);
     // ui->saveImagesButton->setEnabled(true);
-    emit statusChanged(tr("已采集图像 %1").arg(m_calibrationData.size()));
+    if (!fromHistory) {
+        emit statusChanged(tr("已采集图像 %1").arg(m_calibrationData.size()));
+    } else if (selection.found) {
+        emit statusChanged(tr("已采集图像 %1：历史 %2 帧中选出 %3 ms 前的一帧，清晰度 %4，板%5（位移 %6 px），挑选 %7 ms")
+                               .arg(m_calibrationData.size()).arg(selection.window).arg(selection.ageMs)
+                               .arg(selection.sharpness, 0, 'f', 2)
+                               .arg(selection.stable ? tr("稳定") : tr("晃动"))
+                               .arg(selection.motionPx, 0, 'f', 1).arg(selection.selectMs, 0, 'f', 0));
+    } else {
+        emit statusChanged(tr("已采集图像 %1：历史 %2 帧中未检测到标定板，取画面最清晰的一帧")
+                               .arg(m_calibrationData.size()).arg(selection.window));
+    }
+}
+
+
+// 棋盘格叠加：跟踪线程与预览渲染各自取最新帧，检测慢时只降低叠加刷新率
+void DeviceManagementModule::onOverlayToggled(bool checked)
+{
+    if (!checked) {
+        stopOverlay();
+        return;
+    }
+    if (m_boardTracker->isRunning()) return;
+    BoardTracker::Options options;
+    options.boardSize = m_boardSize;
+    if (!m_isPreviewing || !m_connectedDevice
+        || !m_boardTracker->start(m_engine->frameRing(m_connectedDevice->nIndex), options)) {
+        const QSignalBlocker blocker(ui->overlayButton);
+        ui->overlayButton->setChecked(false);
+    }
+}
+
+void DeviceManagementModule::onBoardOverlay(const BoardTracker::Overlay& overlay)
+{
+    if (!m_boardTracker->isRunning()) return;   // 停止后仍在队列中的结果
+    if (overlay.found)
+        ui->cam1->setOverlay(overlay.corners, overlay.boardSize.width);
+    else
+        ui->cam1->clearOverlay();
+
+    // 自动曝光按标定板区域测光
+    QRectF region;
+    if (overlay.found) {
+        QPolygonF polygon(overlay.corners);
+        region = polygon.boundingRect();
+    }
+    m_exposureController->setBoardRegion(region);
+}
+
+// 自动曝光：按最新帧的画面统计调节曝光和增益，棋盘格叠加开启时按板内亮度测光
+void DeviceManagementModule::onAutoExposureToggled(bool checked)
+{
+    if (!checked) {
+        stopAutoExposure();
+        return;
+    }
+    if (m_exposureController->isRunning()) return;
+    if (!m_isStreaming || !m_connectedDevice
+        || !m_exposureController->start(m_nodeMap, m_connectedDevice->nIndex)) {
+        const QSignalBlocker blocker(ui->autoExposureButton);
+        ui->autoExposureButton->setChecked(false);
+        emit statusChanged(tr("无法启动自动曝光"));
+        return;
+    }
+    emit statusChanged(tr("自动曝光已启动"));
+}
+
+void DeviceManagementModule::onAutoExposureConverged(qint64 elapsedMs, int writes)
+{
+    const ExposureController::Stats s = m_exposureController->stats();
+    emit statusChanged(tr("自动曝光收敛：%1 ms，写入 %2 次，曝光 %3 us，增益 %4 dB")
+                           .arg(elapsedMs).arg(writes)
+                           .arg(s.exposureUs, 0, 'f', 0).arg(s.gainDb, 0, 'f', 1));
+}
+
+void DeviceManagementModule::stopAutoExposure()
+{
+    if (!m_exposureController->isRunning()) return;
+    m_exposureController->stop();
+    {
+        const QSignalBlocker blocker(ui->autoExposureButton);
+        ui->autoExposureButton->setChecked(false);
+    }
+    const ExposureController::Stats s = m_exposureController->stats();
+    emit statusChanged(tr("自动曝光已停止：写入 %1 批 (%2 项)，收敛 %3 次")
+                           .arg(s.writes).arg(s.nodeWrites).arg(s.convergences));
+}
+
+void DeviceManagementModule::stopOverlay()
+{
+    if (!m_boardTracker->isRunning()) return;
+    const BoardTracker::Stats s = m_boardTracker->stats();
+    m_boardTracker->stop();
+    ui->cam1->clearOverlay();
+    {
+        const QSignalBlocker blocker(ui->overlayButton);
+        ui->overlayButton->setChecked(false);
+    }
+    emit statusChanged(tr("棋盘格叠加结束：检测 %1 帧 (%2 fps)，检出 %3，区域预测命中 %4，%5 ms/帧")
+                           .arg(s.processed).arg(s.fps, 0, 'f', 1).arg(s.found).arg(s.tracked)
+                           .arg(s.avgDetectMs, 0, 'f', 1));
+}
+
+// 采集模式：预览/检测用区域或合并模式提高帧率，切换时需停流写节点
+void DeviceManagementModule::onSensorModeChanged(int index)
+{
+    if (index < 0 || index >= m_sensorModes.size() || index == m_sensorModeIndex) return;
+    if (!m_connectedDevice || m_tuningThread || m_recorder->isRecording()) {
+        const QSignalBlocker blocker(ui->resolutionComboBox);
+        ui->resolutionComboBox->setCurrentIndex(m_sensorModeIndex);
+        emit statusChanged(tr("录制或传输调优期间不能切换采集模式"));
+        return;
+    }
+
+    const bool wasPreviewing = m_isPreviewing;
+    const LiveFeatures features = liveFeatures();
+    const bool ok = switchSensorMode(m_sensorModes[index]);
+    if (ok) {
+        m_sensorModeIndex = index;
+    } else {
+        switchSensorMode(m_sensorModes[m_sensorModeIndex]);
+        const QSignalBlocker blocker(ui->resolutionComboBox);
+        ui->resolutionComboBox->setCurrentIndex(m_sensorModeIndex);
+    }
+    if (wasPreviewing) onStartPreviewClicked();
+    resumeLiveFeatures(features);
+    if (ok)
+        emit statusChanged(tr("采集模式: %1 (%2)").arg(m_sensorModes[index].name).arg(m_geometry.describe()));
+}
+
+// 停流后写入模式节点，原先在取流则重新取流；预览由调用方恢复
+bool DeviceManagementModule::switchSensorMode(const SensorMode& mode)
+{
+    if (!m_connectedDevice) return false;
+    const bool wasStreaming = m_isStreaming;
+    stopPreview();
+    stopStream();
+
+    CMvCamera* camera = m_connectedDevice->camera.get();
+    const int ret = applySensorMode(camera, mode, m_geometry);
+    if (ret != MV_OK) {
+        readStreamGeometry(camera, m_geometry);
+        emit statusChanged(tr("切换采集模式失败: %1").arg(ret));
+    }
+    emit streamGeometryChanged(m_geometry);
+    if (wasStreaming) startStream();
+    return ret == MV_OK;
 }
 
+// 降采样模式下手动采集：临时切回全分辨率取一帧，再恢复原模式和预览
+bool DeviceManagementModule::grabFullResolution(cv::Mat& frame, StreamGeometry& geometry, FrameMeta* meta)
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool wasPreviewing = m_isPreviewing;
+    const LiveFeatures features = liveFeatures();
+    bool ok = switchSensorMode(SensorMode::fullSensor()) && m_isStreaming;
+    if (ok) {
+        // 新取流的序号从 1 开始，等到第一帧即可
+        AcquiredFrame latest;
+        ok = m_engine->waitForFrame(m_connectedDevice->nIndex, 0, latest, FULL_RESOLUTION_FRAME_TIMEOUT_MS);
+        if (ok) {
+            latest.image.copyTo(frame);
+            geometry = m_geometry;
+            if (meta && !latest.buffer.isNull()) *meta = latest.buffer.meta();
+        }
+    }
+    switchSensorMode(m_sensorModes[m_sensorModeIndex]);
+    if (wasPreviewing) onStartPreviewClicked();
+    resumeLiveFeatures(features);
+    QApplication::restoreOverrideCursor();
+    return ok;
+}
+
+DeviceManagementModule::LiveFeatures DeviceManagementModule::liveFeatures() const
+{
+    LiveFeatures features;
+    features.autoCapture  = m_isAutoCapturing;
+    features.overlay      = m_boardTracker->isRunning();
+    features.autoExposure = m_exposureController->isRunning();
+    return features;
+}
+
+// 按钮的 toggled 槽负责启动；自动采集保留已累计的位姿，模式切换前后采集的帧仍按同一组位姿去重
+void DeviceManagementModule::resumeLiveFeatures(const LiveFeatures& features)
+{
+    if (features.autoExposure && m_isStreaming)
+        ui->autoExposureButton->setChecked(true);
+    if (features.overlay && m_isPreviewing)
+        ui->overlayButton->setChecked(true);
+    if (features.autoCapture && m_isPreviewing && !m_isAutoCapturing) {
+        const bool ok = startAutoCapture(false);
+        const QSignalBlocker blocker(ui->autoCaptureButton);
+        ui->autoCaptureButton->setChecked(ok);
+        if (!ok) emit statusChanged(tr("切换采集模式后无法恢复自动采集"));
+    }
+}
 
 void DeviceManagementModule::onStopPreviewClicked() { stopPreview(); }
 
@@ -339,27 +781,153 @@ void DeviceManagementModule::stopPreview()
 {
     if (!m_isPreviewing) return;
     m_isPreviewing = false;
-    m_previewTimer->stop();
-    if (m_isAutoCapturing) {
-        m_isAutoCapturing = false;
-        m_autoCaptureTimer->stop();
-
-    }
+    stopAutoCapture();
+    stopOverlay();
+    m_history.stop();
+    // 预览开销：渲染线程的缩放耗时占比即预览的 CPU 预算
+    const PreviewRenderer::Stats stats = m_previewRenderer->stats();
+    m_previewRenderer->stop();
+    ui->cam1->clearFrame();
     ui->cam1->setText(tr("预览已停止"));
     ui->startPreviewButton->setEnabled(true);
     ui->stopPreviewButton->setEnabled(false);
     ui->captureImageButton->setEnabled(false);
-    emit statusChanged(tr("预览已停止"));
+    ui->autoCaptureButton->setEnabled(false);
+    ui->overlayButton->setEnabled(false);
+    emit statusChanged(tr("预览已停止：显示 %1 帧 (%2 fps)，跳过 %3 帧，缩放 %4 ms/帧，渲染线程占用 %5%")
+                           .arg(stats.rendered).arg(stats.displayFps, 0, 'f', 1).arg(stats.skipped)
+                           .arg(stats.avgRenderMs, 0, 'f', 2).arg(stats.renderLoad, 0, 'f', 1));
 }
 
 
-void DeviceManagementModule::onUpdateFrame()
+// 渲染器输出已是控件尺寸，直接交给预览控件绘制，不再转换和缩放
+void DeviceManagementModule::onPreviewFrame(const QImage& image, qint64 hostTimestamp)
 {
-    cv::Mat frame;
-    if (!grabImage(frame) || frame.empty()) return;
-    QImage img = cvMatToQImage(frame);
-    ui->cam1->setPixmap(QPixmap::fromImage(img)
-                                    .scaled(ui->cam1->size(),
-                                            Qt::KeepAspectRatio,
-                                            Qt::SmoothTransformation));
+    if (m_isPreviewing)
+        ui->cam1->setFrame(image);
+    m_previewRenderer->frameDisplayed(hostTimestamp);
+    emit newFrameReceived(image);
+}
+
+// 采集统计：帧号跳变对照链路丢包/丢帧和本地丢弃，判断丢帧发生在网络、SDK 还是本程序
+void DeviceManagementModule::updateTelemetryPanel()
+{
+    if (!m_connectedDevice) return;
+    std::shared_ptr<StreamTelemetry> telemetry = m_engine->telemetry(m_connectedDevice->nIndex);
+    if (!telemetry) return;
+
+    const StreamTelemetry::Summary s = telemetry->summary();
+    QStringList lines;
+    lines << tr("帧数: %1    帧率: %2 fps").arg(s.frames).arg(s.fps, 0, 'f', 1);
+    lines << tr("帧号跳变: %1 次, 缺失 %2 帧 (本地丢弃 %3)")
+                 .arg(s.gapEvents).arg(s.missingFrames).arg(s.localDrops);
+    lines << tr("帧内丢包: %1").arg(s.lostPackets);
+    if (m_geometry.isValid())
+        lines << tr("采集模式: %1 (全分辨率 %2x%3)")
+                     .arg(m_geometry.describe()).arg(m_geometry.sensorWidth).arg(m_geometry.sensorHeight);
+    AcquiredFrame latest;
+    if (m_isStreaming && m_engine->latestFrame(m_connectedDevice->nIndex, latest)
+        && latest.buffer.meta().analytics.valid) {
+        const FrameAnalytics& a = latest.buffer.meta().analytics;
+        lines << tr("画面: 均值 %1, 清晰度 %2, 过曝 %3%, 欠曝 %4%, 5%/95% 分位 %5/%6")
+                     .arg(a.mean, 0, 'f', 1).arg(a.sharpness, 0, 'f', 1)
+                     .arg(a.saturatedFraction * 100, 0, 'f', 2).arg(a.blackFraction * 100, 0, 'f', 2)
+                     .arg(a.percentile(0.05)).arg(a.percentile(0.95));
+    }
+    if (s.link.valid && s.link.gige) {
+        lines << tr("链路(GigE): 接收 %1 MB, %2 帧, 丢帧 %3, 丢包 %4, 重发请求 %5, 重发 %6")
+                     .arg(s.link.receivedBytes / 1048576.0, 0, 'f', 1).arg(s.link.receivedFrames)
+                     .arg(s.link.lostFrames).arg(s.link.lostPackets)
+                     .arg(s.link.resendRequests).arg(s.link.resends);
+    } else if (s.link.valid) {
+        lines << tr("链路(U3V): 接收 %1 MB, %2 帧, 错误帧 %3")
+                     .arg(s.link.receivedBytes / 1048576.0, 0, 'f', 1).arg(s.link.receivedFrames)
+                     .arg(s.link.errorFrames);
+    }
+    lines << tr("阶段          次数    p50/p90/p99/max (ms)");
+    for (int i = 0; i < StreamTelemetry::StageCount; ++i) {
+        const LatencyHistogram::Snapshot& h = s.stages[i];
+        if (h.count == 0) continue;
+        lines << QString("%1  %2    %3/%4/%5/%6")
+                     .arg(StreamTelemetry::stageName(StreamTelemetry::Stage(i)), -10).arg(h.count, 6)
+                     .arg(h.p50 / 1000.0, 0, 'f', 2).arg(h.p90 / 1000.0, 0, 'f', 2)
+                     .arg(h.p99 / 1000.0, 0, 'f', 2).arg(h.max / 1000.0, 0, 'f', 2);
+    }
+    if (m_exposureController->isRunning()) {
+        const ExposureController::Stats e = m_exposureController->stats();
+        lines << tr("自动曝光: %1, 曝光 %2 us, 增益 %3 dB, 亮度 %4/%5 (%6), 写入 %7 批, 上次收敛 %8 ms")
+                     .arg(e.converged ? tr("已收敛") : tr("调节中"))
+                     .arg(e.exposureUs, 0, 'f', 0).arg(e.gainDb, 0, 'f', 1)
+                     .arg(e.brightness, 0, 'f', 0).arg(e.target, 0, 'f', 0)
+                     .arg(e.boardMetered ? tr("标定板") : tr("全帧"))
+                     .arg(e.writes).arg(e.lastConvergenceMs);
+    }
+    if (m_history.isRunning()) {
+        const FrameHistory::Stats h = m_history.stats();
+        lines << tr("预触发历史: %1/%2 帧, %3 ms, 缓存 %4 MB, 丢帧 %5")
+                     .arg(h.frames).arg(h.capacity).arg(h.spanMs, 0, 'f', 0)
+                     .arg(h.bytes / 1048576.0, 0, 'f', 0).arg(h.dropped);
+    }
+    if (m_recorder->isRecording()) {
+        const StreamRecorder::Stats r = m_recorder->stats();
+        lines << tr("录制: %1 帧, %2 MB, 丢帧 %3, 写盘 %4 MB/s, 待写块 %5 (峰值 %6), 等待 %7 次")
+                     .arg(r.framesWritten).arg(r.bytesWritten / 1048576.0, 0, 'f', 1).arg(r.framesDropped)
+                     .arg(r.writeMBps, 0, 'f', 1).arg(r.queuedChunks).arg(r.maxQueuedChunks).arg(r.stalls);
+    }
+    ui->telemetryText->setPlainText(lines.join('\n'));
+}
+
+// 录制原始帧：不经像素格式转换，写满采集速率，事后再挑选标定帧
+void DeviceManagementModule::onRecordClicked()
+{
+    if (m_recorder->isRecording()) {
+        stopRecording();
+        return;
+    }
+    if (!m_connectedDevice || !m_isStreaming) return;
+
+    const QString defaultName = QString("record_%1_%2.uwcraw")
+                                    .arg(m_connectedDevice->serialNumber)
+                                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    const QString path = QFileDialog::getSaveFileName(this, tr("录制原始帧"), defaultName, tr("原始帧容器 (*.uwcraw)"));
+    if (path.isEmpty() || !m_isStreaming) return;
+
+    StreamRecorder::Options options;
+    options.device = QString("%1 %2").arg(m_connectedDevice->model, m_connectedDevice->serialNumber);
+    if (!m_recorder->start(m_engine->rawFrameRing(m_connectedDevice->nIndex), path, options)) {
+        QMessageBox::warning(this, tr("警告"), tr("无法开始录制: %1").arg(path));
+        return;
+    }
+    ui->recordButton->setText(tr("⏹停止录制"));
+    emit statusChanged(tr("开始录制: %1").arg(path));
+}
+
+void DeviceManagementModule::stopRecording()
+{
+    if (!m_recorder->isRecording()) return;
+    const QString path = m_recorder->dataPath();
+    m_recorder->stop();     // 写完缓存的数据后返回
+    const StreamRecorder::Stats r = m_recorder->stats();
+    ui->recordButton->setText(tr("⏺开始录制"));
+    emit statusChanged(tr("录制结束: %1 帧, %2 MB, 丢帧 %3 (%4)")
+                           .arg(r.framesWritten).arg(r.bytesWritten / 1048576.0, 0, 'f', 1)
+                           .arg(r.framesDropped).arg(path));
+}
+
+void DeviceManagementModule::onExportTelemetryClicked()
+{
+    if (!m_connectedDevice) return;
+    std::shared_ptr<StreamTelemetry> telemetry = m_engine->telemetry(m_connectedDevice->nIndex);
+    if (!telemetry) return;
+
+    const QString defaultName = QString("telemetry_%1_%2.csv")
+                                    .arg(m_connectedDevice->serialNumber)
+                                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    const QString path = QFileDialog::getSaveFileName(this, tr("导出采集日志"), defaultName, tr("CSV 文件 (*.csv)"));
+    if (path.isEmpty()) return;
+
+    if (telemetry->exportCsv(path))
+        emit statusChanged(tr("采集日志已导出: %1").arg(path));
+    else
+        QMessageBox::warning(this, tr("警告"), tr("无法写入文件: %1").arg(path));
 }
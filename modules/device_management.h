@@ -5,29 +5,27 @@
 #include <QList>
 #include <QDateTime>
 #include <opencv2/opencv.hpp>
-#include <QProgressDialog>
 #include "cmvcamera.h"          // 新增
+#include "acquisition_engine.h"
+#include "preview_renderer.h"
+#include "device_enumerator.h"
+#include "transport_tuner.h"
+#include "node_map.h"
+#include "stream_recorder.h"
+#include "capture_gate.h"
+#include "frame_history.h"
+#include "board_tracker.h"
+#include "exposure_controller.h"
+#include "sensor_mode.h"
+#include "dataset_store.h"
+#include "settings.h"
+#include <memory>
 #include "ui_device_management.h"
 
 QT_BEGIN_NAMESPACE
 class QListWidgetItem;
 QT_END_NAMESPACE
 
-//设备信息
-struct DeviceInfo
-{
-    int         nIndex = -1;
-    QString     name;
-    QString     model;
-    QString     serialNumber;
-    QString     ipAddress;
-    bool        isConnected = false;
-
-    // SDK 相关
-    CMvCamera   camera;                   // 直接持有 CMvCamera 实例
-    MV_CC_DEVICE_INFO* pHikInfo = nullptr;
-};
-
 //设备配置
 struct DeviceConfig
 {
@@ -41,11 +39,30 @@ struct DeviceConfig
 };
 
 /* 标定数据结构体 */
+// 每帧只保存对数据集帧的引用：缩略图常驻，全分辨率像素（8/16 位灰度；设置中选择保留彩色原图时为 BGR）
+// 经数据集缓存按需读取，列表在各模块之间复制时不持有像素
 struct CalibrationData {
-    cv::Mat  image;         // 原始图像
-    QImage   qImage;        // Qt 图像格式
+    DatasetFramePtr frame;  // 像素来源（引用计数共享）
     QString  filename;      //文件名
     QString  timestamp;     // 采集时间
+    StreamGeometry geometry;        // 采集时的取流几何；无效表示全分辨率（如从文件加载）
+    // 采集参数（导出时写入 metadata.csv）；从图像文件加载的为 0
+    float    exposureTime = 0;      // us
+    float    gain = 0;              // dB
+    unsigned int pixelType = 0;     // 相机输出的 MvGvspPixelType
+
+    void setAcquisition(const FrameMeta& meta)
+    {
+        exposureTime = meta.exposureTime;
+        gain         = meta.gain;
+        pixelType    = meta.pixelType;
+    }
+
+    cv::Mat  image() const { return frame ? frame->image() : cv::Mat(); }
+    cv::Size imageSize() const { return frame ? frame->size() : cv::Size(); }
+    QImage   thumbnail() const { return frame ? frame->thumbnail() : QImage(); }
+    // 全分辨率像素的 QImage 视图，持有像素和帧的引用
+    QImage qImage() const;
 };
 
 class DeviceManagementModule : public QWidget
@@ -56,8 +73,10 @@ public:
     ~DeviceManagementModule();
 
     bool getConnectedDevice();
-    // 创建进度对话框
-    QProgressDialog* progressDialog = new QProgressDialog("Loading...", nullptr, 0, 0);
+    QList<DeviceInfo*> deviceList() const { return m_enumerator->devices(); }
+
+public slots:
+    void updateCaptureSetting(const AppSettings& settings);     //标定板规格（自动采集检测用）
 
 signals:
     //状态更改
@@ -68,41 +87,88 @@ signals:
     void deviceDisconnected();
     //收到新一帧图像
     void newFrameReceived(const QImage& img);
+    //取流几何改变（连接、断开、切换采集模式）
+    void streamGeometryChanged(const StreamGeometry& geometry);
 
 private slots:
     /* 以下所有槽函数保持原声明不变 */
     void onRefreshButtonClicked();          //刷新
+    void onDeviceArrived(DeviceInfo* device);   //设备上线
+    void onDeviceRemoved(DeviceInfo* device);   //设备离线
+    void onScanFinished(int deviceCount);   //扫描完成
+    void onDeviceSelected(QListWidgetItem* item);   //选中设备
     void onConnectButtonClicked();          //链接
     void onDisconnectButtonClicked();       //断开
     void onApplySettingsButtonClicked();    //应用设置参数
-    void updateFrame();                     //更新帧
-    void onUpdateFrame();
+    void onPreviewFrame(const QImage& image, qint64 hostTimestamp);   //更新预览帧
+    void updateTelemetryPanel();            //刷新采集统计
+    void onExportTelemetryClicked();        //导出采集日志
     void onStartPreviewClicked();           //预览
     void onStopPreviewClicked();            //停止预览
     void onCaptureImageClicked();           //捕获图像
+    void onRecordClicked();                 //开始/停止录制
+    void onAutoCaptureToggled(bool checked);    //开始/停止自动采集
+    void onAutoCaptureAccepted(const CaptureGate::Candidate& candidate);   //自动采集通过门限的帧
+    void onOverlayToggled(bool checked);    //开始/停止棋盘格叠加
+    void onBoardOverlay(const BoardTracker::Overlay& overlay);  //更新棋盘格叠加
+    void onAutoExposureToggled(bool checked);   //开始/停止自动曝光
+    void onAutoExposureConverged(qint64 elapsedMs, int writes); //自动曝光收敛
+    void onSensorModeChanged(int index);    //切换采集模式（区域/合并）
+    void onParametersApplied(int written, const QStringList& errors, qint64 elapsedUs);  //参数写入完成
+    void onNodesRefreshed();                //参数回读完成
 
 private:
     bool connectHikVisionDevice(DeviceInfo* device);
     bool disconnectHikVisionDevice();
     bool updateDeviceParameters();
+    void createNodeMap(DeviceInfo* device);
     bool startStream();
     bool stopStream();
-    bool grabImage(cv::Mat& frame);              // 改为 OpenCV Mat
-    void scanHikVisionDevices();
+    bool grabImage(cv::Mat& frame, FrameMeta* meta = nullptr);     // 改为 OpenCV Mat
     void refreshDeviceListUI();
     void displayDeviceInfo(DeviceInfo* device);
-    void autoCaptureImage();
-    QImage cvMatToQImage(const cv::Mat& mat);
+    bool startAutoCapture(bool clearPoses);
+    void stopAutoCapture();
+    void stopOverlay();
+    void stopAutoExposure();
+    bool switchSensorMode(const SensorMode& mode);
+    // 切换采集模式会停流：记录停流前开启的自动采集/叠加/自动曝光，恢复预览后重新启动
+    struct LiveFeatures {
+        bool autoCapture = false;
+        bool overlay = false;
+        bool autoExposure = false;
+    };
+    LiveFeatures liveFeatures() const;
+    void resumeLiveFeatures(const LiveFeatures& features);
+    bool grabFullResolution(cv::Mat& frame, StreamGeometry& geometry, FrameMeta* meta = nullptr);
     void stopPreview();
+    void stopRecording();
+    void startTransportTuning(DeviceInfo* device);
+    void stopTransportTuning();
+    int camerasOnLink(const DeviceInfo* device) const;
 
     Ui::DeviceManagementModule* ui;
-    QTimer* m_frameTimer;
-    QList<DeviceInfo*>  m_deviceList;
+    AcquisitionEngine* m_engine;            // 采集引擎（独立抓图线程）
+    PreviewRenderer* m_previewRenderer;     // 预览渲染（独立线程缩放到控件尺寸）
+    StreamRecorder* m_recorder;             // 原始帧录制（独立拷贝/写盘线程）
+    CaptureGate* m_captureGate;             // 自动采集质量门限（独立评估线程）
+    BoardTracker* m_boardTracker;           // 预览棋盘格叠加（独立跟踪线程）
+    ExposureController* m_exposureController;   // 软件自动曝光/增益
+    FrameHistory m_history;                 // 预触发历史（手动采集时从中挑选）
+    cv::Size m_boardSize = cv::Size(9, 6);  // 标定板内角点数
+    QList<SensorMode> m_sensorModes;        // 采集模式（预览/检测用），采集图像始终用全分辨率
+    int m_sensorModeIndex = 0;
+    StreamGeometry m_geometry;              // 当前取流几何
+    DeviceEnumerator* m_enumerator;         // 后台枚举 + 设备注册表（拥有 DeviceInfo）
     QList<DeviceConfig*> m_configList;
-    DeviceInfo*          m_connectedDevice;
+    DeviceInfo*          m_connectedDevice;     // 当前选中/已连接的设备
     bool m_isStreaming = false;
-    QTimer* m_previewTimer;
-    QTimer* m_autoCaptureTimer;
+    bool m_scanRequested = false;           // 手动刷新，扫描完成时报告设备数
+    QTimer* m_telemetryTimer;               // 采集统计刷新 (1 Hz)
+    QThread* m_tuningThread = nullptr;      // GigE 传输调优（连接后执行，完成前不能取流）
+    int      m_tuningGeneration = 0;        // 每次启动或中止加一，丢弃已中止调优的完成通知
+    std::unique_ptr<TransportTuner> m_tuner;
+    NodeMap* m_nodeMap = nullptr;           // 已连接设备的节点缓存
     bool m_isPreviewing;
     bool m_isAutoCapturing;
     QList<CalibrationData> m_calibrationData;
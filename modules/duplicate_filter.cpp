@@ -0,0 +1,133 @@
+#include "duplicate_filter.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+// 哈希取 DCT 的 HASH_BLOCK x HASH_BLOCK 低频系数，DCT 输入为 HASH_INPUT x HASH_INPUT
+static const int HASH_INPUT = 32;
+static const int HASH_BLOCK = 8;
+
+DuplicateFilter::DuplicateFilter(const Options& options)
+    : m_options(options)
+{}
+
+quint64 DuplicateFilter::perceptualHash(const cv::Mat& image)
+{
+    if (image.empty()) return 0;
+    cv::Mat gray = image;
+    if (gray.channels() == 3)
+        cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY);
+    else if (gray.channels() == 4)
+        cv::cvtColor(gray, gray, cv::COLOR_BGRA2GRAY);
+
+    // 只与中值比较，位深不影响结果，16 位图像不需要先缩放
+    cv::Mat small, freq;
+    cv::resize(gray, small, cv::Size(HASH_INPUT, HASH_INPUT), 0, 0, cv::INTER_AREA);
+    small.convertTo(small, CV_32F);
+    cv::dct(small, freq);
+
+    float coeffs[HASH_BLOCK * HASH_BLOCK];
+    for (int y = 0; y < HASH_BLOCK; ++y)
+        for (int x = 0; x < HASH_BLOCK; ++x)
+            coeffs[y * HASH_BLOCK + x] = freq.at<float>(y, x);
+
+    // 中值不含直流分量：整体亮度变化不改变哈希
+    std::vector<float> ac(coeffs + 1, coeffs + HASH_BLOCK * HASH_BLOCK);
+    std::nth_element(ac.begin(), ac.begin() + ac.size() / 2, ac.end());
+    const float median = ac[ac.size() / 2];
+
+    quint64 hash = 0;
+    for (int i = 0; i < HASH_BLOCK * HASH_BLOCK; ++i)
+        if (coeffs[i] > median) hash |= quint64(1) << i;
+    return hash;
+}
+
+quint64 DuplicateFilter::perceptualHash(const QImage& thumbnail)
+{
+    if (thumbnail.isNull()) return 0;
+    const QImage gray = thumbnail.format() == QImage::Format_Grayscale8
+                            ? thumbnail : thumbnail.convertToFormat(QImage::Format_Grayscale8);
+    const cv::Mat view(gray.height(), gray.width(), CV_8UC1,
+                       const_cast<uchar*>(gray.constBits()), size_t(gray.bytesPerLine()));
+    return perceptualHash(view);
+}
+
+int DuplicateFilter::hashDistance(quint64 a, quint64 b)
+{
+    return int(qPopulationCount(a ^ b));
+}
+
+// 64 位分为 8 段，距离不超过 7 位的两个哈希至少有一段完全相同，只需比较共享某一段的帧
+quint64 DuplicateFilter::matchHash(quint64 hash) const
+{
+    int best = -1;
+    auto check = [&](int i) {
+        const Kept& kept = m_kept[size_t(i)];
+        if ((best < 0 || i < best) && kept.hasHash && hashDistance(hash, kept.hash) <= m_options.maxHashDistance)
+            best = i;
+    };
+    if (useHashIndex()) {
+        for (int part = 0; part < 8; ++part) {
+            auto it = m_hashIndex.constFind(quint32(part << 8) | quint32((hash >> (part * 8)) & 0xff));
+            if (it == m_hashIndex.constEnd()) continue;
+            for (int i : it.value()) check(i);
+        }
+    } else {
+        for (int i = 0; i < int(m_kept.size()) && best < 0; ++i) check(i);
+    }
+    return best >= 0 ? m_kept[size_t(best)].frameId : 0;
+}
+
+// 距离小于网格边长的位姿中心只可能在相邻的 3x3 网格内
+quint64 DuplicateFilter::matchPose(const CaptureGate::Pose& pose) const
+{
+    if (m_options.maxPoseDistance <= 0) return 0;
+    int best = -1;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto it = m_poseGrid.constFind(poseCell(pose, dx, dy));
+            if (it == m_poseGrid.constEnd()) continue;
+            for (int i : it.value()) {
+                if ((best < 0 || i < best)
+                    && CaptureGate::poseDistance(pose, m_kept[size_t(i)].pose) < m_options.maxPoseDistance)
+                    best = i;
+            }
+        }
+    }
+    return best >= 0 ? m_kept[size_t(best)].frameId : 0;
+}
+
+void DuplicateFilter::keep(quint64 frameId, const quint64* hash, const CaptureGate::Pose* pose)
+{
+    const int index = int(m_kept.size());
+    Kept kept;
+    kept.frameId = frameId;
+    if (hash) {
+        kept.hasHash = true;
+        kept.hash    = *hash;
+        if (useHashIndex())
+            for (int part = 0; part < 8; ++part)
+                m_hashIndex[quint32(part << 8) | quint32((*hash >> (part * 8)) & 0xff)].push_back(index);
+    }
+    if (pose) {
+        kept.hasPose = true;
+        kept.pose    = *pose;
+        if (m_options.maxPoseDistance > 0)
+            m_poseGrid[poseCell(*pose)].push_back(index);
+    }
+    m_kept.push_back(kept);
+}
+
+void DuplicateFilter::clear()
+{
+    m_kept.clear();
+    m_hashIndex.clear();
+    m_poseGrid.clear();
+}
+
+qint64 DuplicateFilter::poseCell(const CaptureGate::Pose& pose, int dx, int dy) const
+{
+    const int x = int(std::floor(pose.v[0] / m_options.maxPoseDistance)) + dx;
+    const int y = int(std::floor(pose.v[1] / m_options.maxPoseDistance)) + dy;
+    return (qint64(x) << 32) ^ qint64(quint32(y));
+}
@@ -0,0 +1,57 @@
+#ifndef DUPLICATE_FILTER_H
+#define DUPLICATE_FILTER_H
+
+#include <QImage>
+#include <QHash>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "capture_gate.h"
+
+// 近似重复帧判定，按输入顺序逐帧调用，只与已保留的帧比较，每组重复帧保留最先出现的一张
+//   外观：感知哈希（灰度缩小到 32x32 后 DCT，左上 8x8 低频系数与中值比较，共 64 位），
+//         汉明距离不超过 maxHashDistance 即为重复；曝光噪声和压缩误差只影响高频，不改变哈希
+//   位姿：角点已知时比较外框位姿描述（同自动采集的新颖度），距离小于 maxPoseDistance 即为重复，
+//         外观不同（光照、背景变化）但标定板位姿相同的帧不提供新的约束
+// 已保留的帧按哈希分段和位姿中心网格建索引，每帧只比较少数候选，数万帧的数据集也可在界面线程中整体判定
+class DuplicateFilter
+{
+public:
+    struct Options {
+        int    maxHashDistance = 6;         // 0..64；小于 8 时按分段索引查找，否则逐个比较
+        double maxPoseDistance = 0.02;      // 自动采集的新颖度门限为 0.10
+    };
+
+    explicit DuplicateFilter(const Options& options = Options());
+
+    // 数据集帧在生成缩略图时计算，输入为任意位深的灰度或 BGR 图像
+    static quint64 perceptualHash(const cv::Mat& image);
+    static quint64 perceptualHash(const QImage& thumbnail);
+    static int hashDistance(quint64 a, quint64 b);
+
+    // 返回与之重复的已保留帧 ID，0 表示不重复
+    quint64 matchHash(quint64 hash) const;
+    quint64 matchPose(const CaptureGate::Pose& pose) const;
+    // hash / pose 为空指针表示尚未得到，不参与对应的比较
+    void keep(quint64 frameId, const quint64* hash, const CaptureGate::Pose* pose);
+    void clear();
+
+private:
+    struct Kept {
+        quint64 frameId = 0;
+        bool    hasHash = false;
+        bool    hasPose = false;
+        quint64 hash = 0;
+        CaptureGate::Pose pose;
+    };
+
+    bool useHashIndex() const { return m_options.maxHashDistance < 8; }
+    // 位姿中心所在网格偏移 (dx, dy) 后的网格，网格边长为 maxPoseDistance
+    qint64 poseCell(const CaptureGate::Pose& pose, int dx = 0, int dy = 0) const;
+
+    Options m_options;
+    std::vector<Kept> m_kept;
+    QHash<quint32, std::vector<int>> m_hashIndex;   // (段号 << 8 | 段值) -> m_kept 下标
+    QHash<qint64, std::vector<int>>  m_poseGrid;    // 位姿中心所在网格 -> m_kept 下标
+};
+
+#endif // DUPLICATE_FILTER_H
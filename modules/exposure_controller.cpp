@@ -0,0 +1,208 @@
+#include "exposure_controller.h"
+#include <QtMath>
+#include <cmath>
+
+// 标定板区域测光的行采样间隔
+static const int BOARD_METER_ROW_STEP = 4;
+// 标定板区域超过此时间未更新则改回全帧测光
+static const int BOARD_REGION_MAX_AGE_MS = 1000;
+// 写入后至少再等这么多帧，避免评估到曝光切换中的帧
+static const quint64 SETTLE_FRAMES = 2;
+
+ExposureController::ExposureController(AcquisitionEngine* engine, QObject* parent)
+    : QObject(parent)
+    , m_engine(engine)
+{
+    connect(&m_timer, &QTimer::timeout, this, &ExposureController::evaluate);
+}
+
+bool ExposureController::start(NodeMap* nodeMap, int cameraIndex, const Options& options)
+{
+    if (!nodeMap || m_nodeMap) return false;
+    if (!nodeMap->node("ExposureTime").available) return false;
+
+    m_nodeMap = nodeMap;
+    m_cameraIndex = cameraIndex;
+    m_options = options;
+    m_stats = Stats();
+    m_adjusting = true;
+    m_adjustClock.start();
+    m_adjustWrites = 0;
+    m_waiting = false;
+    m_boardRegion = QRectF();
+    connect(m_nodeMap, &NodeMap::applied, this, &ExposureController::onApplied);
+    m_timer.start(m_options.intervalMs);
+    return true;
+}
+
+void ExposureController::stop()
+{
+    if (!m_nodeMap) return;
+    m_timer.stop();
+    disconnect(m_nodeMap, nullptr, this, nullptr);
+    m_nodeMap = nullptr;
+}
+
+void ExposureController::setBoardRegion(const QRectF& region)
+{
+    m_boardRegion = region;
+    m_boardAge.start();
+}
+
+void ExposureController::evaluate()
+{
+    if (!m_nodeMap) return;
+
+    AcquiredFrame frame;
+    if (!m_engine->latestFrame(m_cameraIndex, frame) || frame.buffer.isNull()) return;
+    const FrameMeta& meta = frame.buffer.meta();
+    if (!meta.analytics.valid) return;
+
+    // 当前参数优先取帧内记录的实际值，相机不提供时用节点缓存
+    double exposure = meta.exposureTime, gain = meta.gain;
+    if (exposure <= 0) {
+        m_nodeMap->value("ExposureTime", &exposure);
+        m_nodeMap->value("Gain", &gain);
+    }
+    if (exposure <= 0) return;
+
+    // 等待上一次写入生效
+    if (m_waiting) {
+        const bool newFrame = meta.sequence >= m_waitSequence;
+        const bool reflected = meta.exposureTime <= 0
+                               || (qAbs(meta.exposureTime - m_requestedExposure) <= 0.02 * m_requestedExposure + 1.0
+                                   && qAbs(meta.gain - m_requestedGain) <= 0.2);
+        if (!(newFrame && reflected) && m_waitClock.elapsed() < m_options.settleTimeoutMs) return;
+        m_waiting = false;
+    }
+
+    double brightness = 0, target = 0, saturated = 0;
+    if (!meter(frame, brightness, target, saturated)) return;
+    const quint64 sequence = meta.sequence;
+    frame = AcquiredFrame();        // 尽早归还缓存槽
+
+    // 误差按对数比计算，过曝时至少下调 20%
+    double error = std::log(target / qMax(brightness, 1.0));
+    if (saturated > m_options.maxSaturated)
+        error = qMin(error, std::log(0.8));
+    m_stats.exposureUs = exposure;
+    m_stats.gainDb     = gain;
+    m_stats.brightness = brightness;
+    m_stats.target     = target;
+
+    // 回差：调节中以 enterBand 判断收敛，收敛后以 leaveBand 判断是否重新调节
+    if (qAbs(error) <= (m_adjusting ? m_options.enterBand : m_options.leaveBand)) {
+        if (m_adjusting) {
+            m_adjusting = false;
+            m_stats.converged = true;
+            m_stats.convergences++;
+            m_stats.lastConvergenceMs = m_adjustClock.elapsed();
+            m_stats.lastConvergenceWrites = m_adjustWrites;
+            emit converged(m_stats.lastConvergenceMs, m_adjustWrites);
+        }
+        return;
+    }
+    if (!m_adjusting) {
+        m_adjusting = true;
+        m_stats.converged = false;
+        m_adjustClock.start();
+        m_adjustWrites = 0;
+    }
+
+    // 本次调节的亮度倍数（限速）
+    const double maxLog = std::log(m_options.maxStep);
+    const double ratio = std::exp(qBound(-maxLog, error, maxLog));
+
+    const NodeMap::Node exposureNode = m_nodeMap->node("ExposureTime");
+    const NodeMap::Node gainNode = m_nodeMap->node("Gain");
+    const double minExposure = qMax(1.0, exposureNode.min);
+    double maxExposure = m_options.maxExposureUs;
+    if (exposureNode.max > exposureNode.min) maxExposure = qMin(maxExposure, exposureNode.max);
+    maxExposure = qMax(maxExposure, minExposure);
+    const double minGain = gainNode.available ? qMax(0.0, gainNode.min) : 0.0;
+    double maxGain = gainNode.available ? m_options.maxGainDb : minGain;
+    if (gainNode.available && gainNode.max > gainNode.min) maxGain = qMin(maxGain, gainNode.max);
+    maxGain = qMax(maxGain, minGain);
+
+    // 总亮度 = 曝光 x 增益倍数：先分配给曝光，曝光到上限后再分配给增益
+    const double total = exposure * std::pow(10.0, gain / 20.0) * ratio;
+    const double newExposure = qBound(minExposure, total / std::pow(10.0, minGain / 20.0), maxExposure);
+    double newGain = qBound(minGain, 20.0 * std::log10(total / newExposure), maxGain);
+    newGain = qBound(gain - m_options.maxGainStepDb, newGain, gain + m_options.maxGainStepDb);
+
+    // 已到调节范围的边界，不重复写入
+    if (qAbs(newExposure - exposure) <= 0.005 * exposure && qAbs(newGain - gain) < 0.05) return;
+
+    write(newExposure, newGain);
+    m_waitSequence = sequence + SETTLE_FRAMES;
+}
+
+// 测光：标定板区域有效时取板内 95% 分位（白格），否则取全帧均值
+bool ExposureController::meter(const AcquiredFrame& frame, double& brightness, double& target, double& saturated)
+{
+    const FrameAnalytics& analytics = frame.buffer.meta().analytics;
+    const cv::Mat& image = frame.image;
+    const bool boardValid = !m_boardRegion.isEmpty() && m_boardAge.isValid()
+                            && m_boardAge.elapsed() < BOARD_REGION_MAX_AGE_MS;
+    m_stats.boardMetered = false;
+
+    if (boardValid && !image.empty()) {
+        const cv::Rect roi = cv::Rect(int(m_boardRegion.x() * image.cols), int(m_boardRegion.y() * image.rows),
+                                      int(m_boardRegion.width() * image.cols), int(m_boardRegion.height() * image.rows))
+                             & cv::Rect(0, 0, image.cols, image.rows);
+        if (roi.height >= BOARD_METER_ROW_STEP && roi.width >= 8) {
+            // 隔行采样的视图，不拷贝
+            const cv::Mat region = image(roi);
+            const cv::Mat rows(roi.height / BOARD_METER_ROW_STEP, roi.width, region.type(),
+                               region.data, region.step * BOARD_METER_ROW_STEP);
+            const int histSize = 256;
+            const float range[] = { 0, image.depth() == CV_16U ? 65536.0f : 256.0f };
+            const float* ranges[] = { range };
+            const int channels = 0;
+            cv::Mat hist;
+            cv::calcHist(&rows, 1, &channels, cv::Mat(), hist, 1, &histSize, ranges);
+
+            const double total = double(rows.total());
+            double accumulated = 0, clipped = 0;
+            int p95 = 255;
+            bool found = false;
+            for (int i = 0; i < histSize; ++i) {
+                accumulated += hist.at<float>(i);
+                if (!found && accumulated >= total * 0.95) { p95 = i; found = true; }
+                if (i >= FrameAnalytics::SaturatedLevel) clipped += hist.at<float>(i);
+            }
+            brightness = p95;
+            target = m_options.targetBoardWhite;
+            saturated = clipped / total;
+            m_stats.boardMetered = true;
+            return true;
+        }
+    }
+
+    if (!analytics.valid) return false;
+    brightness = analytics.mean;
+    target = m_options.targetMean;
+    saturated = analytics.saturatedFraction;
+    return true;
+}
+
+void ExposureController::write(double exposureUs, double gainDb)
+{
+    m_nodeMap->set("ExposureTime", exposureUs);
+    m_nodeMap->set("Gain", gainDb);
+    m_nodeMap->apply();
+    m_requestedExposure = exposureUs;
+    m_requestedGain = gainDb;
+    m_waiting = true;
+    m_waitClock.start();
+    m_stats.writes++;
+    m_adjustWrites++;
+}
+
+void ExposureController::onApplied(int written, const QStringList& errors, qint64 elapsedUs)
+{
+    Q_UNUSED(elapsedUs);
+    m_stats.nodeWrites += quint64(written);
+    if (!errors.isEmpty())
+        emit errorOccurred(tr("自动曝光写入失败: %1").arg(errors.join(", ")));
+}
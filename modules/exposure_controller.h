@@ -0,0 +1,94 @@
+#ifndef EXPOSURE_CONTROLLER_H
+#define EXPOSURE_CONTROLLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QRectF>
+#include <QElapsedTimer>
+#include "acquisition_engine.h"
+#include "node_map.h"
+
+// 软件自动曝光/增益：按固定周期读取最新帧的画面统计（FrameMeta::analytics），
+// 已知标定板区域时以板内白格亮度为目标，否则以全帧均值为目标，过曝时强制下调
+//   - 亮度按 曝光 x 增益 的乘积调节：先用曝光（不超过运动模糊上限），不够再加增益；下调时先减增益
+//   - 回差：收敛后误差超过 leaveBand 才重新调节，调节到 enterBand 以内视为收敛
+//   - 限速：每次调节幅度有上限，写入后等新参数的帧到达再评估
+// 参数经 NodeMap 批量写入（工作线程），不阻塞取流和界面
+class ExposureController : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        double targetMean = 110;        // 全帧均值目标（8 位）
+        double targetBoardWhite = 200;  // 标定板白格（板内 95% 分位）目标
+        double maxSaturated = 0.01;     // 过曝像素比例上限
+        double enterBand = 0.05;        // 误差（对数比）进入此范围视为收敛
+        double leaveBand = 0.15;        // 收敛后误差超过此范围才重新调节
+        double maxStep = 1.6;           // 单次亮度调节倍数上限
+        double maxGainStepDb = 3.0;     // 单次增益调节上限
+        double maxExposureUs = 15000;   // 曝光上限，限制运动模糊
+        double maxGainDb = 12.0;        // 增益上限，限制噪声
+        int    intervalMs = 100;        // 评估周期
+        int    settleTimeoutMs = 1000;  // 写入后等待新参数生效的最长时间
+    };
+
+    struct Stats {
+        bool    converged = false;
+        quint64 writes = 0;             // 参数写入批次数
+        quint64 nodeWrites = 0;         // 实际写入的节点数
+        int     convergences = 0;
+        qint64  lastConvergenceMs = 0;  // 最近一次从开始调节到收敛的时间
+        int     lastConvergenceWrites = 0;
+        double  exposureUs = 0;
+        double  gainDb = 0;
+        double  brightness = 0;         // 最近一次的被控亮度
+        double  target = 0;
+        bool    boardMetered = false;   // 最近一次按标定板区域测光
+    };
+
+    ExposureController(AcquisitionEngine* engine, QObject* parent = nullptr);
+
+    bool start(NodeMap* nodeMap, int cameraIndex, const Options& options = Options());
+    void stop();
+    bool isRunning() const { return m_nodeMap != nullptr; }
+
+    // 标定板区域（归一化坐标），空矩形表示未检测到；超过 1 s 未更新视为失效
+    void setBoardRegion(const QRectF& region);
+
+    Stats stats() const { return m_stats; }
+
+signals:
+    void converged(qint64 elapsedMs, int writes);
+    void errorOccurred(const QString& error);
+
+private slots:
+    void evaluate();
+    void onApplied(int written, const QStringList& errors, qint64 elapsedUs);
+
+private:
+    bool meter(const AcquiredFrame& frame, double& brightness, double& target, double& saturated);
+    void write(double exposureUs, double gainDb);
+
+    AcquisitionEngine* m_engine;
+    NodeMap*  m_nodeMap = nullptr;
+    int       m_cameraIndex = -1;
+    Options   m_options;
+    QTimer    m_timer;
+    Stats     m_stats;
+
+    QRectF        m_boardRegion;
+    QElapsedTimer m_boardAge;
+
+    // 调节状态
+    bool          m_adjusting = true;       // 启动时先调节一次
+    QElapsedTimer m_adjustClock;            // 本轮调节开始时间
+    int           m_adjustWrites = 0;
+    bool          m_waiting = false;        // 写入后等待生效
+    quint64       m_waitSequence = 0;
+    QElapsedTimer m_waitClock;
+    double        m_requestedExposure = 0;
+    double        m_requestedGain = 0;
+};
+
+#endif // EXPOSURE_CONTROLLER_H
@@ -0,0 +1,138 @@
+#include "frame_analytics.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cstring>
+
+namespace {
+
+// 拉普拉斯平方和按块累加到 int32，块内不会溢出（每块最多 256 次向量迭代）
+const int LAP_FLUSH_ITERATIONS = 256;
+
+struct Accumulator {
+    quint32 hist[4][256];               // 四份子直方图交替写入，减少相邻像素同值时的写后读依赖
+    qint64  lapSum = 0;
+    qint64  lapSq = 0;
+    qint64  lapCount = 0;
+};
+
+// 一行：中心行 row 的直方图 + 内部像素的 4 邻域拉普拉斯和/平方和
+void analyzeRow(const uchar* up, const uchar* row, const uchar* down, int width, Accumulator& acc)
+{
+    quint32* h0 = acc.hist[0];
+    quint32* h1 = acc.hist[1];
+    quint32* h2 = acc.hist[2];
+    quint32* h3 = acc.hist[3];
+    h0[row[0]]++;
+    h1[row[width - 1]]++;
+
+    int x = 1;
+    qint64 lapSum = 0, lapSq = 0;
+#if CV_SIMD128
+    const cv::v_int16x8 one = cv::v_setall_s16(1);
+    cv::v_int32x4 vsum = cv::v_setzero_s32();
+    cv::v_int32x4 vsq  = cv::v_setzero_s32();
+    int iterations = 0;
+    auto flush = [&]() {
+        int lanes[4];
+        cv::v_store(lanes, vsum);
+        lapSum += qint64(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        cv::v_store(lanes, vsq);
+        lapSq += qint64(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        vsum = cv::v_setzero_s32();
+        vsq  = cv::v_setzero_s32();
+        iterations = 0;
+    };
+    for (; x + 16 <= width - 1; x += 16) {
+        cv::v_uint16x8 c0, c1, l0, l1, r0, r1, u0, u1, d0, d1;
+        cv::v_expand(cv::v_load(row + x), c0, c1);
+        cv::v_expand(cv::v_load(row + x - 1), l0, l1);
+        cv::v_expand(cv::v_load(row + x + 1), r0, r1);
+        cv::v_expand(cv::v_load(up + x), u0, u1);
+        cv::v_expand(cv::v_load(down + x), d0, d1);
+
+        // 邻域和与 4 倍中心都不超过 1020，按有符号 16 位相减
+        const cv::v_int16x8 lap0 = cv::v_reinterpret_as_s16(l0 + r0 + u0 + d0)
+                                   - cv::v_reinterpret_as_s16(cv::v_shl<2>(c0));
+        const cv::v_int16x8 lap1 = cv::v_reinterpret_as_s16(l1 + r1 + u1 + d1)
+                                   - cv::v_reinterpret_as_s16(cv::v_shl<2>(c1));
+        vsum = vsum + cv::v_dotprod(lap0, one) + cv::v_dotprod(lap1, one);
+        vsq  = vsq + cv::v_dotprod(lap0, lap0) + cv::v_dotprod(lap1, lap1);
+        if (++iterations == LAP_FLUSH_ITERATIONS) flush();
+
+        // 同一次迭代内更新直方图，数据仍在寄存器/L1 中
+        const uchar* p = row + x;
+        for (int k = 0; k < 16; k += 4) {
+            h0[p[k]]++;
+            h1[p[k + 1]]++;
+            h2[p[k + 2]]++;
+            h3[p[k + 3]]++;
+        }
+    }
+    flush();
+#endif
+    for (; x < width - 1; ++x) {
+        const int lap = up[x] + down[x] + row[x - 1] + row[x + 1] - 4 * row[x];
+        lapSum += lap;
+        lapSq  += lap * lap;
+        h2[row[x]]++;
+    }
+    acc.lapSum   += lapSum;
+    acc.lapSq    += lapSq;
+    acc.lapCount += width - 2;
+}
+
+} // namespace
+
+int FrameAnalytics::percentile(double fraction) const
+{
+    const double target = samples * fraction;
+    double accumulated = 0;
+    for (int i = 0; i < 256; ++i) {
+        accumulated += histogram[i];
+        if (accumulated >= target) return i;
+    }
+    return 255;
+}
+
+bool FrameAnalyzer::analyze(const cv::Mat& image, int rowStep, FrameAnalytics& out)
+{
+    out.valid = false;
+    if (image.empty() || image.rows < 3 || image.cols < 3) return false;
+    if (image.type() != CV_8UC1 && image.type() != CV_16UC1) return false;
+
+    rowStep = qMax(1, rowStep);
+    const int width = image.cols;
+    Accumulator acc;
+    memset(acc.hist, 0, sizeof(acc.hist));
+
+    for (int y = 1; y < image.rows - 1; y += rowStep) {
+        if (image.type() == CV_8UC1) {
+            analyzeRow(image.ptr<uchar>(y - 1), image.ptr<uchar>(y), image.ptr<uchar>(y + 1), width, acc);
+        } else {
+            // 16 位取高 8 位：只转换本次用到的三行
+            m_rows8.create(3, width, CV_8UC1);
+            image.rowRange(y - 1, y + 2).convertTo(m_rows8, CV_8U, 1.0 / 256);
+            analyzeRow(m_rows8.ptr<uchar>(0), m_rows8.ptr<uchar>(1), m_rows8.ptr<uchar>(2), width, acc);
+        }
+    }
+
+    quint64 samples = 0, weighted = 0, saturated = 0, black = 0;
+    for (int i = 0; i < 256; ++i) {
+        const quint32 n = acc.hist[0][i] + acc.hist[1][i] + acc.hist[2][i] + acc.hist[3][i];
+        out.histogram[i] = n;
+        samples  += n;
+        weighted += quint64(n) * i;
+        if (i >= FrameAnalytics::SaturatedLevel) saturated += n;
+        if (i <= FrameAnalytics::BlackLevel) black += n;
+    }
+    if (samples == 0 || acc.lapCount == 0) return false;
+
+    const double lapMean = double(acc.lapSum) / acc.lapCount;
+    out.rowStep           = rowStep;
+    out.samples           = quint32(samples);
+    out.mean              = float(double(weighted) / samples);
+    out.sharpness         = float(double(acc.lapSq) / acc.lapCount - lapMean * lapMean);
+    out.saturatedFraction = float(double(saturated) / samples);
+    out.blackFraction     = float(double(black) / samples);
+    out.valid             = true;
+    return true;
+}
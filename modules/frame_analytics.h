@@ -0,0 +1,38 @@
+#ifndef FRAME_ANALYTICS_H
+#define FRAME_ANALYTICS_H
+
+#include <QtGlobal>
+#include <opencv2/opencv.hpp>
+
+// 逐帧画面统计：清晰度、直方图、过曝/欠曝比例、均值
+// 由抓图线程在发布前写入 FrameMeta，消费者只读
+struct FrameAnalytics {
+    static const int SaturatedLevel = 250;  // 不低于此灰度视为过曝
+    static const int BlackLevel = 5;        // 不高于此灰度视为欠曝
+
+    bool    valid = false;
+    int     rowStep = 1;                // 采样行间隔
+    quint32 samples = 0;                // 参与直方图的像素数
+    float   mean = 0;                   // 8 位灰度均值
+    float   sharpness = 0;              // 4 邻域拉普拉斯方差
+    float   saturatedFraction = 0;
+    float   blackFraction = 0;
+    quint32 histogram[256] = {};        // 8 位灰度（16 位输入取高 8 位）
+
+    // 直方图的分位数 (0..255)
+    int percentile(double fraction) const;
+};
+
+// 单遍统计：每 rowStep 行取一行，同一次循环内完成拉普拉斯（SIMD）和直方图，
+// 均值和过曝/欠曝比例由直方图得出，不再额外读图像
+// 支持 CV_8UC1 / CV_16UC1，其他类型返回 false
+class FrameAnalyzer
+{
+public:
+    bool analyze(const cv::Mat& image, int rowStep, FrameAnalytics& out);
+
+private:
+    cv::Mat m_rows8;                    // 16 位输入时三行的 8 位副本
+};
+
+#endif // FRAME_ANALYTICS_H
@@ -0,0 +1,241 @@
+#include "frame_history.h"
+#include "capture_gate.h"
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+// 缓存池槽数上限（小幅面时由时长而不是字节数限制）
+static const int MAX_HISTORY_FRAMES = 256;
+
+FrameHistory::FrameHistory()
+    : m_abort(0)
+{}
+
+FrameHistory::~FrameHistory()
+{
+    stop();
+}
+
+bool FrameHistory::start(std::shared_ptr<FrameRing> ring, const Options& options)
+{
+    if (!ring || m_thread) return false;
+
+    m_consumerId = ring->addConsumer(QStringLiteral("history"), FrameRing::DropOldest);
+    if (m_consumerId < 0) return false;
+
+    m_ring = std::move(ring);
+    m_options = options;
+    m_abort.storeRelease(0);
+    m_stored.store(0);
+    m_dropped.store(0);
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    return true;
+}
+
+void FrameHistory::stop()
+{
+    if (!m_thread) return;
+
+    m_abort.storeRelease(1);
+    if (!m_thread->wait(3000))
+        qDebug() << "Frame history thread termination timed out.";
+    delete m_thread;
+    m_thread = nullptr;
+
+    m_dropped.fetch_add(m_ring->stats(m_consumerId).dropped);
+    m_ring->removeConsumer(m_consumerId);
+    m_consumerId = -1;
+    m_ring.reset();
+
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+    m_pool.release();
+    m_capacity = 0;
+    m_poolBytes = 0;
+}
+
+FrameHistory::Stats FrameHistory::stats() const
+{
+    Stats out;
+    {
+        QMutexLocker locker(&m_mutex);
+        out.frames = m_frames.size();
+        if (!m_frames.isEmpty())
+            out.spanMs = (m_frames.last().meta().hostTimestamp - m_frames.first().meta().hostTimestamp) / 1000.0;
+        out.capacity = m_capacity;
+        out.bytes    = m_poolBytes;
+    }
+    out.stored   = m_stored.load();
+    out.dropped  = m_dropped.load();
+    if (m_ring && m_consumerId >= 0)
+        out.dropped += m_ring->stats(m_consumerId).dropped;
+    return out;
+}
+
+void FrameHistory::run()
+{
+    while (!m_abort.loadAcquire()) {
+        FrameHandle frame;
+        if (!m_ring->waitPop(m_consumerId, frame, 100))
+            continue;
+        if (store(frame))
+            m_stored.fetch_add(1, std::memory_order_relaxed);
+        else
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool FrameHistory::store(const FrameHandle& frame)
+{
+    const FrameMeta& meta = frame.meta();
+    const size_t step = meta.step ? meta.step : size_t(meta.width) * CV_ELEM_SIZE(meta.type);
+    const size_t bytes = step * size_t(meta.height);
+    if (bytes == 0 || bytes > frame.capacity()) return false;
+
+    // 首帧或幅面改变：清空历史，按新幅面分配缓存池
+    if (m_pool.bufferSize() != bytes) {
+        const int count = int(qBound<qint64>(2, m_options.maxBytes / qint64(bytes), MAX_HISTORY_FRAMES));
+        {
+            QMutexLocker locker(&m_mutex);
+            m_frames.clear();
+            m_capacity = 0;
+            m_poolBytes = 0;
+        }
+        if (!m_pool.allocate(bytes, count)) return false;      // 预先触碰内存，不在锁内进行
+        QMutexLocker locker(&m_mutex);
+        m_capacity = count;
+        m_poolBytes = qint64(bytes) * count;
+    }
+
+    // 池满时淘汰最旧的帧；挑选期间被持有的槽暂不可用，继续往后淘汰
+    FrameHandle slot = m_pool.acquire();
+    while (slot.isNull()) {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_frames.isEmpty()) break;
+            m_frames.removeFirst();
+        }
+        slot = m_pool.acquire();
+    }
+    if (slot.isNull()) return false;
+
+    std::memcpy(slot.data(), frame.data(), bytes);
+    slot.mutableMeta() = meta;
+    slot.mutableMeta().step = step;
+
+    // 按时长淘汰
+    const qint64 maxAgeUs = qint64(m_options.seconds * 1e6);
+    QMutexLocker locker(&m_mutex);
+    m_frames.append(std::move(slot));
+    while (m_frames.size() > 1
+           && meta.hostTimestamp - m_frames.first().meta().hostTimestamp > maxAgeUs)
+        m_frames.removeFirst();
+    return true;
+}
+
+bool FrameHistory::select(const cv::Size& boardSize, Selection& out) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 快照只复制句柄，挑选期间历史线程照常写入
+    QList<FrameHandle> frames;
+    {
+        QMutexLocker locker(&m_mutex);
+        frames = m_frames;
+    }
+    if (frames.isEmpty()) return false;
+
+    out = Selection();
+    out.window = frames.size();
+
+    // 预选：画面清晰度（拉普拉斯方差）最高的若干帧，第一帧没有前一帧可比较
+    std::vector<int> order;
+    for (int i = (frames.size() > 1 ? 1 : 0); i < frames.size(); ++i)
+        order.push_back(i);
+    auto globalSharpness = [&frames](int i) {
+        const FrameAnalytics& a = frames[i].meta().analytics;
+        return a.valid ? double(a.sharpness) : -1.0;
+    };
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return globalSharpness(a) > globalSharpness(b); });
+    if (int(order.size()) > m_options.candidates)
+        order.resize(size_t(qMax(1, m_options.candidates)));
+
+    // 预选帧及其前一帧并行检测标定板，预选帧再评估棋盘区域清晰度
+    struct Job {
+        int  index = 0;
+        bool candidate = false;
+        bool found = false;
+        double sharpness = 0;
+        std::vector<cv::Point2f> corners;
+    };
+    std::vector<int> jobOf(size_t(frames.size()), -1);
+    std::vector<Job> jobs;
+    auto addJob = [&](int index, bool candidate) {
+        if (jobOf[size_t(index)] < 0) {
+            jobOf[size_t(index)] = int(jobs.size());
+            Job job;
+            job.index = index;
+            jobs.push_back(job);
+        }
+        jobs[size_t(jobOf[size_t(index)])].candidate |= candidate;
+    };
+    for (int index : order) {
+        addJob(index, true);
+        if (index > 0) addJob(index - 1, false);
+    }
+    const int detectWidth = m_options.detectWidth;
+    QtConcurrent::blockingMap(jobs, [&frames, &boardSize, detectWidth](Job& job) {
+        const cv::Mat image = frames[job.index].toMat();
+        if (image.empty()) return;
+        cv::Mat small, small8;
+        job.found = CaptureGate::detectBoard(image, boardSize, detectWidth, job.corners, small, small8);
+        if (job.found && job.candidate)
+            job.sharpness = CaptureGate::boardSharpness(image, job.corners);
+    });
+    out.evaluated = int(jobs.size());
+
+    // 稳定帧优先，其次按棋盘区域清晰度；都没有检测到标定板时取画面最清晰的一帧
+    int best = order.front();
+    bool bestFound = false, bestStable = false;
+    double bestSharpness = -1, bestMotion = 0;
+    for (int index : order) {
+        const Job& job = jobs[size_t(jobOf[size_t(index)])];
+        if (!job.found) continue;
+        bool stable = false;
+        double motion = 0;
+        if (index > 0) {
+            const Job& prev = jobs[size_t(jobOf[size_t(index - 1)])];
+            if (prev.found && prev.corners.size() == job.corners.size()) {
+                for (size_t k = 0; k < job.corners.size(); ++k)
+                    motion += cv::norm(job.corners[k] - prev.corners[k]);
+                motion /= double(job.corners.size());
+                stable = motion <= m_options.maxMotion * frames[index].meta().width;
+            }
+        }
+        if ((stable && !bestStable) || (stable == bestStable && job.sharpness > bestSharpness)) {
+            best = index;
+            bestFound = true;
+            bestStable = stable;
+            bestSharpness = job.sharpness;
+            bestMotion = motion;
+        }
+    }
+
+    const FrameHandle& chosen = frames[best];
+    out.image         = chosen.toMat().clone();
+    out.hostTimestamp = chosen.meta().hostTimestamp;
+    out.meta          = chosen.meta();
+    out.ageMs         = (frames.last().meta().hostTimestamp - out.hostTimestamp) / 1000;
+    out.found         = bestFound;
+    out.stable        = bestStable;
+    out.sharpness     = qMax(0.0, bestSharpness);
+    out.motionPx      = bestMotion;
+    out.selectMs      = timer.nsecsElapsed() / 1e6;
+    return !out.image.empty();
+}
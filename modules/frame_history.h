@@ -0,0 +1,86 @@
+#ifndef FRAME_HISTORY_H
+#define FRAME_HISTORY_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QList>
+#include <atomic>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "frame_ring.h"
+
+// 预触发历史：在独立线程中按 DropOldest 从帧队列取帧，拷入自有缓存池，
+// 保留最近 seconds 秒（且不超过 maxBytes）的帧。采集时从这段历史中挑选：
+//   1. 按抓图线程已算好的画面清晰度（FrameMeta::analytics）预选 candidates 帧
+//   2. 并行检测预选帧及其前一帧的标定板，角点位移小于 maxMotion 视为板稳定
+//   3. 稳定帧中取棋盘区域清晰度最高的一帧（评估方法同自动采集）
+// 历史帧占用自有缓存池，不占采集缓存槽，不影响取流
+class FrameHistory
+{
+public:
+    struct Options {
+        double seconds = 2.0;                   // 回溯时长
+        qint64 maxBytes = qint64(512) << 20;    // 缓存上限
+        int    detectWidth = 640;               // 检测用缩小宽度
+        int    candidates = 8;                  // 预选帧数
+        double maxMotion = 0.002;               // 相邻帧角点平均位移上限（相对图像宽度）
+    };
+
+    struct Selection {
+        cv::Mat image;                  // 选中帧的拷贝
+        qint64  hostTimestamp = 0;
+        FrameMeta meta;                 // 选中帧的采集元信息（曝光、增益、像素格式）
+        qint64  ageMs = 0;              // 距最新帧的时间
+        bool    found = false;          // 检测到标定板
+        bool    stable = false;         // 板相对前一帧稳定
+        double  sharpness = 0;          // 棋盘区域清晰度 0..1
+        double  motionPx = 0;           // 与前一帧的角点平均位移
+        int     window = 0;             // 历史帧数
+        int     evaluated = 0;          // 检测了标定板的帧数
+        double  selectMs = 0;
+    };
+
+    struct Stats {
+        int     frames = 0;
+        int     capacity = 0;           // 缓存池槽数
+        qint64  bytes = 0;
+        double  spanMs = 0;             // 历史覆盖的时长
+        quint64 stored = 0;
+        quint64 dropped = 0;            // 队列丢帧 + 缓存池耗尽
+    };
+
+    FrameHistory();
+    ~FrameHistory();
+    FrameHistory(const FrameHistory&) = delete;
+    FrameHistory& operator=(const FrameHistory&) = delete;
+
+    bool start(std::shared_ptr<FrameRing> ring, const Options& options = Options());
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // 从当前历史中挑选一帧；历史为空时返回 false
+    bool select(const cv::Size& boardSize, Selection& out) const;
+    Stats stats() const;
+
+private:
+    void run();
+    bool store(const FrameHandle& frame);
+
+    std::shared_ptr<FrameRing> m_ring;
+    int        m_consumerId = -1;
+    QThread*   m_thread = nullptr;
+    QAtomicInt m_abort;
+    Options    m_options;
+
+    FramePool  m_pool;                  // 只在历史线程中分配/取槽
+    mutable QMutex     m_mutex;
+    QList<FrameHandle> m_frames;        // 按到达顺序
+    int    m_capacity = 0;              // 缓存池槽数（锁内读写）
+    qint64 m_poolBytes = 0;
+
+    std::atomic<quint64> m_stored{0};
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // FRAME_HISTORY_H
@@ -0,0 +1,183 @@
+#include "frame_pool.h"
+#include <cstring>
+
+// 池的实际存储：池本身和每个被占用的槽各持有一个引用，
+// 池先释放时已借出的槽仍然有效，最后一个槽归还时才真正释放内存
+struct FramePoolStorage {
+    std::vector<std::unique_ptr<FrameBuffer>> buffers;
+    size_t bufferSize = 0;
+    int nextProbe = 0;                  // 仅生产者线程使用
+    QAtomicInteger<quint64> exhausted;
+    QAtomicInt liveRefs;
+
+    ~FramePoolStorage()
+    {
+        for (auto& buffer : buffers)
+            cv::fastFree(buffer->data);
+    }
+
+    void unref()
+    {
+        if (!liveRefs.deref()) delete this;
+    }
+};
+
+/*-------------------------------- FrameHandle --------------------------------*/
+FrameHandle::FrameHandle(const FrameHandle& other)
+    : m_buffer(other.m_buffer)
+{
+    if (m_buffer) m_buffer->refCount.ref();
+}
+
+FrameHandle::FrameHandle(FrameHandle&& other) noexcept
+    : m_buffer(other.m_buffer)
+{
+    other.m_buffer = nullptr;
+}
+
+FrameHandle& FrameHandle::operator=(const FrameHandle& other)
+{
+    if (this != &other) {
+        FrameHandle copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+FrameHandle& FrameHandle::operator=(FrameHandle&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        m_buffer = other.m_buffer;
+        other.m_buffer = nullptr;
+    }
+    return *this;
+}
+
+FrameHandle::~FrameHandle()
+{
+    reset();
+}
+
+void FrameHandle::reset()
+{
+    // 引用计数归零即回到空闲状态，无需加锁
+    if (m_buffer && !m_buffer->refCount.deref())
+        m_buffer->owner->unref();
+    m_buffer = nullptr;
+}
+
+FrameHandle FrameHandle::tryRetain(FrameBuffer* buffer)
+{
+    if (!buffer) return FrameHandle();
+    for (;;) {
+        int count = buffer->refCount.loadAcquire();
+        if (count == 0) return FrameHandle();   // 已归还，不能复活
+        if (buffer->refCount.testAndSetOrdered(count, count + 1))
+            return FrameHandle(buffer);
+    }
+}
+
+cv::Mat FrameHandle::toMat(int rows, int cols, int type, size_t step) const
+{
+    if (!m_buffer) return cv::Mat();
+    return cv::Mat(rows, cols, type, m_buffer->data, step);
+}
+
+cv::Mat FrameHandle::toMat() const
+{
+    if (!m_buffer || m_buffer->meta.width <= 0 || m_buffer->meta.height <= 0) return cv::Mat();
+    const FrameMeta& meta = m_buffer->meta;
+    return toMat(meta.height, meta.width, meta.type, meta.step ? meta.step : cv::Mat::AUTO_STEP);
+}
+
+static void releaseFrameHandle(void* info)
+{
+    delete static_cast<FrameHandle*>(info);
+}
+
+QImage FrameHandle::toQImage(int width, int height, int bytesPerLine, QImage::Format format) const
+{
+    if (!m_buffer) return QImage();
+    return QImage(m_buffer->data, width, height, bytesPerLine, format,
+                  releaseFrameHandle, new FrameHandle(*this));
+}
+
+/*-------------------------------- FramePool --------------------------------*/
+FramePool::FramePool() = default;
+
+FramePool::~FramePool()
+{
+    release();
+}
+
+bool FramePool::allocate(size_t bufferSize, int bufferCount)
+{
+    release();
+    if (bufferSize == 0 || bufferCount <= 0) return false;
+
+    FramePoolStorage* storage = new FramePoolStorage;
+    storage->bufferSize = bufferSize;
+    storage->liveRefs.storeRelaxed(1);
+    for (int i = 0; i < bufferCount; ++i) {
+        auto buffer = std::make_unique<FrameBuffer>();
+        buffer->data = static_cast<unsigned char*>(cv::fastMalloc(bufferSize));
+        buffer->capacity = bufferSize;
+        buffer->owner = storage;
+        // 预先触碰，取流时不再产生缺页
+        std::memset(buffer->data, 0, bufferSize);
+        storage->buffers.push_back(std::move(buffer));
+    }
+    m_storage = storage;
+    return true;
+}
+
+void FramePool::release()
+{
+    // 已借出的槽继续持有存储，最后一个槽归还时才真正释放
+    if (m_storage) m_storage->unref();
+    m_storage = nullptr;
+}
+
+FrameHandle FramePool::acquire()
+{
+    if (!m_storage) return FrameHandle();
+
+    const int count = static_cast<int>(m_storage->buffers.size());
+    for (int i = 0; i < count; ++i) {
+        int index = (m_storage->nextProbe + i) % count;
+        FrameBuffer* buffer = m_storage->buffers[index].get();
+        if (buffer->refCount.testAndSetAcquire(0, 1)) {
+            m_storage->liveRefs.ref();
+            m_storage->nextProbe = (index + 1) % count;
+            buffer->meta = FrameMeta();
+            return FrameHandle(buffer);
+        }
+    }
+    m_storage->exhausted.fetchAndAddRelaxed(1);
+    return FrameHandle();
+}
+
+size_t FramePool::bufferSize() const
+{
+    return m_storage ? m_storage->bufferSize : 0;
+}
+
+int FramePool::bufferCount() const
+{
+    return m_storage ? static_cast<int>(m_storage->buffers.size()) : 0;
+}
+
+int FramePool::freeCount() const
+{
+    if (!m_storage) return 0;
+    int count = 0;
+    for (const auto& buffer : m_storage->buffers)
+        if (buffer->refCount.loadRelaxed() == 0) ++count;
+    return count;
+}
+
+quint64 FramePool::exhaustedCount() const
+{
+    return m_storage ? m_storage->exhausted.loadRelaxed() : 0;
+}
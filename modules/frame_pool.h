@@ -0,0 +1,103 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "frame_analytics.h"
+
+struct FramePoolStorage;
+
+// 帧元信息：生产者在发布前写入，发布后只读
+struct FrameMeta {
+    int          width = 0;
+    int          height = 0;
+    int          type = CV_8UC1;        // cv::Mat 类型
+    size_t       step = 0;              // 行字节数
+    int          cameraIndex = -1;      // 相机编号
+    quint64      sequence = 0;          // 本地递增序号
+    unsigned int frameNumber = 0;       // 设备帧号
+    quint64      deviceTimestamp = 0;   // 设备时间戳
+    qint64       hostTimestamp = 0;     // 主机到达时间(us)
+    unsigned int pixelType = 0;         // MvGvspPixelType
+    unsigned int dataSize = 0;          // 有效字节数（原始帧为 SDK 的 nFrameLen）
+    float        exposureTime = 0;      // 本帧曝光(us)
+    float        gain = 0;              // 本帧增益(dB)
+    FrameAnalytics analytics;           // 画面统计，按输出格式的图像计算
+};
+
+// 帧缓存槽：预分配，引用计数为 0 时空闲
+struct FrameBuffer {
+    unsigned char*    data = nullptr;
+    size_t            capacity = 0;
+    QAtomicInt        refCount;
+    FramePoolStorage* owner = nullptr;
+    FrameMeta         meta;
+};
+
+// 帧句柄：持有一个缓存槽的引用，最后一个句柄析构时槽自动归还
+class FrameHandle
+{
+public:
+    FrameHandle() = default;
+    FrameHandle(const FrameHandle& other);
+    FrameHandle(FrameHandle&& other) noexcept;
+    FrameHandle& operator=(const FrameHandle& other);
+    FrameHandle& operator=(FrameHandle&& other) noexcept;
+    ~FrameHandle();
+
+    bool isNull() const { return m_buffer == nullptr; }
+    unsigned char* data() const { return m_buffer ? m_buffer->data : nullptr; }
+    size_t capacity() const { return m_buffer ? m_buffer->capacity : 0; }
+    void reset();
+
+    // 元信息：只有刚从池中取出、尚未发布的句柄才应修改
+    const FrameMeta& meta() const { return m_buffer->meta; }
+    FrameMeta& mutableMeta() { return m_buffer->meta; }
+
+    // cv::Mat 视图：不拷贝，调用方需同时持有句柄保证数据有效
+    cv::Mat toMat(int rows, int cols, int type, size_t step = cv::Mat::AUTO_STEP) const;
+    cv::Mat toMat() const;
+    // QImage 视图：通过 cleanup 回调持有一份句柄，QImage 释放时归还
+    QImage toQImage(int width, int height, int bytesPerLine, QImage::Format format) const;
+
+    // 仅当槽仍被引用时才增加引用（供无锁环形队列使用）
+    static FrameHandle tryRetain(FrameBuffer* buffer);
+    FrameBuffer* buffer() const { return m_buffer; }
+
+private:
+    friend class FramePool;
+    friend class FrameRing;
+    explicit FrameHandle(FrameBuffer* adopted) : m_buffer(adopted) {}
+
+    FrameBuffer* m_buffer = nullptr;
+};
+
+// 固定大小的帧缓存池：StartGrabbing 时按 PayloadSize 一次性分配
+class FramePool
+{
+public:
+    FramePool();
+    ~FramePool();
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 按单帧字节数和槽数重新分配（会预先触碰内存，避免取流时缺页）
+    bool allocate(size_t bufferSize, int bufferCount);
+    void release();
+
+    // 取一个空闲槽，无空闲时返回空句柄（不阻塞）
+    FrameHandle acquire();
+
+    size_t bufferSize() const;
+    int bufferCount() const;
+    int freeCount() const;
+    quint64 exhaustedCount() const;
+
+private:
+    FramePoolStorage* m_storage = nullptr;
+};
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,193 @@
+#include "frame_ring.h"
+#include <QDeadlineTimer>
+#include <QThread>
+
+FrameRing::FrameRing(int capacity)
+    : m_capacity(capacity > 1 ? capacity : 2)
+    , m_slots(m_capacity)
+{}
+
+FrameRing::~FrameRing()
+{
+    clear();
+}
+
+int FrameRing::addConsumer(const QString& name, Policy policy)
+{
+    QMutexLocker locker(&m_registerMutex);
+    for (int i = 0; i < MaxConsumers; ++i) {
+        Consumer& consumer = m_consumers[i];
+        if (consumer.active.load()) continue;
+        consumer.name = name;
+        consumer.policy.store(policy);
+        consumer.consumed.store(0);
+        consumer.dropped.store(0);
+        consumer.cursor.store(m_head.load());   // 只接收注册之后的帧
+        consumer.active.store(true);
+        m_consumerCount.fetch_add(1);
+        return i;
+    }
+    return -1;
+}
+
+void FrameRing::removeConsumer(int consumerId)
+{
+    if (consumerId < 0 || consumerId >= MaxConsumers) return;
+    QMutexLocker locker(&m_registerMutex);
+    if (m_consumers[consumerId].active.exchange(false))
+        m_consumerCount.fetch_sub(1);
+}
+
+// 有 Block 消费者尚未读到即将被覆盖的位置
+bool FrameRing::blockedBy(quint64 position) const
+{
+    if (position < quint64(m_capacity)) return false;
+    const quint64 overwritten = position - m_capacity;
+    for (const Consumer& consumer : m_consumers) {
+        if (consumer.active.load() && consumer.policy.load() == Block
+            && consumer.cursor.load() <= overwritten)
+            return true;
+    }
+    return false;
+}
+
+bool FrameRing::push(const FrameHandle& frame, int blockTimeoutMs)
+{
+    if (frame.isNull()) return false;
+
+    const quint64 position = m_head.load();
+    if (blockedBy(position)) {
+        QDeadlineTimer deadline(blockTimeoutMs);
+        while (blockedBy(position)) {
+            if (deadline.hasExpired()) {
+                m_producerDropped.fetch_add(1);
+                return false;
+            }
+            QThread::usleep(200);
+        }
+    }
+
+    // 队列自身持有一份引用；先把序号置 0，消费者据此识别“正在覆盖”
+    Slot& slot = m_slots[position % m_capacity];
+    FrameBuffer* incoming = frame.buffer();
+    incoming->refCount.ref();
+    slot.seq.store(0);
+    FrameHandle previous(slot.buffer.exchange(incoming));
+    slot.seq.store(position + 1);
+    m_head.store(position + 1);
+
+    if (m_waiters.load() > 0) {
+        QMutexLocker locker(&m_waitMutex);
+        m_frameAvailable.wakeAll();
+    }
+    return true;    // previous 析构时归还被覆盖的帧
+}
+
+bool FrameRing::readSlot(quint64 position, FrameHandle& frame) const
+{
+    const Slot& slot = m_slots[position % m_capacity];
+    const quint64 expected = position + 1;
+    if (slot.seq.load() != expected) return false;
+
+    FrameHandle retained = FrameHandle::tryRetain(slot.buffer.load());
+    // 引用到手后再校验一次序号，期间被覆盖则放弃
+    if (retained.isNull() || slot.seq.load() != expected) return false;
+    frame = std::move(retained);
+    return true;
+}
+
+bool FrameRing::pop(int consumerId, FrameHandle& frame)
+{
+    if (consumerId < 0 || consumerId >= MaxConsumers) return false;
+    Consumer& consumer = m_consumers[consumerId];
+    if (!consumer.active.load()) return false;
+
+    for (;;) {
+        const quint64 head = m_head.load();
+        const quint64 cursor = consumer.cursor.load();
+        if (cursor >= head) return false;
+
+        quint64 target = cursor;
+        if (consumer.policy.load() == LatestOnly)
+            target = head - 1;
+        else if (head - cursor > quint64(m_capacity))
+            target = head - m_capacity;     // 落后太多，最旧的已被覆盖
+
+        if (readSlot(target, frame)) {
+            consumer.dropped.fetch_add(target - cursor);
+            consumer.consumed.fetch_add(1);
+            consumer.cursor.store(target + 1);
+            return true;
+        }
+        // 读取期间被生产者覆盖，用新的队首重试
+    }
+}
+
+bool FrameRing::waitPop(int consumerId, FrameHandle& frame, int timeoutMs)
+{
+    if (pop(consumerId, frame)) return true;
+
+    QDeadlineTimer deadline(timeoutMs);
+    m_waiters.fetch_add(1);
+    bool ok = false;
+    {
+        QMutexLocker locker(&m_waitMutex);
+        while (!(ok = pop(consumerId, frame))) {
+            if (!m_frameAvailable.wait(&m_waitMutex, deadline)) {
+                ok = pop(consumerId, frame);
+                break;
+            }
+        }
+    }
+    m_waiters.fetch_sub(1);
+    return ok;
+}
+
+bool FrameRing::peekLatest(FrameHandle& frame) const
+{
+    for (;;) {
+        const quint64 head = m_head.load();
+        if (head == 0) return false;
+        if (readSlot(head - 1, frame)) return true;
+        if (m_slots[(head - 1) % m_capacity].buffer.load() == nullptr) return false;
+    }
+}
+
+FrameRing::ConsumerStats FrameRing::stats(int consumerId) const
+{
+    ConsumerStats out;
+    if (consumerId < 0 || consumerId >= MaxConsumers) return out;
+    const Consumer& consumer = m_consumers[consumerId];
+    {
+        QMutexLocker locker(&m_registerMutex);
+        out.name = consumer.name;
+    }
+    out.policy   = static_cast<Policy>(consumer.policy.load());
+    out.consumed = consumer.consumed.load();
+    out.dropped  = consumer.dropped.load();
+    const quint64 head = m_head.load();
+    const quint64 cursor = consumer.cursor.load();
+    out.lag = head > cursor ? head - cursor : 0;
+    return out;
+}
+
+QList<FrameRing::ConsumerStats> FrameRing::allStats() const
+{
+    QList<ConsumerStats> list;
+    for (int i = 0; i < MaxConsumers; ++i) {
+        if (m_consumers[i].active.load())
+            list.append(stats(i));
+    }
+    return list;
+}
+
+void FrameRing::clear()
+{
+    for (Slot& slot : m_slots) {
+        slot.seq.store(0);
+        FrameHandle previous(slot.buffer.exchange(nullptr));
+    }
+    const quint64 head = m_head.load();
+    for (Consumer& consumer : m_consumers)
+        consumer.cursor.store(head);
+}
@@ -0,0 +1,97 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <vector>
+#include "frame_pool.h"
+
+// 单生产者多消费者无锁帧环形队列
+// 队列中存放缓存槽引用，每个消费者有独立读游标和丢帧策略，
+// 慢消费者只会丢自己的帧，不会拖住预览或录制
+// 注意：环形队列中的帧来自 FramePool，需在池释放前 clear()
+class FrameRing
+{
+public:
+    enum Policy {
+        LatestOnly,     // 只取最新帧，中间的全部跳过
+        DropOldest,     // 按顺序取，落后超过容量时丢最旧的
+        Block           // 按顺序取，未读完时生产者等待
+    };
+
+    struct ConsumerStats {
+        QString name;
+        Policy  policy = LatestOnly;
+        quint64 consumed = 0;   // 已取帧数
+        quint64 dropped = 0;    // 丢帧数
+        quint64 lag = 0;        // 当前落后帧数
+    };
+
+    static const int MaxConsumers = 8;
+
+    explicit FrameRing(int capacity = 4);
+    ~FrameRing();
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    int capacity() const { return m_capacity; }
+
+    // 注册/注销消费者，返回消费者 id，已满时返回 -1
+    int addConsumer(const QString& name, Policy policy);
+    void removeConsumer(int consumerId);
+    // 当前注册的消费者数，生产者据此决定是否发布可选的流（如原始帧）
+    int consumerCount() const { return m_consumerCount.load(); }
+
+    // 生产者：发布一帧；有 Block 消费者未读完时最多等待 blockTimeoutMs，超时则丢弃本帧
+    bool push(const FrameHandle& frame, int blockTimeoutMs = 100);
+
+    // 消费者：非阻塞取帧 / 阻塞等待取帧
+    bool pop(int consumerId, FrameHandle& frame);
+    bool waitPop(int consumerId, FrameHandle& frame, int timeoutMs);
+
+    // 不占游标地读取最新一帧
+    bool peekLatest(FrameHandle& frame) const;
+
+    ConsumerStats stats(int consumerId) const;
+    QList<ConsumerStats> allStats() const;
+    quint64 producerDropped() const { return m_producerDropped.load(); }
+
+    // 释放队列中的全部引用（生产者停止后调用）
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<quint64>      seq{0};       // 已发布时为 位置+1，写入中为 0
+        std::atomic<FrameBuffer*> buffer{nullptr};
+    };
+
+    struct Consumer {
+        std::atomic<bool>    active{false};
+        std::atomic<int>     policy{LatestOnly};
+        std::atomic<quint64> cursor{0};         // 下一个要读的位置
+        std::atomic<quint64> consumed{0};
+        std::atomic<quint64> dropped{0};
+        QString              name;              // 仅在注册锁内修改
+    };
+
+    bool readSlot(quint64 position, FrameHandle& frame) const;
+    bool blockedBy(quint64 position) const;
+
+    const int            m_capacity;
+    std::vector<Slot>    m_slots;
+    Consumer             m_consumers[MaxConsumers];
+    std::atomic<quint64> m_head{0};             // 下一个写入位置
+    std::atomic<quint64> m_producerDropped{0};
+    std::atomic<int>     m_consumerCount{0};
+
+    // 仅用于消费者睡眠等待，数据路径本身不加锁
+    mutable QMutex       m_registerMutex;
+    QMutex               m_waitMutex;
+    QWaitCondition       m_frameAvailable;
+    std::atomic<int>     m_waiters{0};
+};
+
+#endif // FRAME_RING_H
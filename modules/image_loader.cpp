@@ -0,0 +1,175 @@
+#include "image_loader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QImageReader>
+
+static void releaseMat(void* info)
+{
+    delete static_cast<cv::Mat*>(info);
+}
+
+// 经 QFile 读入后 imdecode：路径含中文时 cv::imread 在 Windows 上无法打开
+static cv::Mat decodeFile(const QString& path, int flags)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return cv::Mat();
+    const QByteArray bytes = file.readAll();
+    if (bytes.isEmpty()) return cv::Mat();
+    const cv::Mat buffer(1, int(bytes.size()), CV_8UC1, const_cast<char*>(bytes.constData()));
+    return cv::imdecode(buffer, flags);
+}
+
+ImageLoader::ImageLoader(QObject* parent)
+    : QObject(parent)
+    , m_pending(0)
+    , m_loaded(0)
+    , m_failed(0)
+    , m_abort(0)
+    , m_generation(0)
+{
+    qRegisterMetaType<ImageLoader::Result>();
+}
+
+ImageLoader::~ImageLoader()
+{
+    m_abort.storeRelease(1);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool ImageLoader::start(const QStringList& paths, const Options& options)
+{
+    if (isLoading() || paths.isEmpty()) return false;
+
+    m_options = options;
+    m_abort.storeRelease(0);
+    m_loaded.storeRelease(0);
+    m_failed.storeRelease(0);
+    m_pending.storeRelease(paths.size());
+    const int generation = m_generation.fetchAndAddOrdered(1) + 1;
+    m_clock.start();
+    for (int i = 0; i < paths.size(); ++i) {
+        const QString path = paths[i];
+        m_pool.start([this, i, path, generation]() { loadOne(i, path, generation); });
+    }
+    return true;
+}
+
+void ImageLoader::cancel()
+{
+    if (!isLoading()) return;
+    m_abort.storeRelease(1);
+    m_pool.clear();             // 未开始的任务直接丢弃
+    m_pool.waitForDone();       // 正在解码的最多每线程一张
+    m_pending.storeRelease(0);
+    // 经事件队列发出：工作线程已排队的 imageLoaded 先于 finished 送达，接收方在 finished 中看到的是完整结果
+    const int loaded = m_loaded.loadAcquire();
+    const int failed = m_failed.loadAcquire();
+    const qint64 elapsed = m_clock.elapsed();
+    QMetaObject::invokeMethod(this, [this, loaded, failed, elapsed]() {
+        emit finished(loaded, failed, elapsed, true);
+    }, Qt::QueuedConnection);
+}
+
+void ImageLoader::loadOne(int index, const QString& path, int generation)
+{
+    if (m_abort.loadAcquire() || generation != m_generation.loadAcquire()) return;
+
+    Result result;
+    result.index = index;
+    result.path  = path;
+    if (m_options.headerOnly)
+        result.size = probeSize(path);
+    if (result.size.empty()) {
+        result.image = decode(path, m_options.keep16Bit, m_options.keepColor);
+        result.size  = result.image.size();
+    }
+    if (result.size.empty()) {
+        m_failed.fetchAndAddRelaxed(1);
+        emit imageFailed(path);
+    } else {
+        // 已有全分辨率图像，缩小比再解码一次便宜
+        if (m_options.thumbnailWidth > 0 && !result.image.empty())
+            result.thumbnail = thumbnail(result.image, m_options.thumbnailWidth);
+        result.timestamp = QFileInfo(path).lastModified().toString("yyyy-MM-dd HH:mm:ss");
+        m_loaded.fetchAndAddRelaxed(1);
+        emit imageLoaded(result);
+    }
+
+    // 最后一个任务报告完成；已取消时由 cancel() 报告
+    if (m_pending.fetchAndSubOrdered(1) == 1 && !m_abort.loadAcquire())
+        emit finished(m_loaded.loadAcquire(), m_failed.loadAcquire(), m_clock.elapsed(), false);
+}
+
+cv::Size ImageLoader::probeSize(const QString& path)
+{
+    QImageReader reader(path);
+    QSize size = reader.size();
+    if (!size.isValid()) return cv::Size();
+    // imdecode 按 EXIF 方向旋转，尺寸与之保持一致
+    if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+        size.transpose();
+    return cv::Size(size.width(), size.height());
+}
+
+cv::Mat ImageLoader::decode(const QString& path, bool keep16Bit, bool keepColor)
+{
+    int flags = keepColor ? cv::IMREAD_ANYCOLOR : cv::IMREAD_GRAYSCALE;
+    if (keep16Bit && !keepColor) flags |= cv::IMREAD_ANYDEPTH;    // 彩色原图统一为 8 位 BGR
+    cv::Mat image = decodeFile(path, flags);
+    if (image.empty() || image.depth() == CV_8U || image.depth() == CV_16U) return image;
+    // 其他位深（如 32 位浮点 TIFF）按 8 位归一化
+    cv::Mat gray;
+    cv::normalize(image, gray, 0, 255, cv::NORM_MINMAX, CV_8U);
+    return gray;
+}
+
+cv::Mat ImageLoader::decodeThumbnail(const QString& path, int maxWidth)
+{
+    if (maxWidth <= 0) return decode(path, false);
+    // 只读文件头取尺寸，选择不小于目标宽度的最大缩小倍数
+    int factor = 1;
+    const QSize size = QImageReader(path).size();
+    if (size.isValid()) {
+        while (factor < 8 && size.width() / (factor * 2) >= maxWidth) factor *= 2;
+    }
+    int flags = cv::IMREAD_GRAYSCALE;
+    if (factor == 2) flags = cv::IMREAD_REDUCED_GRAYSCALE_2;
+    else if (factor == 4) flags = cv::IMREAD_REDUCED_GRAYSCALE_4;
+    else if (factor == 8) flags = cv::IMREAD_REDUCED_GRAYSCALE_8;
+
+    cv::Mat image = decodeFile(path, flags);
+    if (image.empty() || image.cols <= maxWidth) return image;
+    cv::Mat small;
+    const double scale = double(maxWidth) / image.cols;
+    cv::resize(image, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    return small;
+}
+
+QImage ImageLoader::thumbnail(const cv::Mat& image, int maxWidth)
+{
+    if (image.empty() || maxWidth <= 0) return QImage();
+    cv::Mat small = image;
+    if (small.channels() == 3)
+        cv::cvtColor(small, small, cv::COLOR_BGR2GRAY);
+    if (small.cols > maxWidth) {
+        const double scale = double(maxWidth) / small.cols;
+        cv::resize(small, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    if (small.depth() == CV_16U)
+        small.convertTo(small, CV_8U, 1.0 / 256);
+    else if (small.data == image.data)
+        small = small.clone();          // 不缩小时也不引用全分辨率像素
+    return grayView(small);
+}
+
+QImage ImageLoader::grayView(const cv::Mat& gray)
+{
+    if (gray.empty()) return QImage();
+    QImage::Format format;
+    if (gray.type() == CV_8UC1) format = QImage::Format_Grayscale8;
+    else if (gray.type() == CV_16UC1) format = QImage::Format_Grayscale16;
+    else return QImage();
+    return QImage(gray.data, gray.cols, gray.rows, int(gray.step), format, releaseMat, new cv::Mat(gray));
+}
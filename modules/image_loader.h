@@ -0,0 +1,78 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QStringList>
+#include <QImage>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <opencv2/opencv.hpp>
+
+// 并行图像加载：线程池中每个文件按 imread 标志直接解码为灰度（8 位，16 位文件保持 16 位），
+// 不经 QImage/RGB/BGR 中转（选择保留彩色原图时彩色文件解码为 BGR）；每张完成即在工作线程中发出 imageLoaded，界面逐张加入数据集
+// 取消时丢弃未开始的任务，等待正在解码的任务结束
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        bool keep16Bit = true;          // 16 位文件保持 16 位灰度，否则取高 8 位
+        bool keepColor = false;         // 彩色文件保持 8 位 BGR，否则直接解码为灰度
+        int  thumbnailWidth = 0;        // >0 时同时生成缩略图
+        bool headerOnly = false;        // 只读文件头取尺寸，像素留待使用时解码；文件头读不出尺寸时仍完整解码
+    };
+
+    struct Result {
+        int     index = 0;              // 在文件列表中的序号
+        QString path;
+        cv::Mat image;                  // 8/16 位灰度（或 BGR）；headerOnly 时通常为空
+        cv::Size size;                  // 图像尺寸（已按 EXIF 方向旋转）
+        QImage  thumbnail;
+        QString timestamp;              // 文件修改时间
+    };
+
+    explicit ImageLoader(QObject* parent = nullptr);
+    ~ImageLoader() override;
+
+    bool start(const QStringList& paths, const Options& options = Options());
+    void cancel();
+    bool isLoading() const { return m_pending.loadAcquire() > 0; }
+    const Options& options() const { return m_options; }
+
+    // 可在任意线程调用
+    // 只读文件头；无法识别时返回空尺寸
+    static cv::Size probeSize(const QString& path);
+    static cv::Mat decode(const QString& path, bool keep16Bit = true, bool keepColor = false);
+    // 降分辨率解码（JPEG 在解码阶段直接缩小），得到宽度不小于 maxWidth 的最小缩小倍数
+    static cv::Mat decodeThumbnail(const QString& path, int maxWidth);
+    // 已解码的图像（8/16 位灰度或 BGR）缩小为宽度不超过 maxWidth 的灰度缩略图
+    static QImage thumbnail(const cv::Mat& image, int maxWidth);
+    // 灰度 Mat 的 QImage 视图（缩略图用），持有 Mat 的引用
+    static QImage grayView(const cv::Mat& gray);
+
+signals:
+    // 在工作线程中发出
+    void imageLoaded(const ImageLoader::Result& result);
+    void imageFailed(const QString& path);
+    // 全部完成或取消后发出，总在本次加载的最后一个 imageLoaded / imageFailed 之后（取消时经本对象所在线程的事件队列发出）
+    void finished(int loaded, int failed, qint64 elapsedMs, bool canceled);
+
+private:
+    void loadOne(int index, const QString& path, int generation);
+
+    QThreadPool m_pool;
+    Options     m_options;
+    QAtomicInt  m_pending;
+    QAtomicInt  m_loaded;
+    QAtomicInt  m_failed;
+    QAtomicInt  m_abort;
+    QAtomicInt  m_generation;
+    QElapsedTimer m_clock;
+};
+
+Q_DECLARE_METATYPE(ImageLoader::Result)
+
+#endif // IMAGE_LOADER_H
@@ -0,0 +1,233 @@
+#include "node_map.h"
+#include <QElapsedTimer>
+#include <cmath>
+
+NodeMap::NodeMap(CMvCamera* camera, QObject* parent)
+    : QObject(parent)
+    , m_camera(camera)
+{
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+NodeMap::~NodeMap()
+{
+    wait();
+}
+
+void NodeMap::declare(const QString& name, Type type, int flags)
+{
+    QMutexLocker locker(&m_mutex);
+    if (indexOf(name) >= 0) return;
+    Node node;
+    node.name  = name;
+    node.type  = type;
+    node.flags = flags;
+    m_nodes.push_back(node);
+    m_dirty.push_back(1);
+}
+
+int NodeMap::indexOf(const QString& name) const
+{
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].name == name) return int(i);
+    }
+    return -1;
+}
+
+bool NodeMap::value(const QString& name, double* out) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int index = indexOf(name);
+    if (index < 0 || !m_nodes[index].available) return false;
+    if (out) *out = m_nodes[index].value;
+    return true;
+}
+
+NodeMap::Node NodeMap::node(const QString& name) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int index = indexOf(name);
+    return index < 0 ? Node() : m_nodes[index];
+}
+
+bool NodeMap::set(const QString& name, double value)
+{
+    QMutexLocker locker(&m_mutex);
+    const int index = indexOf(name);
+    if (index < 0) return false;
+
+    const Node& node = m_nodes[index];
+    if (node.available && node.max > node.min) {
+        value = qBound(node.min, value, node.max);
+        if (node.type == Int && node.inc > 1)
+            value = node.min + std::floor((value - node.min) / node.inc) * node.inc;
+    }
+    if (node.type != Float)
+        value = std::round(value);
+    m_pending.insert(index, value);
+    return true;
+}
+
+bool NodeMap::hasPending() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_pending.isEmpty();
+}
+
+void NodeMap::apply()
+{
+    m_applyRequested = true;
+    schedule();
+}
+
+void NodeMap::refresh(bool all)
+{
+    m_refreshRequested = true;
+    m_refreshAll = m_refreshAll || all;
+    schedule();
+}
+
+void NodeMap::wait()
+{
+    m_applyRequested = m_refreshRequested = m_refreshAll = false;
+    if (!m_busy) return;
+    m_pool.waitForDone();
+    ++m_generation;
+    m_busy = false;
+}
+
+// 同一时刻只有一个批处理，期间的请求在结束时合并为下一批
+void NodeMap::schedule()
+{
+    if (m_busy || (!m_applyRequested && !m_refreshRequested)) return;
+
+    auto batch = std::make_shared<Batch>();
+    batch->write      = m_applyRequested;
+    batch->refreshAll = m_refreshAll;
+    m_applyRequested = m_refreshRequested = m_refreshAll = false;
+
+    m_busy = true;
+    const int generation = m_generation;
+    m_pool.start([this, batch, generation]() {
+        runBatch(*batch);
+        QMetaObject::invokeMethod(this, [this, batch, generation]() {
+            if (generation != m_generation) return;     // wait() 已回收
+            m_busy = false;
+            if (batch->write)
+                emit applied(batch->written, batch->errors, batch->elapsedUs);
+            emit refreshed();
+            schedule();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void NodeMap::runBatch(Batch& batch)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 取出待写值和节点快照，SDK 调用期间不持锁
+    QMap<int, double> pending;
+    std::vector<Node> nodes;
+    std::vector<char> dirty;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (batch.write)
+            pending.swap(m_pending);
+        nodes = m_nodes;
+        dirty = m_dirty;
+    }
+
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        Node& node = nodes[it.key()];
+        // 值未变且缓存可信时不再写
+        if (node.available && !dirty[it.key()] && node.value == it.value()) continue;
+        node.lastError = writeNode(node, it.value());
+        if (node.lastError == MV_OK) {
+            ++batch.written;
+        } else {
+            batch.errors.append(QString("%1: 0x%2").arg(node.name)
+                                    .arg(static_cast<unsigned int>(node.lastError), 0, 16));
+        }
+        dirty[it.key()] = 1;        // 回读设备实际取整后的值
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        Node& node = nodes[i];
+        const bool needed = batch.refreshAll || dirty[i] || (node.flags & Volatile)
+                            || (batch.written > 0 && (node.flags & Dependent));
+        if (!needed) continue;
+        const int ret = readNode(node);
+        node.available = ret == MV_OK;
+        if (ret != MV_OK && node.lastError == MV_OK)
+            node.lastError = ret;
+        dirty[i] = 0;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        // 本批进行中新设置的值留在 m_pending，由下一批写入
+        m_nodes = nodes;
+        m_dirty = dirty;
+    }
+    batch.elapsedUs = timer.nsecsElapsed() / 1000;
+}
+
+int NodeMap::readNode(Node& node)
+{
+    int ret = MV_E_SUPPORT;
+    switch (node.type) {
+    case Int: {
+        MVCC_INTVALUE_EX v{};
+        ret = m_camera->GetIntValue(node.name.toLatin1().constData(), &v);
+        if (ret == MV_OK) {
+            node.value = double(v.nCurValue);
+            node.min   = double(v.nMin);
+            node.max   = double(v.nMax);
+            node.inc   = double(v.nInc);
+        }
+        break;
+    }
+    case Float: {
+        MVCC_FLOATVALUE v{};
+        ret = m_camera->GetFloatValue(node.name.toLatin1().constData(), &v);
+        if (ret == MV_OK) {
+            node.value = v.fCurValue;
+            node.min   = v.fMin;
+            node.max   = v.fMax;
+        }
+        break;
+    }
+    case Enum: {
+        MVCC_ENUMVALUE v{};
+        ret = m_camera->GetEnumValue(node.name.toLatin1().constData(), &v);
+        if (ret == MV_OK)
+            node.value = v.nCurValue;
+        break;
+    }
+    case Bool: {
+        bool v = false;
+        ret = m_camera->GetBoolValue(node.name.toLatin1().constData(), &v);
+        if (ret == MV_OK) {
+            node.value = v ? 1 : 0;
+            node.min = 0;
+            node.max = 1;
+        }
+        break;
+    }
+    }
+    return ret;
+}
+
+int NodeMap::writeNode(const Node& node, double value)
+{
+    const QByteArray key = node.name.toLatin1();
+    switch (node.type) {
+    case Int:   return m_camera->SetIntValue(key.constData(), int64_t(value));
+    case Float: return m_camera->SetFloatValue(key.constData(), float(value));
+    case Enum:  return m_camera->SetEnumValue(key.constData(), static_cast<unsigned int>(value));
+    case Bool:  return m_camera->SetBoolValue(key.constData(), value != 0);
+    }
+    return MV_E_SUPPORT;
+}
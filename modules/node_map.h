@@ -0,0 +1,95 @@
+#ifndef NODE_MAP_H
+#define NODE_MAP_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMap>
+#include <QStringList>
+#include <vector>
+#include "cmvcamera.h"
+
+// 相机节点缓存：保存已声明节点的值和范围，界面只读缓存、不直接访问 SDK
+// set() 只记录待写值（同一节点多次设置合并为最后一次），apply() 在常驻的单线程池中
+// 按声明顺序一次写完，随后只回读写过的、标记为易变或依赖的节点
+class NodeMap : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Type { Int, Float, Enum, Bool };
+
+    enum Flag {
+        NoFlags   = 0,
+        Volatile  = 0x1,    // 值会自行变化（如 ResultingFrameRate），每批都回读
+        Dependent = 0x2,    // 范围随其他节点变化（如帧率上限随曝光），有写入时回读
+    };
+
+    struct Node {
+        QString name;
+        Type    type = Int;
+        int     flags = NoFlags;
+        bool    available = false;      // 读取成功过
+        double  value = 0;
+        double  min = 0;
+        double  max = 0;
+        double  inc = 0;                // 仅 Int
+        int     lastError = MV_OK;
+    };
+
+    explicit NodeMap(CMvCamera* camera, QObject* parent = nullptr);
+    ~NodeMap() override;
+
+    // 须在第一次 refresh/apply 之前声明完，声明顺序即写入顺序（如使能节点放在数值节点之前）
+    void declare(const QString& name, Type type, int flags = NoFlags);
+
+    // 读缓存，GUI 线程可随时调用
+    bool value(const QString& name, double* out) const;
+    Node node(const QString& name) const;
+
+    // 记录待写值；Int 节点按步长取整，已知范围时限幅
+    bool set(const QString& name, double value);
+    bool hasPending() const;
+
+    // 异步执行：写入全部待写值并回读；批处理进行中再次请求会在其结束后合并执行
+    void apply();
+    // 异步回读；all 为 false 时只读脏节点和易变节点
+    void refresh(bool all = false);
+    // 等待当前批处理结束（断开连接前调用）
+    void wait();
+
+signals:
+    // 一批写入完成：written 为实际写入的节点数，errors 为失败节点的说明
+    void applied(int written, const QStringList& errors, qint64 elapsedUs);
+    void refreshed();
+
+private:
+    struct Batch {
+        bool write = false;
+        bool refreshAll = false;
+        int  written = 0;
+        QStringList errors;
+        qint64 elapsedUs = 0;
+    };
+
+    void schedule();
+    void runBatch(Batch& batch);
+    int  readNode(Node& node);
+    int  writeNode(const Node& node, double value);
+    int  indexOf(const QString& name) const;
+
+    CMvCamera* m_camera;
+    QThreadPool m_pool;                 // 单线程且不过期，连续调参（如自动曝光）不反复创建线程
+    bool       m_busy = false;          // 有批处理在执行
+    int        m_generation = 0;        // wait() 加一，丢弃被回收批次的完成通知
+    bool       m_applyRequested = false;
+    bool       m_refreshRequested = false;
+    bool       m_refreshAll = false;
+
+    mutable QMutex m_mutex;             // 保护以下缓存和待写值
+    std::vector<Node> m_nodes;
+    std::vector<char> m_dirty;          // 下一批需回读
+    QMap<int, double> m_pending;        // 节点下标 -> 待写值，按下标有序
+};
+
+#endif // NODE_MAP_H
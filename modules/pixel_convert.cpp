@@ -0,0 +1,428 @@
+#include "pixel_convert.h"
+#include <QDebug>
+#include <opencv2/core/hal/intrin.hpp>
+
+namespace {
+
+enum BayerOrder { NotBayer, BayerRG, BayerGB, BayerGR, BayerBG };
+
+BayerOrder bayerOrder(unsigned int type)
+{
+    switch (type) {
+    case PixelType_Gvsp_BayerRG8:
+    case PixelType_Gvsp_BayerRG10:
+    case PixelType_Gvsp_BayerRG12:
+    case PixelType_Gvsp_BayerRG16:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerRG12_Packed:
+        return BayerRG;
+    case PixelType_Gvsp_BayerGB8:
+    case PixelType_Gvsp_BayerGB10:
+    case PixelType_Gvsp_BayerGB12:
+    case PixelType_Gvsp_BayerGB16:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerGB12_Packed:
+        return BayerGB;
+    case PixelType_Gvsp_BayerGR8:
+    case PixelType_Gvsp_BayerGR10:
+    case PixelType_Gvsp_BayerGR12:
+    case PixelType_Gvsp_BayerGR16:
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerGR12_Packed:
+        return BayerGR;
+    case PixelType_Gvsp_BayerBG8:
+    case PixelType_Gvsp_BayerBG10:
+    case PixelType_Gvsp_BayerBG12:
+    case PixelType_Gvsp_BayerBG16:
+    case PixelType_Gvsp_BayerBG10_Packed:
+    case PixelType_Gvsp_BayerBG12_Packed:
+        return BayerBG;
+    default:
+        return NotBayer;
+    }
+}
+
+// GenICam 按首行前两个像素命名 Bayer 排列，OpenCV 按第二行第二、三个像素命名，
+// 所以 GenICam 的 RG 对应 OpenCV 的 BG，依此类推
+int bayerGrayCode(BayerOrder order)
+{
+    switch (order) {
+    case BayerRG: return cv::COLOR_BayerBG2GRAY;
+    case BayerGB: return cv::COLOR_BayerGR2GRAY;
+    case BayerGR: return cv::COLOR_BayerGB2GRAY;
+    case BayerBG: return cv::COLOR_BayerRG2GRAY;
+    default:      return -1;
+    }
+}
+
+// GVSP Packed 每 2 个像素 3 字节，首尾字节恰好是两个像素的高 8 位，10/12 位通用
+void packedHigh8(const uchar* src, uchar* dst, size_t pixels)
+{
+    const size_t pairs = pixels / 2;
+    size_t i = 0;
+#if CV_SIMD128
+    for (; i + 16 <= pairs; i += 16) {
+        cv::v_uint8x16 a, b, c;
+        cv::v_load_deinterleave(src + 3 * i, a, b, c);
+        cv::v_store_interleave(dst + 2 * i, a, c);
+    }
+#endif
+    for (; i < pairs; ++i) {
+        dst[2 * i]     = src[3 * i];
+        dst[2 * i + 1] = src[3 * i + 2];
+    }
+    if (pixels & 1)
+        dst[pixels - 1] = src[3 * pairs];
+}
+
+// GVSP Packed 解包为 16 位：
+//   Mono12Packed  b0=p0[11:4]  b1=p1[3:0]<<4 | p0[3:0]  b2=p1[11:4]
+//   Mono10Packed  b0=p0[9:2]   b1=p1[1:0]<<4 | p0[1:0]  b2=p1[9:2]
+// OutShift 为输出左移位数（0 保持原值，16-Bits 为高位对齐）
+template <int Bits, int OutShift>
+void packedTo16(const uchar* src, ushort* dst, size_t pixels)
+{
+    const int lowBits = Bits - 8;
+    const ushort lowMask = ushort((1 << lowBits) - 1);
+    const size_t pairs = pixels / 2;
+    size_t i = 0;
+#if CV_SIMD128
+    const cv::v_uint16x8 mask = cv::v_setall_u16(lowMask);
+    for (; i + 16 <= pairs; i += 16) {
+        cv::v_uint8x16 a, b, c;
+        cv::v_load_deinterleave(src + 3 * i, a, b, c);
+        cv::v_uint16x8 a0, a1, b0, b1, c0, c1;
+        cv::v_expand(a, a0, a1);
+        cv::v_expand(b, b0, b1);
+        cv::v_expand(c, c0, c1);
+
+        cv::v_uint16x8 p0 = cv::v_shl<OutShift>(cv::v_shl<Bits - 8>(a0) | (b0 & mask));
+        cv::v_uint16x8 p1 = cv::v_shl<OutShift>(cv::v_shl<Bits - 8>(c0) | (cv::v_shr<4>(b0) & mask));
+        cv::v_store_interleave(dst + 2 * i, p0, p1);
+
+        p0 = cv::v_shl<OutShift>(cv::v_shl<Bits - 8>(a1) | (b1 & mask));
+        p1 = cv::v_shl<OutShift>(cv::v_shl<Bits - 8>(c1) | (cv::v_shr<4>(b1) & mask));
+        cv::v_store_interleave(dst + 2 * i + 16, p0, p1);
+    }
+#endif
+    for (; i < pairs; ++i) {
+        const uchar* s = src + 3 * i;
+        dst[2 * i]     = ushort(((s[0] << lowBits) | (s[1] & lowMask)) << OutShift);
+        dst[2 * i + 1] = ushort(((s[2] << lowBits) | ((s[1] >> 4) & lowMask)) << OutShift);
+    }
+    if (pixels & 1) {
+        const uchar* s = src + 3 * pairs;
+        dst[pixels - 1] = ushort(((s[0] << lowBits) | (s[1] & lowMask)) << OutShift);
+    }
+}
+
+// Bayer 半分辨率绿通道：每个 2x2 单元取两个绿像素的均值
+// phase 0: 绿像素在 (0,0)(1,1)，即 GR/GB；phase 1: 在 (0,1)(1,0)，即 RG/BG
+void greenHalf8(const cv::Mat& raw, cv::Mat& dst, int phase)
+{
+    const int outW = dst.cols;
+    for (int y = 0; y < dst.rows; ++y) {
+        const uchar* r0 = raw.ptr<uchar>(2 * y);
+        const uchar* r1 = raw.ptr<uchar>(2 * y + 1);
+        uchar* out = dst.ptr<uchar>(y);
+        int x = 0;
+#if CV_SIMD128
+        for (; x + 16 <= outW; x += 16) {
+            cv::v_uint8x16 e0, o0, e1, o1;
+            cv::v_load_deinterleave(r0 + 2 * x, e0, o0);
+            cv::v_load_deinterleave(r1 + 2 * x, e1, o1);
+            cv::v_store(out + x, phase == 0 ? cv::v_avg(e0, o1) : cv::v_avg(o0, e1));
+        }
+#endif
+        for (; x < outW; ++x) {
+            const int g0 = phase == 0 ? r0[2 * x] : r0[2 * x + 1];
+            const int g1 = phase == 0 ? r1[2 * x + 1] : r1[2 * x];
+            out[x] = uchar((g0 + g1 + 1) >> 1);
+        }
+    }
+}
+
+// 16 位 Bayer 的半分辨率绿通道，同时右移到 8 位
+void greenHalf16(const cv::Mat& raw, cv::Mat& dst, int phase, int shift)
+{
+    const int outW = dst.cols;
+    const int round = 1 << shift;
+    for (int y = 0; y < dst.rows; ++y) {
+        const ushort* r0 = raw.ptr<ushort>(2 * y);
+        const ushort* r1 = raw.ptr<ushort>(2 * y + 1);
+        uchar* out = dst.ptr<uchar>(y);
+        for (int x = 0; x < outW; ++x) {
+            const int g0 = phase == 0 ? r0[2 * x] : r0[2 * x + 1];
+            const int g1 = phase == 0 ? r1[2 * x + 1] : r1[2 * x];
+            out[x] = cv::saturate_cast<uchar>((g0 + g1 + round) >> (shift + 1));
+        }
+    }
+}
+
+} // namespace
+
+/*-------------------------------- 格式信息 --------------------------------*/
+bool PixelConverter::isBayer(unsigned int pixelType)
+{
+    return bayerOrder(pixelType) != NotBayer;
+}
+
+bool PixelConverter::isPacked(unsigned int pixelType)
+{
+    switch (pixelType) {
+    case PixelType_Gvsp_Mono10_Packed:
+    case PixelType_Gvsp_Mono12_Packed:
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerBG10_Packed:
+    case PixelType_Gvsp_BayerGR12_Packed:
+    case PixelType_Gvsp_BayerRG12_Packed:
+    case PixelType_Gvsp_BayerGB12_Packed:
+    case PixelType_Gvsp_BayerBG12_Packed:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int PixelConverter::sampleBits(unsigned int pixelType)
+{
+    switch (pixelType) {
+    case PixelType_Gvsp_Mono8:
+    case PixelType_Gvsp_BayerGR8:
+    case PixelType_Gvsp_BayerRG8:
+    case PixelType_Gvsp_BayerGB8:
+    case PixelType_Gvsp_BayerBG8:
+        return 8;
+    case PixelType_Gvsp_Mono10:
+    case PixelType_Gvsp_Mono10_Packed:
+    case PixelType_Gvsp_BayerGR10:
+    case PixelType_Gvsp_BayerRG10:
+    case PixelType_Gvsp_BayerGB10:
+    case PixelType_Gvsp_BayerBG10:
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerBG10_Packed:
+        return 10;
+    case PixelType_Gvsp_Mono12:
+    case PixelType_Gvsp_Mono12_Packed:
+    case PixelType_Gvsp_BayerGR12:
+    case PixelType_Gvsp_BayerRG12:
+    case PixelType_Gvsp_BayerGB12:
+    case PixelType_Gvsp_BayerBG12:
+    case PixelType_Gvsp_BayerGR12_Packed:
+    case PixelType_Gvsp_BayerRG12_Packed:
+    case PixelType_Gvsp_BayerGB12_Packed:
+    case PixelType_Gvsp_BayerBG12_Packed:
+        return 12;
+    case PixelType_Gvsp_Mono16:
+    case PixelType_Gvsp_BayerGR16:
+    case PixelType_Gvsp_BayerRG16:
+    case PixelType_Gvsp_BayerGB16:
+    case PixelType_Gvsp_BayerBG16:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+bool PixelConverter::isSupported(unsigned int pixelType)
+{
+    return sampleBits(pixelType) != 0;
+}
+
+size_t PixelConverter::rawFrameBytes(unsigned int pixelType, int width, int height)
+{
+    const size_t pixels = size_t(width) * size_t(height);
+    if (isPacked(pixelType)) return (pixels * 3 + 1) / 2;
+    if (sampleBits(pixelType) > 8) return pixels * 2;
+    return pixels;
+}
+
+/*-------------------------------- 配置 --------------------------------*/
+void PixelConverter::reset()
+{
+    m_kernel = nullptr;
+    m_pixelType = 0;
+    m_width = m_height = 0;
+    m_passthrough = false;
+    m_outputSize = cv::Size();
+}
+
+bool PixelConverter::configure(unsigned int pixelType, int width, int height, OutputMode mode)
+{
+    reset();
+    if (!isSupported(pixelType) || width <= 0 || height <= 0) return false;
+    if (mode == GreenHalf && (width < 2 || height < 2)) return false;
+
+    m_pixelType = pixelType;
+    m_width = width;
+    m_height = height;
+    m_mode = mode;
+    m_bits = sampleBits(pixelType);
+
+    const BayerOrder order = bayerOrder(pixelType);
+    m_bayerGrayCode = bayerGrayCode(order);
+    m_greenPhase = (order == BayerGR || order == BayerGB) ? 0 : 1;
+
+    m_outputSize = mode == GreenHalf ? cv::Size(width / 2, height / 2) : cv::Size(width, height);
+    m_outputType = mode == Gray16 ? CV_16UC1 : CV_8UC1;
+    m_passthrough = pixelType == PixelType_Gvsp_Mono8 && mode == Gray8;
+
+    if (order != NotBayer) {
+        if (isPacked(pixelType))  m_kernel = &PixelConverter::convertBayerPacked;
+        else if (m_bits == 8)     m_kernel = &PixelConverter::convertBayer8;
+        else                      m_kernel = &PixelConverter::convertBayer16;
+    } else {
+        if (isPacked(pixelType))  m_kernel = &PixelConverter::convertPacked;
+        else if (m_bits == 8)     m_kernel = &PixelConverter::convertMono8;
+        else                      m_kernel = &PixelConverter::convertMono16;
+    }
+    return true;
+}
+
+bool PixelConverter::matches(unsigned int pixelType, int width, int height) const
+{
+    return m_kernel && m_pixelType == pixelType && m_width == width && m_height == height;
+}
+
+size_t PixelConverter::outputBytes() const
+{
+    return size_t(m_outputSize.area()) * CV_ELEM_SIZE(m_outputType);
+}
+
+bool PixelConverter::convert(const unsigned char* src, cv::Mat& dst)
+{
+    if (!m_kernel || !src) return false;
+    dst.create(m_outputSize, m_outputType);     // 缓存池视图尺寸一致时不会重新分配
+    try {
+        (this->*m_kernel)(src, dst);
+    } catch (const cv::Exception& e) {
+        qWarning("Pixel conversion failed: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+/*-------------------------------- 转换内核 --------------------------------*/
+void PixelConverter::convertMono8(const unsigned char* src, cv::Mat& dst)
+{
+    const cv::Mat raw(m_height, m_width, CV_8UC1, const_cast<unsigned char*>(src));
+    switch (m_mode) {
+    case Gray8:     raw.copyTo(dst); break;
+    case Gray16:    raw.convertTo(dst, CV_16U, 256.0); break;
+    case GreenHalf: cv::resize(raw, dst, m_outputSize, 0, 0, cv::INTER_AREA); break;
+    }
+}
+
+void PixelConverter::convertMono16(const unsigned char* src, cv::Mat& dst)
+{
+    const cv::Mat raw(m_height, m_width, CV_16UC1, const_cast<unsigned char*>(src));
+    const double to8 = 1.0 / (1 << (m_bits - 8));
+    switch (m_mode) {
+    case Gray8:
+        raw.convertTo(dst, CV_8U, to8);
+        break;
+    case Gray16:
+        if (m_bits == 16) raw.copyTo(dst);
+        else              raw.convertTo(dst, CV_16U, double(1 << (16 - m_bits)));
+        break;
+    case GreenHalf:
+        cv::resize(raw, m_scratch, m_outputSize, 0, 0, cv::INTER_AREA);
+        m_scratch.convertTo(dst, CV_8U, to8);
+        break;
+    }
+}
+
+void PixelConverter::convertPacked(const unsigned char* src, cv::Mat& dst)
+{
+    const size_t pixels = size_t(m_width) * m_height;
+    switch (m_mode) {
+    case Gray8:
+        if (dst.isContinuous()) {
+            packedHigh8(src, dst.data, pixels);
+        } else {
+            m_scratch.create(m_height, m_width, CV_8UC1);
+            packedHigh8(src, m_scratch.data, pixels);
+            m_scratch.copyTo(dst);
+        }
+        break;
+    case Gray16:
+        unpackTo16(src, dst, 16 - m_bits);
+        break;
+    case GreenHalf:
+        m_scratch.create(m_height, m_width, CV_8UC1);
+        packedHigh8(src, m_scratch.data, pixels);
+        cv::resize(m_scratch, dst, m_outputSize, 0, 0, cv::INTER_AREA);
+        break;
+    }
+}
+
+void PixelConverter::convertBayer8(const unsigned char* src, cv::Mat& dst)
+{
+    const cv::Mat raw(m_height, m_width, CV_8UC1, const_cast<unsigned char*>(src));
+    switch (m_mode) {
+    case Gray8:
+        cv::cvtColor(raw, dst, m_bayerGrayCode);
+        break;
+    case Gray16:
+        cv::cvtColor(raw, m_scratch, m_bayerGrayCode);
+        m_scratch.convertTo(dst, CV_16U, 256.0);
+        break;
+    case GreenHalf:
+        greenHalf8(raw, dst, m_greenPhase);
+        break;
+    }
+}
+
+void PixelConverter::convertBayer16(const unsigned char* src, cv::Mat& dst)
+{
+    const cv::Mat raw(m_height, m_width, CV_16UC1, const_cast<unsigned char*>(src));
+    bayer16ToOutput(raw, dst);
+}
+
+void PixelConverter::convertBayerPacked(const unsigned char* src, cv::Mat& dst)
+{
+    m_unpacked.create(m_height, m_width, CV_16UC1);
+    unpackTo16(src, m_unpacked, 0);
+    bayer16ToOutput(m_unpacked, dst);
+}
+
+void PixelConverter::unpackTo16(const unsigned char* src, cv::Mat& dst16, int outShift) const
+{
+    cv::Mat target = dst16.isContinuous() ? dst16 : cv::Mat(m_height, m_width, CV_16UC1);
+    ushort* out = target.ptr<ushort>();
+    const size_t pixels = size_t(m_width) * m_height;
+    if (m_bits == 12) {
+        if (outShift == 0) packedTo16<12, 0>(src, out, pixels);
+        else               packedTo16<12, 4>(src, out, pixels);
+    } else {
+        if (outShift == 0) packedTo16<10, 0>(src, out, pixels);
+        else               packedTo16<10, 6>(src, out, pixels);
+    }
+    if (target.data != dst16.data)
+        target.copyTo(dst16);
+}
+
+void PixelConverter::bayer16ToOutput(const cv::Mat& raw16, cv::Mat& dst)
+{
+    switch (m_mode) {
+    case Gray8:
+        cv::cvtColor(raw16, m_scratch, m_bayerGrayCode);
+        m_scratch.convertTo(dst, CV_8U, 1.0 / (1 << (m_bits - 8)));
+        break;
+    case Gray16:
+        if (m_bits == 16) {
+            cv::cvtColor(raw16, dst, m_bayerGrayCode);
+        } else {
+            cv::cvtColor(raw16, m_scratch, m_bayerGrayCode);
+            m_scratch.convertTo(dst, CV_16U, double(1 << (16 - m_bits)));
+        }
+        break;
+    case GreenHalf:
+        greenHalf16(raw16, dst, m_greenPhase, m_bits - 8);
+        break;
+    }
+}
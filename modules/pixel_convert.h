@@ -0,0 +1,73 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <opencv2/opencv.hpp>
+#include "MvCameraControl.h"
+
+// 像素格式转换：按 MvGvspPixelType 选定转换内核
+// configure() 只在像素格式或尺寸变化时调用，逐帧 convert() 不再做格式判断
+// 支持 Mono8/10/12/16（含 GVSP Packed）和全部四种 Bayer 相位的 8/10/12/16 位格式
+class PixelConverter
+{
+public:
+    enum OutputMode {
+        Gray8,          // 8 位灰度，高位截取
+        Gray16,         // 16 位灰度，有效位左对齐（Mono12 保留全部动态范围）
+        GreenHalf       // 半分辨率 8 位：Bayer 取两个绿像素均值，Mono 取 2x2 均值
+    };
+
+    PixelConverter() = default;
+
+    // 选定转换内核，不支持的格式返回 false
+    bool configure(unsigned int pixelType, int width, int height, OutputMode mode);
+    bool matches(unsigned int pixelType, int width, int height) const;
+    bool isConfigured() const { return m_kernel != nullptr; }
+    void reset();
+
+    // 原始数据即为输出（Mono8 -> Gray8），可直接引用源缓存
+    bool isPassthrough() const { return m_passthrough; }
+
+    cv::Size outputSize() const { return m_outputSize; }
+    int outputType() const { return m_outputType; }
+    size_t outputBytes() const;
+    OutputMode mode() const { return m_mode; }
+
+    // 转换一帧：src 为 SDK 原始数据，dst 需已按 outputSize/outputType 分配（可为缓存池视图）
+    bool convert(const unsigned char* src, cv::Mat& dst);
+
+    static bool isSupported(unsigned int pixelType);
+    static bool isBayer(unsigned int pixelType);
+    static bool isPacked(unsigned int pixelType);
+    static int sampleBits(unsigned int pixelType);
+    // 一帧原始数据的字节数
+    static size_t rawFrameBytes(unsigned int pixelType, int width, int height);
+
+private:
+    using Kernel = void (PixelConverter::*)(const unsigned char* src, cv::Mat& dst);
+
+    void convertMono8(const unsigned char* src, cv::Mat& dst);
+    void convertMono16(const unsigned char* src, cv::Mat& dst);
+    void convertPacked(const unsigned char* src, cv::Mat& dst);
+    void convertBayer8(const unsigned char* src, cv::Mat& dst);
+    void convertBayer16(const unsigned char* src, cv::Mat& dst);
+    void convertBayerPacked(const unsigned char* src, cv::Mat& dst);
+
+    void unpackTo16(const unsigned char* src, cv::Mat& dst16, int outShift) const;
+    void bayer16ToOutput(const cv::Mat& raw16, cv::Mat& dst);
+
+    Kernel       m_kernel = nullptr;
+    unsigned int m_pixelType = 0;
+    int          m_width = 0;
+    int          m_height = 0;
+    OutputMode   m_mode = Gray8;
+    int          m_bits = 8;
+    int          m_bayerGrayCode = 0;       // cv::cvtColor 的 Bayer->GRAY 代码
+    int          m_greenPhase = 0;          // 0: 绿像素在偶行偶列；1: 在偶行奇列
+    bool         m_passthrough = false;
+    cv::Size     m_outputSize;
+    int          m_outputType = CV_8UC1;
+    cv::Mat      m_scratch;                 // 中间结果，按流复用
+    cv::Mat      m_unpacked;                // Bayer Packed 解包结果
+};
+
+#endif // PIXEL_CONVERT_H
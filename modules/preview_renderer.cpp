@@ -0,0 +1,238 @@
+#include "preview_renderer.h"
+#include <QPainter>
+#include <QResizeEvent>
+#include <QDebug>
+#include "acquisition_engine.h"
+
+// 渲染结果缓存槽数：GUI 持有一帧、渲染一帧，另留一帧余量
+static const int PREVIEW_POOL_SIZE = 3;
+
+/*-------------------------------- PreviewRenderer --------------------------------*/
+PreviewRenderer::PreviewRenderer(QObject* parent)
+    : QObject(parent)
+    , m_abort(0)
+    , m_displayPending(0)
+    , m_targetSize(0)
+    , m_rendered(0)
+    , m_skipped(0)
+    , m_renderNs(0)
+{}
+
+PreviewRenderer::~PreviewRenderer()
+{
+    stop();
+}
+
+bool PreviewRenderer::start(std::shared_ptr<FrameRing> ring, std::shared_ptr<StreamTelemetry> telemetry)
+{
+    if (!ring || m_thread) return false;
+
+    m_consumerId = ring->addConsumer(QStringLiteral("preview"), FrameRing::LatestOnly);
+    if (m_consumerId < 0) return false;
+
+    m_ring = std::move(ring);
+    m_telemetry = std::move(telemetry);
+    m_abort.storeRelease(0);
+    m_displayPending.storeRelease(0);
+    m_rendered.storeRelease(0);
+    m_skipped.storeRelease(0);
+    m_renderNs.storeRelease(0);
+    m_clock.start();
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    return true;
+}
+
+void PreviewRenderer::stop()
+{
+    if (!m_thread) return;
+
+    m_abort.storeRelease(1);
+    if (!m_thread->wait(3000))
+        qDebug() << "Preview thread termination timed out.";
+    delete m_thread;
+    m_thread = nullptr;
+
+    m_ring->removeConsumer(m_consumerId);
+    m_consumerId = -1;
+    m_ring.reset();
+    m_telemetry.reset();
+    m_pool.release();           // 界面仍持有的帧在 QImage 释放时归还
+    m_poolSize = cv::Size();
+}
+
+void PreviewRenderer::setTargetSize(const QSize& size)
+{
+    const quint64 packed = (quint64(qMax(0, size.width())) << 32) | quint32(qMax(0, size.height()));
+    m_targetSize.storeRelease(packed);
+}
+
+void PreviewRenderer::frameDisplayed(qint64 hostTimestamp)
+{
+    if (m_telemetry && hostTimestamp > 0)
+        m_telemetry->recordStage(StreamTelemetry::ToDisplay,
+                                 AcquisitionEngine::hostTimestampUs() - hostTimestamp);
+    m_displayPending.storeRelease(0);
+}
+
+PreviewRenderer::Stats PreviewRenderer::stats() const
+{
+    Stats out;
+    out.rendered = m_rendered.loadAcquire();
+    out.skipped  = m_skipped.loadAcquire();
+    const double renderMs = m_renderNs.loadAcquire() / 1e6;
+    const double elapsedMs = m_clock.isValid() ? double(m_clock.elapsed()) : 0.0;
+    if (out.rendered > 0)
+        out.avgRenderMs = renderMs / out.rendered;
+    if (elapsedMs > 0) {
+        out.renderLoad = 100.0 * renderMs / elapsedMs;
+        out.displayFps = out.rendered * 1000.0 / elapsedMs;
+    }
+    return out;
+}
+
+void PreviewRenderer::run()
+{
+    while (!m_abort.loadAcquire()) {
+        FrameHandle frame;
+        if (!m_ring->waitPop(m_consumerId, frame, 100))
+            continue;
+
+        // GUI 还没显示完上一帧：跳过，等下一帧时再取最新的
+        if (m_displayPending.loadAcquire()) {
+            m_skipped.fetchAndAddRelaxed(1);
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        QImage image;
+        const qint64 hostTimestamp = frame.meta().hostTimestamp;
+        const bool ok = render(frame, image);
+        frame.reset();          // 源帧尽早归还缓存池
+        if (!ok) {
+            m_skipped.fetchAndAddRelaxed(1);
+            continue;
+        }
+        m_renderNs.fetchAndAddRelaxed(timer.nsecsElapsed());
+        m_rendered.fetchAndAddRelaxed(1);
+        if (m_telemetry)
+            m_telemetry->recordStage(StreamTelemetry::ToPreview,
+                                     AcquisitionEngine::hostTimestampUs() - hostTimestamp);
+
+        m_displayPending.storeRelease(1);
+        emit frameReady(image, hostTimestamp);
+    }
+}
+
+// 一次缩放直接从 SDK 缓存写入渲染缓存：缩小用 INTER_AREA，放大用 INTER_LINEAR
+bool PreviewRenderer::render(const FrameHandle& frame, QImage& out)
+{
+    const quint64 packed = m_targetSize.loadAcquire();
+    const int targetW = int(packed >> 32), targetH = int(packed & 0xFFFFFFFF);
+    if (targetW <= 0 || targetH <= 0) return false;
+
+    const cv::Mat src = frame.toMat();
+    if (src.empty() || (src.type() != CV_8UC1 && src.type() != CV_16UC1)) return false;
+
+    // 保持宽高比
+    const double scale = std::min(double(targetW) / src.cols, double(targetH) / src.rows);
+    const cv::Size size(std::max(1, cvRound(src.cols * scale)), std::max(1, cvRound(src.rows * scale)));
+    const size_t step = (size_t(size.width) + 3) & ~size_t(3);     // QImage 行按 4 字节对齐
+    if (size != m_poolSize) {
+        if (!m_pool.allocate(step * size.height, PREVIEW_POOL_SIZE)) return false;
+        m_poolSize = size;
+    }
+
+    FrameHandle target = m_pool.acquire();
+    if (target.isNull()) return false;      // 缓存都还在界面上
+
+    cv::Mat dst = target.toMat(size.height, size.width, CV_8UC1, step);
+    const int interpolation = scale < 1.0 ? cv::INTER_AREA : cv::INTER_LINEAR;
+    if (src.type() == CV_16UC1) {
+        cv::resize(src, m_scratch16, size, 0, 0, interpolation);
+        m_scratch16.convertTo(dst, CV_8U, 1.0 / 256);
+    } else {
+        cv::resize(src, dst, size, 0, 0, interpolation);
+    }
+
+    out = target.toQImage(size.width, size.height, int(step), QImage::Format_Grayscale8);
+    return !out.isNull();
+}
+
+/*-------------------------------- PreviewLabel --------------------------------*/
+PreviewLabel::PreviewLabel(QWidget* parent)
+    : QLabel(parent)
+{}
+
+void PreviewLabel::setFrame(const QImage& image)
+{
+    if (m_frame.isNull() && !text().isEmpty())
+        QLabel::clear();
+    m_frame = image;
+    update();
+}
+
+void PreviewLabel::clearFrame()
+{
+    m_frame = QImage();     // 释放对渲染缓存的引用
+    update();
+}
+
+void PreviewLabel::setOverlay(const QVector<QPointF>& corners, int columns)
+{
+    m_corners = corners;
+    m_columns = columns;
+    update();
+}
+
+void PreviewLabel::clearOverlay()
+{
+    if (m_corners.isEmpty()) return;
+    m_corners.clear();
+    update();
+}
+
+QSize PreviewLabel::targetSize() const
+{
+    return contentsRect().size() * devicePixelRatioF();
+}
+
+void PreviewLabel::paintEvent(QPaintEvent* event)
+{
+    QLabel::paintEvent(event);
+    if (m_frame.isNull()) return;
+
+    // 渲染器已按控件物理像素缩放，这里只做居中，不再重采样
+    const QSizeF logical = QSizeF(m_frame.size()) / devicePixelRatioF();
+    const QRect area = contentsRect();
+    const QPointF topLeft(area.x() + (area.width() - logical.width()) / 2.0,
+                          area.y() + (area.height() - logical.height()) / 2.0);
+    QPainter painter(this);
+    painter.drawImage(QRectF(topLeft, logical), m_frame);
+
+    if (m_corners.isEmpty() || m_columns <= 0) return;
+    // 与 cv::drawChessboardCorners 一致：按行连线，逐行变换颜色
+    auto toWidget = [&](const QPointF& p) {
+        return QPointF(topLeft.x() + p.x() * logical.width(), topLeft.y() + p.y() * logical.height());
+    };
+    painter.setRenderHint(QPainter::Antialiasing);
+    const int rows = m_corners.size() / m_columns;
+    QPointF previous;
+    for (int i = 0; i < m_corners.size(); ++i) {
+        const QColor color = QColor::fromHsv((i / m_columns) * 300 / qMax(1, rows), 255, 255);
+        const QPointF point = toWidget(m_corners[i]);
+        painter.setPen(QPen(color, 1.5));
+        if (i > 0)
+            painter.drawLine(previous, point);
+        painter.drawEllipse(point, 3.0, 3.0);
+        previous = point;
+    }
+}
+
+void PreviewLabel::resizeEvent(QResizeEvent* event)
+{
+    QLabel::resizeEvent(event);
+    emit targetSizeChanged(targetSize());
+}
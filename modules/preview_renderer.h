@@ -0,0 +1,104 @@
+#ifndef PREVIEW_RENDERER_H
+#define PREVIEW_RENDERER_H
+
+#include <QObject>
+#include <QThread>
+#include <QLabel>
+#include <QImage>
+#include <QVector>
+#include <QPointF>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <memory>
+#include "frame_pool.h"
+#include "frame_ring.h"
+#include "telemetry.h"
+
+// 预览渲染器：在独立线程中按 LatestOnly 从帧环形队列取帧，
+// 直接由缓存池中的 SDK 帧缩放到控件尺寸，结果以 QImage 视图交给界面（不再拷贝）
+// GUI 未处理完上一帧时不渲染新帧，渲染量随显示能力自动降低
+class PreviewRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 rendered = 0;       // 已渲染帧数
+        quint64 skipped = 0;        // GUI 忙时跳过的帧数
+        double  avgRenderMs = 0;    // 平均每帧缩放耗时
+        double  renderLoad = 0;     // 渲染线程占用率 = 缩放耗时 / 运行时间 (%)
+        double  displayFps = 0;     // 实际显示帧率
+    };
+
+    explicit PreviewRenderer(QObject* parent = nullptr);
+    ~PreviewRenderer() override;
+
+    // telemetry 可为空；非空时记录 到达->预览 / 到达->显示 延迟
+    bool start(std::shared_ptr<FrameRing> ring, std::shared_ptr<StreamTelemetry> telemetry = nullptr);
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // 目标尺寸（物理像素），GUI 线程在控件尺寸变化时调用
+    void setTargetSize(const QSize& size);
+    // GUI 显示完一帧后调用，允许渲染下一帧；hostTimestamp 为该帧到达时间
+    void frameDisplayed(qint64 hostTimestamp = 0);
+
+    Stats stats() const;
+
+signals:
+    // 在渲染线程中发出，image 引用渲染缓存，最后一个副本释放时归还
+    void frameReady(const QImage& image, qint64 hostTimestamp);
+
+private:
+    void run();
+    bool render(const FrameHandle& frame, QImage& out);
+
+    std::shared_ptr<FrameRing> m_ring;
+    std::shared_ptr<StreamTelemetry> m_telemetry;
+    int        m_consumerId = -1;
+    QThread*   m_thread = nullptr;
+    QAtomicInt m_abort;
+    QAtomicInt m_displayPending;
+    QAtomicInteger<quint64> m_targetSize;   // 宽 << 32 | 高
+
+    // 以下只在渲染线程中访问
+    FramePool  m_pool;                      // 渲染结果缓存，按输出尺寸分配
+    cv::Size   m_poolSize;
+    cv::Mat    m_scratch16;                 // 16 位输入的中间结果
+
+    QAtomicInteger<quint64> m_rendered;
+    QAtomicInteger<quint64> m_skipped;
+    QAtomicInteger<qint64>  m_renderNs;     // 累计缩放耗时
+    QElapsedTimer m_clock;                  // 自 start() 起的运行时间
+};
+
+// 预览控件：直接绘制渲染器输出的 QImage，不经过 QPixmap 转换；无帧时按普通 QLabel 显示文字
+// 可叠加棋盘格角点（归一化坐标，按行排列），随图像一起居中缩放
+class PreviewLabel : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit PreviewLabel(QWidget* parent = nullptr);
+
+    void setFrame(const QImage& image);
+    void clearFrame();
+    void setOverlay(const QVector<QPointF>& corners, int columns);
+    void clearOverlay();
+    // 渲染目标尺寸（已乘设备像素比）
+    QSize targetSize() const;
+
+signals:
+    void targetSizeChanged(const QSize& size);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    QImage m_frame;
+    QVector<QPointF> m_corners;
+    int m_columns = 0;
+};
+
+#endif // PREVIEW_RENDERER_H
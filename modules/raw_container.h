@@ -0,0 +1,63 @@
+#ifndef RAW_CONTAINER_H
+#define RAW_CONTAINER_H
+
+#include <QtGlobal>
+
+// 原始帧容器格式（录制写入、数据集读取共用）
+//
+// 数据文件 *.uwcraw：4 KB 文件头 + 若干帧数据，每帧起始偏移按 4 KB 对齐，
+// 帧数据为 SDK 输出的原始字节（未做像素格式转换），可直接内存映射
+// 索引文件 *.uwcidx：索引头 + 定长记录，只追加；记录在对应数据落盘后才写入，
+// 异常中断时索引中的帧一定完整
+namespace RawContainer {
+
+static const char   DataMagic[8]  = { 'U', 'W', 'C', 'R', 'A', 'W', '0', '1' };
+static const char   IndexMagic[8] = { 'U', 'W', 'C', 'I', 'D', 'X', '0', '1' };
+static const quint32 Version = 1;
+static const quint32 Alignment = 4096;          // 帧偏移、写入块大小的对齐单位
+static const quint32 DataHeaderSize = 4096;
+
+inline quint64 alignUp(quint64 value, quint64 alignment = Alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#pragma pack(push, 1)
+struct DataHeader {
+    char    magic[8];
+    quint32 version;
+    quint32 alignment;
+    quint32 chunkSize;              // 录制时的写入块大小
+    quint32 reserved0;
+    qint64  createdMs;              // 创建时间 (ms since epoch)
+    char    device[128];            // 设备描述（型号/序列号），UTF-8，0 结尾
+};
+
+struct IndexHeader {
+    char    magic[8];
+    quint32 version;
+    quint32 entrySize;              // sizeof(IndexEntry)，读取方据此兼容后续扩展
+};
+
+struct IndexEntry {
+    quint64 offset;                 // 帧数据在数据文件中的偏移
+    quint32 size;                   // 帧数据字节数 (nFrameLen)
+    quint32 frameNumber;            // 设备帧号
+    quint64 sequence;               // 本地序号
+    quint64 deviceTimestamp;
+    qint64  hostTimestamp;          // 主机到达时间(us)
+    quint32 pixelType;              // MvGvspPixelType
+    quint32 width;
+    quint32 height;
+    float   exposureTime;           // us
+    float   gain;                   // dB
+    quint32 reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(DataHeader) <= DataHeaderSize, "data header must fit in the first page");
+static_assert(sizeof(IndexEntry) == 64, "index entry layout changed");
+
+} // namespace RawContainer
+
+#endif // RAW_CONTAINER_H
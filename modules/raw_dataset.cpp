@@ -0,0 +1,127 @@
+#include "raw_dataset.h"
+#include <QFileInfo>
+#include <cstring>
+#include "stream_recorder.h"
+#include "pixel_convert.h"
+
+std::shared_ptr<RawDataset> RawDataset::open(const QString& dataPath, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return std::shared_ptr<RawDataset>();
+    };
+
+    std::shared_ptr<RawDataset> dataset(new RawDataset);
+    dataset->m_file.setFileName(dataPath);
+    if (!dataset->m_file.open(QIODevice::ReadOnly))
+        return fail(QString("无法打开 %1").arg(dataPath));
+
+    RawContainer::DataHeader header{};
+    if (dataset->m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || memcmp(header.magic, RawContainer::DataMagic, sizeof(header.magic)) != 0
+        || header.version != RawContainer::Version)
+        return fail(QString("不是有效的原始帧文件: %1").arg(dataPath));
+    header.device[sizeof(header.device) - 1] = 0;
+    dataset->m_device    = QString::fromUtf8(header.device);
+    dataset->m_createdMs = header.createdMs;
+
+    // 整个文件只映射不读取
+    dataset->m_mapSize = dataset->m_file.size();
+    dataset->m_map = dataset->m_file.map(0, dataset->m_mapSize);
+    if (!dataset->m_map)
+        return fail(QString("内存映射失败: %1").arg(dataset->m_file.errorString()));
+
+    QFile indexFile(StreamRecorder::indexPathFor(dataPath));
+    if (!indexFile.open(QIODevice::ReadOnly))
+        return fail(QString("缺少索引文件: %1").arg(indexFile.fileName()));
+    const QByteArray index = indexFile.readAll();
+    RawContainer::IndexHeader indexHeader{};
+    if (index.size() < int(sizeof(indexHeader)))
+        return fail(QString("索引文件已损坏: %1").arg(indexFile.fileName()));
+    memcpy(&indexHeader, index.constData(), sizeof(indexHeader));
+    if (memcmp(indexHeader.magic, RawContainer::IndexMagic, sizeof(indexHeader.magic)) != 0
+        || indexHeader.entrySize < sizeof(RawContainer::IndexEntry))
+        return fail(QString("索引文件已损坏: %1").arg(indexFile.fileName()));
+
+    // 按记录长度步进，兼容以后追加字段；越界的记录（数据未写完）丢弃
+    const qint64 count = (index.size() - qint64(sizeof(indexHeader))) / indexHeader.entrySize;
+    dataset->m_entries.reserve(size_t(count));
+    const char* cursor = index.constData() + sizeof(indexHeader);
+    for (qint64 i = 0; i < count; ++i, cursor += indexHeader.entrySize) {
+        RawContainer::IndexEntry entry;
+        memcpy(&entry, cursor, sizeof(entry));
+        if (entry.size == 0 || entry.offset + entry.size > quint64(dataset->m_mapSize)) continue;
+        dataset->m_entries.push_back(entry);
+    }
+    return dataset;
+}
+
+RawDataset::~RawDataset()
+{
+    if (m_map)
+        m_file.unmap(m_map);
+}
+
+qint64 RawDataset::frameTimeMs(int index) const
+{
+    if (m_entries.empty()) return m_createdMs;
+    return m_createdMs + (m_entries[size_t(index)].hostTimestamp - m_entries.front().hostTimestamp) / 1000;
+}
+
+// 超过 8 位的格式转换为左对齐的 16 位灰度，与采集时 Gray16 输出一致，重新加载不丢失位深
+static PixelConverter::OutputMode outputModeFor(unsigned int pixelType)
+{
+    return PixelConverter::sampleBits(pixelType) > 8 ? PixelConverter::Gray16 : PixelConverter::Gray8;
+}
+
+// Mono8 / Mono16 的存储格式即为输出格式，直接引用映射区
+bool RawDataset::isZeroCopy(int index) const
+{
+    const RawContainer::IndexEntry& e = entry(index);
+    const quint64 pixels = quint64(e.width) * e.height;
+    if (e.pixelType == PixelType_Gvsp_Mono8) return pixels <= e.size;
+    if (e.pixelType == PixelType_Gvsp_Mono16) return pixels * 2 <= e.size;
+    return false;
+}
+
+bool RawDataset::isDecodable(int index) const
+{
+    if (isZeroCopy(index)) return true;
+    const RawContainer::IndexEntry& e = entry(index);
+    PixelConverter converter;
+    return converter.configure(e.pixelType, e.width, e.height, outputModeFor(e.pixelType))
+           && PixelConverter::rawFrameBytes(e.pixelType, e.width, e.height) <= e.size;
+}
+
+cv::Mat RawDataset::image(int index) const
+{
+    const RawContainer::IndexEntry& e = entry(index);
+    if (isZeroCopy(index))
+        return cv::Mat(int(e.height), int(e.width), e.pixelType == PixelType_Gvsp_Mono16 ? CV_16UC1 : CV_8UC1,
+                       const_cast<unsigned char*>(frameData(index)));
+
+    PixelConverter converter;
+    if (!converter.configure(e.pixelType, e.width, e.height, outputModeFor(e.pixelType))
+        || PixelConverter::rawFrameBytes(e.pixelType, e.width, e.height) > e.size)
+        return cv::Mat();
+    cv::Mat gray(converter.outputSize(), converter.outputType());
+    if (!converter.convert(frameData(index), gray)) return cv::Mat();
+    return gray;
+}
+
+QImage RawDataset::qImage(int index) const
+{
+    const RawContainer::IndexEntry& e = entry(index);
+    if (!isZeroCopy(index)) {
+        const cv::Mat gray = image(index);
+        if (gray.empty()) return QImage();
+        const QImage::Format format = gray.depth() == CV_16U ? QImage::Format_Grayscale16 : QImage::Format_Grayscale8;
+        return QImage(gray.data, gray.cols, gray.rows, int(gray.step), format).copy();
+    }
+    // 只读视图：QImage 不会写入映射区，释放时归还对数据集的引用
+    const bool wide = e.pixelType == PixelType_Gvsp_Mono16;
+    auto* keep = new std::shared_ptr<const RawDataset>(shared_from_this());
+    return QImage(frameData(index), int(e.width), int(e.height), int(e.width) * (wide ? 2 : 1),
+                  wide ? QImage::Format_Grayscale16 : QImage::Format_Grayscale8,
+                  [](void* info) { delete static_cast<std::shared_ptr<const RawDataset>*>(info); }, keep);
+}
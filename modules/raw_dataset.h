@@ -0,0 +1,54 @@
+#ifndef RAW_DATASET_H
+#define RAW_DATASET_H
+
+#include <QString>
+#include <QFile>
+#include <QImage>
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "raw_container.h"
+
+// 原始帧容器读取：内存映射数据文件，只读入索引，打开耗时与数据量无关
+// Mono8 / Mono16 帧直接返回指向映射区的 cv::Mat / QImage 视图（CV_8UC1 / CV_16UC1），页面在实际访问时才读入；
+// 其他像素格式在取用时转换为灰度（新分配）：8 位格式为 8 位，超过 8 位的为有效位左对齐的 16 位，
+// 与采集时 Gray16 的输出一致（Mono10/12 不做视图：低位对齐的原始值按 16 位满量程处理会过暗）
+// 视图不持有数据集，使用方需保存 shared_ptr（如 DatasetFrame 的录制来源）直到视图释放
+class RawDataset : public std::enable_shared_from_this<RawDataset>
+{
+public:
+    static std::shared_ptr<RawDataset> open(const QString& dataPath, QString* error = nullptr);
+    ~RawDataset();
+
+    RawDataset(const RawDataset&) = delete;
+    RawDataset& operator=(const RawDataset&) = delete;
+
+    QString path() const { return m_file.fileName(); }
+    QString device() const { return m_device; }
+    qint64 createdMs() const { return m_createdMs; }
+
+    int frameCount() const { return int(m_entries.size()); }
+    const RawContainer::IndexEntry& entry(int index) const { return m_entries[size_t(index)]; }
+    const unsigned char* frameData(int index) const { return m_map + m_entries[size_t(index)].offset; }
+    // 帧的采集时间：文件创建时间 + 相对首帧的主机时间差
+    qint64 frameTimeMs(int index) const;
+
+    bool isZeroCopy(int index) const;
+    // 只检查像素格式和帧长度，不转换
+    bool isDecodable(int index) const;
+    cv::Mat image(int index) const;
+    // Mono8 / Mono16 为映射区视图，最后一个副本释放时才释放对数据集的引用
+    QImage qImage(int index) const;
+
+private:
+    RawDataset() = default;
+
+    QFile   m_file;
+    uchar*  m_map = nullptr;
+    qint64  m_mapSize = 0;
+    QString m_device;
+    qint64  m_createdMs = 0;
+    std::vector<RawContainer::IndexEntry> m_entries;
+};
+
+#endif // RAW_DATASET_H
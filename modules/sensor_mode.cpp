@@ -0,0 +1,194 @@
+#include "sensor_mode.h"
+#include <QObject>
+#include <cmath>
+
+namespace {
+
+// 合并/抽样节点在不同型号上可能是枚举或整数
+int setFactor(CMvCamera* camera, const char* name, int factor)
+{
+    int ret = camera->SetEnumValue(name, static_cast<unsigned int>(factor));
+    if (ret != MV_OK)
+        ret = camera->SetIntValue(name, factor);
+    return ret;
+}
+
+int readFactor(CMvCamera* camera, const char* name)
+{
+    MVCC_ENUMVALUE enumValue{};
+    if (camera->GetEnumValue(name, &enumValue) == MV_OK)
+        return qMax(1, int(enumValue.nCurValue));
+    MVCC_INTVALUE_EX intValue{};
+    if (camera->GetIntValue(name, &intValue) == MV_OK)
+        return qMax(1, int(intValue.nCurValue));
+    return 1;
+}
+
+bool setPair(CMvCamera* camera, const char* horizontal, const char* vertical, int factor)
+{
+    return setFactor(camera, horizontal, factor) == MV_OK && setFactor(camera, vertical, factor) == MV_OK;
+}
+
+// 按节点步长向下取整并限幅
+int64_t alignToNode(int64_t value, const MVCC_INTVALUE_EX& node)
+{
+    const int64_t inc = qMax<int64_t>(1, node.nInc);
+    value = qBound<int64_t>(node.nMin, value, node.nMax);
+    return value - (value - node.nMin) % inc;
+}
+
+} // namespace
+
+/*-------------------------------- StreamGeometry --------------------------------*/
+bool StreamGeometry::isFullSensor() const
+{
+    return factor() == 1 && offsetX == 0 && offsetY == 0
+           && width == sensorWidth && height == sensorHeight;
+}
+
+// 抽样不移动像素中心（u * d），合并把中心移到合并块中央（(u + 0.5) * b - 0.5）
+cv::Point2f StreamGeometry::toSensor(const cv::Point2f& p) const
+{
+    const float b = float(qMax(1, binning));
+    const float d = float(qMax(1, decimation));
+    return cv::Point2f(((p.x + offsetX) * d + 0.5f) * b - 0.5f, ((p.y + offsetY) * d + 0.5f) * b - 0.5f);
+}
+
+cv::Mat StreamGeometry::cameraMatrixFromSensor(const cv::Mat& sensorMatrix) const
+{
+    cv::Mat K;
+    sensorMatrix.convertTo(K, CV_64F);
+    const double b = qMax(1, binning);
+    const double d = qMax(1, decimation);
+    const double f = b * d;
+    K.at<double>(0, 0) /= f;
+    K.at<double>(0, 1) /= f;
+    K.at<double>(1, 1) /= f;
+    K.at<double>(0, 2) = ((K.at<double>(0, 2) + 0.5) / b - 0.5) / d - offsetX;
+    K.at<double>(1, 2) = ((K.at<double>(1, 2) + 0.5) / b - 0.5) / d - offsetY;
+    return K;
+}
+
+QString StreamGeometry::describe() const
+{
+    QString text = QString("%1x%2").arg(width).arg(height);
+    if (binning > 1) text += QObject::tr(" 合并%1x").arg(binning);
+    if (decimation > 1) text += QObject::tr(" 抽样%1x").arg(decimation);
+    if (offsetX || offsetY) text += QString(" @(%1,%2)").arg(offsetX).arg(offsetY);
+    return text;
+}
+
+/*-------------------------------- SensorMode --------------------------------*/
+SensorMode SensorMode::fullSensor()
+{
+    SensorMode mode;
+    mode.name = QObject::tr("全分辨率");
+    return mode;
+}
+
+QList<SensorMode> SensorMode::presets()
+{
+    QList<SensorMode> modes;
+    modes << fullSensor();
+
+    SensorMode bin2;
+    bin2.name = QObject::tr("2x2 合并（预览）");
+    bin2.factor = 2;
+    modes << bin2;
+
+    SensorMode bin4;
+    bin4.name = QObject::tr("4x4 合并（预览）");
+    bin4.factor = 4;
+    modes << bin4;
+
+    SensorMode center;
+    center.name = QObject::tr("中心 1/2 区域 + 2x2 合并");
+    center.region = QRectF(0.25, 0.25, 0.5, 0.5);
+    center.factor = 2;
+    modes << center;
+    return modes;
+}
+
+/*-------------------------------- 节点读写 --------------------------------*/
+int applySensorMode(CMvCamera* camera, const SensorMode& mode, StreamGeometry& geometry)
+{
+    if (!camera) return MV_E_HANDLE;
+
+    // 先把区域移回原点，合并倍数变小时宽高才能放大
+    camera->SetIntValue("OffsetX", 0);
+    camera->SetIntValue("OffsetY", 0);
+
+    const int factor = qMax(1, mode.factor);
+    const char* firstH  = mode.preferBinning ? "BinningHorizontal" : "DecimationHorizontal";
+    const char* firstV  = mode.preferBinning ? "BinningVertical" : "DecimationVertical";
+    const char* secondH = mode.preferBinning ? "DecimationHorizontal" : "BinningHorizontal";
+    const char* secondV = mode.preferBinning ? "DecimationVertical" : "BinningVertical";
+    if (factor == 1) {
+        // 不支持的节点忽略
+        setPair(camera, firstH, firstV, 1);
+        setPair(camera, secondH, secondV, 1);
+    } else if (setPair(camera, firstH, firstV, factor)) {
+        setPair(camera, secondH, secondV, 1);
+    } else {
+        setPair(camera, firstH, firstV, 1);
+        if (!setPair(camera, secondH, secondV, factor)) {
+            setPair(camera, secondH, secondV, 1);
+            return MV_E_SUPPORT;
+        }
+    }
+
+    // 区域按合并后的最大尺寸换算
+    MVCC_INTVALUE_EX widthMax{}, heightMax{}, widthNode{}, heightNode{};
+    int ret = camera->GetIntValue("WidthMax", &widthMax);
+    if (ret == MV_OK) ret = camera->GetIntValue("HeightMax", &heightMax);
+    if (ret == MV_OK) ret = camera->GetIntValue("Width", &widthNode);
+    if (ret == MV_OK) ret = camera->GetIntValue("Height", &heightNode);
+    if (ret != MV_OK) return ret;
+
+    widthNode.nMax  = qMin(widthNode.nMax, widthMax.nCurValue);
+    heightNode.nMax = qMin(heightNode.nMax, heightMax.nCurValue);
+    const QRectF region = mode.region.intersected(QRectF(0, 0, 1, 1));
+    const int64_t width  = alignToNode(std::llround(region.width() * widthMax.nCurValue), widthNode);
+    const int64_t height = alignToNode(std::llround(region.height() * heightMax.nCurValue), heightNode);
+    ret = camera->SetIntValue("Width", width);
+    if (ret == MV_OK) ret = camera->SetIntValue("Height", height);
+    if (ret != MV_OK) return ret;
+
+    MVCC_INTVALUE_EX offsetXNode{}, offsetYNode{};
+    if (camera->GetIntValue("OffsetX", &offsetXNode) == MV_OK
+        && camera->GetIntValue("OffsetY", &offsetYNode) == MV_OK) {
+        offsetXNode.nMax = qMin(offsetXNode.nMax, widthMax.nCurValue - width);
+        offsetYNode.nMax = qMin(offsetYNode.nMax, heightMax.nCurValue - height);
+        const int64_t offsetX = alignToNode(std::llround(region.x() * widthMax.nCurValue), offsetXNode);
+        const int64_t offsetY = alignToNode(std::llround(region.y() * heightMax.nCurValue), offsetYNode);
+        ret = camera->SetIntValue("OffsetX", offsetX);
+        if (ret == MV_OK) ret = camera->SetIntValue("OffsetY", offsetY);
+        if (ret != MV_OK) return ret;
+    }
+    return readStreamGeometry(camera, geometry);
+}
+
+int readStreamGeometry(CMvCamera* camera, StreamGeometry& geometry)
+{
+    if (!camera) return MV_E_HANDLE;
+
+    MVCC_INTVALUE_EX widthMax{}, heightMax{}, width{}, height{}, offsetX{}, offsetY{};
+    int ret = camera->GetIntValue("WidthMax", &widthMax);
+    if (ret == MV_OK) ret = camera->GetIntValue("HeightMax", &heightMax);
+    if (ret == MV_OK) ret = camera->GetIntValue("Width", &width);
+    if (ret == MV_OK) ret = camera->GetIntValue("Height", &height);
+    if (ret != MV_OK) return ret;
+    camera->GetIntValue("OffsetX", &offsetX);       // 不支持 ROI 的型号按 0 处理
+    camera->GetIntValue("OffsetY", &offsetY);
+
+    geometry.binning      = readFactor(camera, "BinningHorizontal");
+    geometry.decimation   = readFactor(camera, "DecimationHorizontal");
+    geometry.width        = int(width.nCurValue);
+    geometry.height       = int(height.nCurValue);
+    geometry.offsetX      = int(offsetX.nCurValue);
+    geometry.offsetY      = int(offsetY.nCurValue);
+    // WidthMax/HeightMax 是合并/抽样后的最大尺寸
+    geometry.sensorWidth  = int(widthMax.nCurValue) * geometry.factor();
+    geometry.sensorHeight = int(heightMax.nCurValue) * geometry.factor();
+    return MV_OK;
+}
@@ -0,0 +1,53 @@
+#ifndef SENSOR_MODE_H
+#define SENSOR_MODE_H
+
+#include <QString>
+#include <QRectF>
+#include <QList>
+#include <opencv2/opencv.hpp>
+#include "cmvcamera.h"
+
+// 取流几何：输出像素与全分辨率传感器像素的对应关系
+// 先合并后抽样：抽样保留第 (u + offsetX) * decimation 个合并像素，合并像素的中心为其 binning 个传感器像素的中心，
+// 输出像素 (u, v) 对应传感器坐标 (((u + offsetX) * decimation + 0.5) * binning - 0.5, ...)
+// 合并/抽样倍数水平竖直相同，偏移以输出像素为单位（与 SDK 节点一致）
+struct StreamGeometry {
+    int sensorWidth = 0;            // 全分辨率
+    int sensorHeight = 0;
+    int binning = 1;
+    int decimation = 1;
+    int offsetX = 0;
+    int offsetY = 0;
+    int width = 0;                  // 输出尺寸
+    int height = 0;
+
+    bool isValid() const { return width > 0 && height > 0 && sensorWidth > 0 && sensorHeight > 0; }
+    int factor() const { return binning * decimation; }
+    bool isFullSensor() const;
+    cv::Size sensorSize() const { return cv::Size(sensorWidth, sensorHeight); }
+
+    cv::Point2f toSensor(const cv::Point2f& p) const;
+    // 全分辨率内参 -> 本流内参（畸变系数不随缩放变化）
+    cv::Mat cameraMatrixFromSensor(const cv::Mat& sensorMatrix) const;
+
+    QString describe() const;
+};
+
+// 采集模式：传感器区域 + 合并/抽样倍数
+struct SensorMode {
+    QString name;
+    QRectF  region = QRectF(0, 0, 1, 1);    // 全分辨率传感器上的归一化区域
+    int     factor = 1;                     // 合并/抽样倍数：1, 2, 4
+    bool    preferBinning = true;           // 优先合并（信噪比好），不支持时改用抽样
+
+    bool isFullSensor() const { return factor == 1 && region == QRectF(0, 0, 1, 1); }
+    static SensorMode fullSensor();
+    static QList<SensorMode> presets();
+};
+
+// 写入模式节点并读回实际几何；相机须已停止取流
+int applySensorMode(CMvCamera* camera, const SensorMode& mode, StreamGeometry& geometry);
+// 读取当前几何（合并/抽样节点不存在时按 1 处理）
+int readStreamGeometry(CMvCamera* camera, StreamGeometry& geometry);
+
+#endif // SENSOR_MODE_H
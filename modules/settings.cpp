@@ -65,6 +65,8 @@ void SettingsModule::loadSettings()
     m_settings.defaultSavePath = m_qsettings->value("Paths/DefaultSavePath", defaultPath).toString();
     m_settings.templatePath = m_qsettings->value("Paths/TemplatePath", defaultPath + "/templates").toString();
     m_settings.databasePath = m_qsettings->value("Paths/DatabasePath", defaultPath + "/database").toString();
+    m_settings.exportFormat = m_qsettings->value("Paths/ExportFormat", 0).toInt();
+    m_settings.exportCompression = m_qsettings->value("Paths/ExportCompression", 3).toInt();
     
     // 确保路径存在
     QDir().mkpath(m_settings.templatePath);
@@ -74,11 +76,13 @@ void SettingsModule::loadSettings()
     m_settings.defaultExposure = m_qsettings->value("Camera/DefaultExposure", 10000).toInt();
     m_settings.defaultGain = m_qsettings->value("Camera/DefaultGain", 0).toInt();
     m_settings.autoWhiteBalance = m_qsettings->value("Camera/AutoWhiteBalance", true).toBool();
+    m_settings.keepColorImages = m_qsettings->value("Camera/KeepColorImages", false).toBool();
     
     // 加载标定设置
     m_settings.defaultBoardWidth = m_qsettings->value("Calibration/DefaultBoardWidth", 9).toInt();
     m_settings.defaultBoardHeight = m_qsettings->value("Calibration/DefaultBoardHeight", 6).toInt();
     m_settings.defaultSquareSize = m_qsettings->value("Calibration/DefaultSquareSize", 25.0).toDouble();
+    m_settings.keepDuplicateFrames = m_qsettings->value("Calibration/KeepDuplicateFrames", false).toBool();
 
 
 }
@@ -96,16 +100,20 @@ void SettingsModule::saveSettings()
     m_qsettings->setValue("Paths/DefaultSavePath", m_settings.defaultSavePath);
     m_qsettings->setValue("Paths/TemplatePath", m_settings.templatePath);
     m_qsettings->setValue("Paths/DatabasePath", m_settings.databasePath);
+    m_qsettings->setValue("Paths/ExportFormat", m_settings.exportFormat);
+    m_qsettings->setValue("Paths/ExportCompression", m_settings.exportCompression);
     
     // 保存相机设置
     m_qsettings->setValue("Camera/DefaultExposure", m_settings.defaultExposure);
     m_qsettings->setValue("Camera/DefaultGain", m_settings.defaultGain);
     m_qsettings->setValue("Camera/AutoWhiteBalance", m_settings.autoWhiteBalance);
+    m_qsettings->setValue("Camera/KeepColorImages", m_settings.keepColorImages);
     
     // 保存标定设置
     m_qsettings->setValue("Calibration/DefaultBoardWidth", m_settings.defaultBoardWidth);
     m_qsettings->setValue("Calibration/DefaultBoardHeight", m_settings.defaultBoardHeight);
     m_qsettings->setValue("Calibration/DefaultSquareSize", m_settings.defaultSquareSize);
+    m_qsettings->setValue("Calibration/KeepDuplicateFrames", m_settings.keepDuplicateFrames);
     
     m_qsettings->sync();
     
@@ -127,16 +135,20 @@ void SettingsModule::applySettingsToUI()
     ui->defaultPathEdit->setText(m_settings.defaultSavePath);
     ui->templatePathEdit->setText(m_settings.templatePath);
     ui->databasePathEdit->setText(m_settings.databasePath);
+    ui->exportFormatCombo->setCurrentIndex(m_settings.exportFormat);
+    ui->exportCompressionSpin->setValue(m_settings.exportCompression);
     
     // 应用相机设置
     ui->exposureSpin->setValue(m_settings.defaultExposure);
     ui->gainSpin->setValue(m_settings.defaultGain);
     ui->whiteBalanceCheck->setChecked(m_settings.autoWhiteBalance);
+    ui->keepColorCheck->setChecked(m_settings.keepColorImages);
     
     // 应用标定设置
     ui->boardWidthSpin->setValue(m_settings.defaultBoardWidth);
     ui->boardHeightSpin->setValue(m_settings.defaultBoardHeight);
     ui->squareSizeSpin->setValue(m_settings.defaultSquareSize);
+    ui->keepDuplicatesCheck->setChecked(m_settings.keepDuplicateFrames);
 
     emit settingsChanged(m_settings);
 }
@@ -152,16 +164,20 @@ void SettingsModule::updateSettingsFromUI()
     m_settings.defaultSavePath = ui->defaultPathEdit->text();
     m_settings.templatePath = ui->templatePathEdit->text();
     m_settings.databasePath = ui->databasePathEdit->text();
+    m_settings.exportFormat = ui->exportFormatCombo->currentIndex();
+    m_settings.exportCompression = ui->exportCompressionSpin->value();
     
     // 从UI更新相机设置
     m_settings.defaultExposure = ui->exposureSpin->value();
     m_settings.defaultGain = ui->gainSpin->value();
     m_settings.autoWhiteBalance = ui->whiteBalanceCheck->isChecked();
+    m_settings.keepColorImages = ui->keepColorCheck->isChecked();
     
     // 从UI更新标定设置
     m_settings.defaultBoardWidth = ui->boardWidthSpin->value();
     m_settings.defaultBoardHeight = ui->boardHeightSpin->value();
     m_settings.defaultSquareSize = ui->squareSizeSpin->value();
+    m_settings.keepDuplicateFrames = ui->keepDuplicatesCheck->isChecked();
 }
 
 void SettingsModule::setDefaultSettings()
@@ -176,14 +192,18 @@ void SettingsModule::setDefaultSettings()
     m_settings.defaultSavePath = defaultPath;
     m_settings.templatePath = defaultPath + "/templates";
     m_settings.databasePath = defaultPath + "/database";
+    m_settings.exportFormat = 0;
+    m_settings.exportCompression = 3;
     
     m_settings.defaultExposure = 10000;
     m_settings.defaultGain = 0;
     m_settings.autoWhiteBalance = true;
+    m_settings.keepColorImages = false;
     
     m_settings.defaultBoardWidth = 9;
     m_settings.defaultBoardHeight = 6;
     m_settings.defaultSquareSize = 25.0;
+    m_settings.keepDuplicateFrames = false;
     
     // 应用到UI
     applySettingsToUI();
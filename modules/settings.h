@@ -19,16 +19,20 @@ struct AppSettings {
     QString defaultSavePath;   // 默认保存路径
     QString templatePath;      // 模板路径
     QString databasePath;      // 数据库路径
+    int exportFormat;          // 图像导出格式（DatasetExporter::Format）
+    int exportCompression;     // 导出压缩级别 0-9（无损，只影响速度和体积）
     
     // 相机设置
     int defaultExposure;       // 默认曝光时间(微秒)
     int defaultGain;           // 默认增益
     bool autoWhiteBalance;     // 自动白平衡
+    bool keepColorImages;      // 加载图像时保留彩色原图（默认只存灰度）
     
     // 标定设置
     int defaultBoardWidth;     // 默认棋盘格宽度
     int defaultBoardHeight;    // 默认棋盘格高度
     double defaultSquareSize;  // 默认棋盘格大小(mm)
+    bool keepDuplicateFrames;  // 标定时保留近似重复的图像（默认跳过）
 };
 
 class SettingsModule : public QWidget
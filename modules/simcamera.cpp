@@ -0,0 +1,798 @@
+#include "simcamera.h"
+#include <QSettings>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+// 最多模拟的相机台数
+static const int MAX_SIM_DEVICES = 8;
+// 合成棋盘格的运动帧数：循环播放，让检测和位姿判断有变化可看
+static const int SYNTH_FRAME_COUNT = 16;
+// 原始帧文件最多读入的帧数
+static const int MAX_RAW_FRAMES = 64;
+// 亮度模拟的基准曝光(us)
+static const float NOMINAL_EXPOSURE = 10000.0f;
+
+static MV_CC_DEVICE_INFO s_stSimDevices[MAX_SIM_DEVICES];
+
+/*-------------------------------- SimCameraConfig --------------------------------*/
+SimCameraConfig SimCameraConfig::load()
+{
+    QString iniPath = qEnvironmentVariable("UWC_SIM_CONFIG");
+    if (iniPath.isEmpty())
+        iniPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                  + "/UnderwaterCalibrator.ini";
+
+    QSettings ini(iniPath, QSettings::IniFormat);
+    SimCameraConfig config;
+    config.enabled     = ini.value("Simulation/Enabled", false).toBool()
+                         || qEnvironmentVariableIntValue("UWC_SIM_CAMERA") != 0;
+    config.count       = qBound(1, ini.value("Simulation/Count", config.count).toInt(), MAX_SIM_DEVICES);
+    config.source      = ini.value("Simulation/Source", config.source).toString();
+    config.width       = ini.value("Simulation/Width", config.width).toInt();
+    config.height      = ini.value("Simulation/Height", config.height).toInt();
+    config.pixelFormat = ini.value("Simulation/PixelFormat", config.pixelFormat).toString();
+    config.frameRate   = ini.value("Simulation/FrameRate", config.frameRate).toDouble();
+    config.jitterMs    = ini.value("Simulation/JitterMs", config.jitterMs).toDouble();
+    config.dropRate    = qBound(0.0, ini.value("Simulation/DropRate", config.dropRate).toDouble(), 1.0);
+    config.boardCols   = ini.value("Simulation/BoardCols", config.boardCols).toInt();
+    config.boardRows   = ini.value("Simulation/BoardRows", config.boardRows).toInt();
+    return config;
+}
+
+unsigned int SimCameraConfig::pixelTypeFromName(const QString& name)
+{
+    static const QHash<QString, unsigned int> types = {
+        { "Mono8",        PixelType_Gvsp_Mono8 },
+        { "Mono10",       PixelType_Gvsp_Mono10 },
+        { "Mono12",       PixelType_Gvsp_Mono12 },
+        { "Mono10Packed", PixelType_Gvsp_Mono10_Packed },
+        { "Mono12Packed", PixelType_Gvsp_Mono12_Packed },
+        { "BayerGR8",     PixelType_Gvsp_BayerGR8 },
+        { "BayerRG8",     PixelType_Gvsp_BayerRG8 },
+        { "BayerGB8",     PixelType_Gvsp_BayerGB8 },
+        { "BayerBG8",     PixelType_Gvsp_BayerBG8 },
+    };
+    return types.value(name, PixelType_Gvsp_Mono8);
+}
+
+/*-------------------------------- 工具函数 --------------------------------*/
+static int sampleBits(unsigned int type)
+{
+    switch (type) {
+    case PixelType_Gvsp_Mono10:
+    case PixelType_Gvsp_Mono10_Packed:
+        return 10;
+    case PixelType_Gvsp_Mono12:
+    case PixelType_Gvsp_Mono12_Packed:
+        return 12;
+    default:
+        return 8;
+    }
+}
+
+static bool isPacked(unsigned int type)
+{
+    return type == PixelType_Gvsp_Mono10_Packed || type == PixelType_Gvsp_Mono12_Packed;
+}
+
+// 合成棋盘格：cols x rows 个内角点，白边包围
+static cv::Mat makeChessboard(int width, int height, int cols, int rows)
+{
+    cv::Mat board(height, width, CV_8UC1, cv::Scalar(160));
+    const int squaresX = cols + 1, squaresY = rows + 1;
+    const int square = std::max(4, std::min(width / (squaresX + 4), height / (squaresY + 4)));
+    const int x0 = (width - squaresX * square) / 2;
+    const int y0 = (height - squaresY * square) / 2;
+
+    cv::rectangle(board, cv::Rect(x0 - square, y0 - square, (squaresX + 2) * square, (squaresY + 2) * square),
+                  cv::Scalar(235), cv::FILLED);
+    for (int y = 0; y < squaresY; ++y)
+        for (int x = 0; x < squaresX; ++x)
+            if ((x + y) % 2 == 0)
+                cv::rectangle(board, cv::Rect(x0 + x * square, y0 + y * square, square, square),
+                              cv::Scalar(25), cv::FILLED);
+    return board;
+}
+
+/*-------------------------------- CSimCamera --------------------------------*/
+CSimCamera::CSimCamera(const SimCameraConfig& config)
+    : m_config(config)
+    , m_bOpened(false)
+    , m_bGrabbing(false)
+    , m_bResend(false)
+    , m_enPixelType(SimCameraConfig::pixelTypeFromName(config.pixelFormat))
+    , m_nNextFrame(0)
+    , m_nFrameNum(0)
+    , m_nDropped(0)
+    , m_nDelivered(0)
+    , m_rng(std::random_device{}())
+{
+    memset(&m_stDevInfo, 0, sizeof(MV_CC_DEVICE_INFO));
+
+    const int64_t width  = std::max(2, config.width) & ~int64_t(1);    // Packed 格式要求偶数宽
+    const int64_t height = std::max(1, config.height);
+    m_nSensorWidth  = width;
+    m_nSensorHeight = height;
+    m_intNodes.insert("WidthMax",          { width, width, width, 1 });
+    m_intNodes.insert("HeightMax",         { height, height, height, 1 });
+    m_intNodes.insert("Width",             { width, 2, width, 2 });
+    m_intNodes.insert("Height",            { height, 1, height, 1 });
+    m_intNodes.insert("OffsetX",           { 0, 0, width - 2, 2 });
+    m_intNodes.insert("OffsetY",           { 0, 0, height - 1, 1 });
+    m_intNodes.insert("BinningHorizontal", { 1, 1, 4, 1 });
+    m_intNodes.insert("BinningVertical",   { 1, 1, 4, 1 });
+    m_intNodes.insert("PayloadSize",       { 0, 0, INT64_MAX, 1 });
+    m_intNodes.insert("GevSCPSPacketSize", { 1500, 576, 9000, 4 });
+    m_intNodes.insert("GevSCPD",           { 0, 0, 100000, 1 });
+    m_intNodes.insert("GevLinkSpeed",      { 1000, 1000, 1000, 1 });
+
+    const float fps = static_cast<float>(config.frameRate > 0 ? config.frameRate : 30.0);
+    m_floatNodes.insert("ExposureTime",         { NOMINAL_EXPOSURE, 15.0f, 1000000.0f });
+    m_floatNodes.insert("Gain",                 { 0.0f, 0.0f, 20.0f });
+    m_floatNodes.insert("AcquisitionFrameRate", { fps, 0.1f, 1000.0f });
+    m_floatNodes.insert("ResultingFrameRate",   { fps, 0.1f, 1000.0f });
+    m_boolNodes.insert("AcquisitionFrameRateEnable", true);
+}
+
+CSimCamera::~CSimCamera()
+{
+    Close();
+}
+
+int CSimCamera::EnumDevices(const SimCameraConfig& config, MV_CC_DEVICE_INFO_LIST* pstDevList)
+{
+    if (MV_NULL == pstDevList)
+    {
+        return MV_E_PARAMETER;
+    }
+
+    memset(pstDevList, 0, sizeof(MV_CC_DEVICE_INFO_LIST));
+    if (!config.enabled)
+    {
+        return MV_OK;
+    }
+
+    const int count = qBound(1, config.count, MAX_SIM_DEVICES);
+    for (int i = 0; i < count; ++i)
+    {
+        MV_CC_DEVICE_INFO& info = s_stSimDevices[i];
+        memset(&info, 0, sizeof(MV_CC_DEVICE_INFO));
+        info.nTLayerType = MV_GIGE_DEVICE;
+        MV_GIGE_DEVICE_INFO& gige = info.SpecialInfo.stGigEInfo;
+        gige.nCurrentIp = (127u << 24) | unsigned(i + 1);
+        snprintf((char*)gige.chManufacturerName, sizeof(gige.chManufacturerName), "UWC");
+        snprintf((char*)gige.chModelName, sizeof(gige.chModelName), "UWC-SIM");
+        snprintf((char*)gige.chSerialNumber, sizeof(gige.chSerialNumber), "SIM%03d", i);
+        pstDevList->pDeviceInfo[i] = &info;
+    }
+    pstDevList->nDeviceNum = count;
+    return MV_OK;
+}
+
+int CSimCamera::Open(MV_CC_DEVICE_INFO* pstDeviceInfo)
+{
+    if (MV_NULL == pstDeviceInfo)
+    {
+        return MV_E_PARAMETER;
+    }
+    if (m_bOpened)
+    {
+        return MV_E_CALLORDER;
+    }
+
+    m_stDevInfo = *pstDeviceInfo;
+    if (!PrepareFrames())
+    {
+        return MV_E_RESOURCE;
+    }
+    m_bOpened = true;
+    return MV_OK;
+}
+
+int CSimCamera::Close()
+{
+    if (!m_bOpened)
+    {
+        return MV_E_HANDLE;
+    }
+    StopGrabbing();
+    m_bOpened = false;
+    m_frames.clear();
+    m_framePool.release();
+    m_nPayloadSize = 0;
+    return MV_OK;
+}
+
+bool CSimCamera::IsDeviceConnected()
+{
+    return m_bOpened;
+}
+
+int CSimCamera::StartGrabbing()
+{
+    if (!m_bOpened || m_bGrabbing)
+    {
+        return MV_E_CALLORDER;
+    }
+    // ROI 或像素格式可能已修改，按当前节点重新生成帧源
+    if (!PrepareFrames())
+    {
+        return MV_E_RESOURCE;
+    }
+    int nRet = AllocateFramePool(PayloadSize());
+    if (MV_OK != nRet)
+    {
+        return nRet;
+    }
+
+    m_scratch.resize(PayloadSize());
+    m_nNextFrame = 0;
+    m_nFrameNum = 0;
+    m_nDropped = 0;
+    m_nDelivered = 0;
+    m_nextDue = Clock::now();
+    m_bGrabbing = true;
+    return MV_OK;
+}
+
+int CSimCamera::StopGrabbing()
+{
+    m_bGrabbing = false;
+    return MV_OK;
+}
+
+unsigned int CSimCamera::PayloadSize() const
+{
+    QMutexLocker locker(&m_nodeMutex);
+    const int64_t pixels = m_intNodes.value("Width").value * m_intNodes.value("Height").value;
+    if (isPacked(m_enPixelType)) return static_cast<unsigned int>(pixels * 3 / 2);
+    if (sampleBits(m_enPixelType) > 8) return static_cast<unsigned int>(pixels * 2);
+    return static_cast<unsigned int>(pixels);
+}
+
+bool CSimCamera::PrepareFrames()
+{
+    int64_t sensorW, sensorH, binnedW, binnedH, width, height, offsetX, offsetY;
+    {
+        QMutexLocker locker(&m_nodeMutex);
+        sensorW = m_nSensorWidth;
+        sensorH = m_nSensorHeight;
+        binnedW = m_intNodes.value("WidthMax").value;
+        binnedH = m_intNodes.value("HeightMax").value;
+        width   = m_intNodes.value("Width").value;
+        height  = m_intNodes.value("Height").value;
+        offsetX = m_intNodes.value("OffsetX").value;
+        offsetY = m_intNodes.value("OffsetY").value;
+    }
+    offsetX = std::min(offsetX, binnedW - width);
+    offsetY = std::min(offsetY, binnedH - height);
+    const cv::Rect roi(int(offsetX), int(offsetY), int(width), int(height));
+
+    std::vector<cv::Mat> sources;
+    const QFileInfo sourceInfo(m_config.source);
+    if (sourceInfo.isDir()) {
+        // 图像目录：按文件名顺序回放，统一缩放到传感器尺寸
+        QDir dir(m_config.source);
+        const QStringList files = dir.entryList({"*.png", "*.bmp", "*.tif", "*.tiff", "*.jpg", "*.jpeg"},
+                                                QDir::Files, QDir::Name);
+        for (const QString& file : files) {
+            cv::Mat gray = cv::imread(dir.filePath(file).toStdString(), cv::IMREAD_GRAYSCALE);
+            if (gray.empty()) continue;
+            if (gray.cols != sensorW || gray.rows != sensorH)
+                cv::resize(gray, gray, cv::Size(int(sensorW), int(sensorH)), 0, 0, cv::INTER_AREA);
+            sources.push_back(gray);
+        }
+    } else if (sourceInfo.isFile()) {
+        // 原始帧文件：已是目标像素格式，按 PayloadSize 切帧，不做 ROI
+        QFile file(m_config.source);
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        const unsigned int payload = PayloadSize();
+        std::vector<std::vector<unsigned char>> frames;
+        while (frames.size() < size_t(MAX_RAW_FRAMES)) {
+            std::vector<unsigned char> frame(payload);
+            if (file.read(reinterpret_cast<char*>(frame.data()), payload) != qint64(payload)) break;
+            frames.push_back(std::move(frame));
+        }
+        if (frames.empty()) return false;
+        m_frames = std::move(frames);
+        return true;
+    } else {
+        // 合成棋盘格：绕中心小幅旋转平移，模拟潜水员手持标定板
+        const cv::Mat board = makeChessboard(int(sensorW), int(sensorH), m_config.boardCols, m_config.boardRows);
+        const cv::Point2f center(sensorW / 2.0f, sensorH / 2.0f);
+        for (int i = 0; i < SYNTH_FRAME_COUNT; ++i) {
+            const double phase = 2.0 * CV_PI * i / SYNTH_FRAME_COUNT;
+            cv::Mat transform = cv::getRotationMatrix2D(center, 6.0 * std::sin(phase), 1.0);
+            transform.at<double>(0, 2) += 0.04 * sensorW * std::cos(phase);
+            transform.at<double>(1, 2) += 0.04 * sensorH * std::sin(phase);
+            cv::Mat frame;
+            cv::warpAffine(board, frame, transform, board.size(), cv::INTER_LINEAR,
+                           cv::BORDER_CONSTANT, cv::Scalar(160));
+            sources.push_back(frame);
+        }
+    }
+    if (sources.empty()) return false;
+
+    // 合并：按合并后的尺寸取区域均值
+    m_frames.clear();
+    m_frames.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        cv::Mat binned = sources[i];
+        if (binnedW != sensorW || binnedH != sensorH)
+            cv::resize(sources[i], binned, cv::Size(int(binnedW), int(binnedH)), 0, 0, cv::INTER_AREA);
+        EncodeFrame(binned(roi), m_frames[i]);
+    }
+    return true;
+}
+
+// 8 位灰度编码为目标像素格式（高位对齐扩展到 10/12 位）
+void CSimCamera::EncodeFrame(const cv::Mat& gray, std::vector<unsigned char>& out) const
+{
+    const int bits = sampleBits(m_enPixelType);
+    const int width = gray.cols, height = gray.rows;
+
+    if (bits == 8) {
+        out.resize(size_t(width) * height);
+        cv::Mat dst(height, width, CV_8UC1, out.data());
+        gray.copyTo(dst);
+        return;
+    }
+
+    auto expand = [bits](unsigned char g) -> uint16_t {
+        return uint16_t((g << (bits - 8)) | (g >> (16 - bits)));
+    };
+
+    if (!isPacked(m_enPixelType)) {
+        out.resize(size_t(width) * height * 2);
+        uint16_t* dst = reinterpret_cast<uint16_t*>(out.data());
+        for (int y = 0; y < height; ++y) {
+            const unsigned char* src = gray.ptr<unsigned char>(y);
+            for (int x = 0; x < width; ++x)
+                *dst++ = expand(src[x]);
+        }
+        return;
+    }
+
+    // GigE Vision Packed：每 2 个像素 3 字节
+    out.resize(size_t(width) * height * 3 / 2);
+    unsigned char* dst = out.data();
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* src = gray.ptr<unsigned char>(y);
+        for (int x = 0; x + 1 < width; x += 2) {
+            const uint16_t p0 = expand(src[x]), p1 = expand(src[x + 1]);
+            if (bits == 12) {
+                dst[0] = uint8_t(p0 >> 4);
+                dst[1] = uint8_t((p0 & 0x0F) | ((p1 & 0x0F) << 4));
+                dst[2] = uint8_t(p1 >> 4);
+            } else {
+                dst[0] = uint8_t(p0 >> 2);
+                dst[1] = uint8_t((p0 & 0x03) | ((p1 & 0x03) << 4));
+                dst[2] = uint8_t(p1 >> 2);
+            }
+            dst += 3;
+        }
+    }
+}
+
+// 按帧率节拍等待下一帧；消费者跟不上时像真实相机一样丢帧
+int CSimCamera::WaitNextFrame(int nMsec, MV_FRAME_OUT_INFO_EX* pFrameInfo)
+{
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(nMsec);
+    float fps, exposure, gain;
+    int64_t width, height;
+    {
+        QMutexLocker locker(&m_nodeMutex);
+        fps      = m_floatNodes.value("AcquisitionFrameRate").value;
+        exposure = m_floatNodes.value("ExposureTime").value;
+        gain     = m_floatNodes.value("Gain").value;
+        width    = m_intNodes.value("Width").value;
+        height   = m_intNodes.value("Height").value;
+    }
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+    for (;;)
+    {
+        if (!m_bGrabbing)
+        {
+            return MV_E_CALLORDER;
+        }
+        if (m_nextDue > deadline)
+        {
+            std::this_thread::sleep_until(deadline);
+            return MV_E_NODATA;
+        }
+        std::this_thread::sleep_until(m_nextDue);
+
+        const Clock::time_point now = Clock::now();
+        if (now - m_nextDue > period)
+        {
+            const unsigned int missed = static_cast<unsigned int>((now - m_nextDue) / period);
+            m_nFrameNum += missed;
+            m_nDropped += missed;
+            m_nextDue += period * missed;
+        }
+
+        Clock::duration jitter(0);
+        if (m_config.jitterMs > 0)
+        {
+            std::normal_distribution<double> dist(0.0, m_config.jitterMs);
+            jitter = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(dist(m_rng)));
+            jitter = std::max(jitter, -period / 2);
+        }
+        m_nextDue += period + jitter;
+        ++m_nFrameNum;
+
+        if (m_config.dropRate > 0 && std::bernoulli_distribution(m_config.dropRate)(m_rng))
+        {
+            ++m_nDropped;
+            continue;
+        }
+        break;
+    }
+
+    const uint64_t deviceNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    memset(pFrameInfo, 0, sizeof(MV_FRAME_OUT_INFO_EX));
+    pFrameInfo->nWidth            = static_cast<unsigned short>(width);
+    pFrameInfo->nHeight           = static_cast<unsigned short>(height);
+    pFrameInfo->nExtendWidth      = static_cast<unsigned int>(width);
+    pFrameInfo->nExtendHeight     = static_cast<unsigned int>(height);
+    pFrameInfo->enPixelType       = static_cast<MvGvspPixelType>(m_enPixelType);
+    pFrameInfo->nFrameNum         = m_nFrameNum;
+    pFrameInfo->nDevTimeStampHigh = static_cast<unsigned int>(deviceNs >> 32);
+    pFrameInfo->nDevTimeStampLow  = static_cast<unsigned int>(deviceNs & 0xFFFFFFFF);
+    pFrameInfo->nHostTimeStamp    = static_cast<int64_t>(deviceNs / 1000000);
+    pFrameInfo->nFrameLen         = PayloadSize();
+    pFrameInfo->fExposureTime     = exposure;
+    pFrameInfo->fGain             = gain;
+    ++m_nDelivered;
+    return MV_OK;
+}
+
+// 拷贝帧源；8 位格式按曝光和增益缩放亮度，便于调试自动曝光
+void CSimCamera::FillFrame(unsigned char* pDst, const std::vector<unsigned char>& src)
+{
+    float exposure, gain;
+    int64_t width, height;
+    {
+        QMutexLocker locker(&m_nodeMutex);
+        exposure = m_floatNodes.value("ExposureTime").value;
+        gain     = m_floatNodes.value("Gain").value;
+        width    = m_intNodes.value("Width").value;
+        height   = m_intNodes.value("Height").value;
+    }
+    const double factor = exposure / NOMINAL_EXPOSURE * std::pow(10.0, gain / 20.0);
+    if (sampleBits(m_enPixelType) == 8 && std::abs(factor - 1.0) > 1e-3
+        && src.size() == size_t(width * height))
+    {
+        const cv::Mat in(int(height), int(width), CV_8UC1, const_cast<unsigned char*>(src.data()));
+        cv::Mat out(int(height), int(width), CV_8UC1, pDst);
+        in.convertTo(out, -1, factor);
+        return;
+    }
+    memcpy(pDst, src.data(), src.size());
+}
+
+int CSimCamera::GetOneFrameTimeout(unsigned char* pData, unsigned int nDataSize, MV_FRAME_OUT_INFO_EX* pFrameInfo, int nMsec)
+{
+    if (MV_NULL == pData || MV_NULL == pFrameInfo)
+    {
+        return MV_E_PARAMETER;
+    }
+    if (m_frames.empty())
+    {
+        return MV_E_CALLORDER;
+    }
+    const std::vector<unsigned char>& src = m_frames[m_nNextFrame];
+    if (nDataSize < src.size())
+    {
+        return MV_E_NOENOUGH_BUF;
+    }
+
+    int nRet = WaitNextFrame(nMsec, pFrameInfo);
+    if (MV_OK != nRet)
+    {
+        return nRet;
+    }
+    FillFrame(pData, src);
+    m_nNextFrame = (m_nNextFrame + 1) % m_frames.size();
+    return MV_OK;
+}
+
+int CSimCamera::GetImageBuffer(MV_FRAME_OUT* pFrame, int nMsec)
+{
+    if (MV_NULL == pFrame)
+    {
+        return MV_E_PARAMETER;
+    }
+    memset(pFrame, 0, sizeof(MV_FRAME_OUT));
+    int nRet = GetOneFrameTimeout(m_scratch.data(), static_cast<unsigned int>(m_scratch.size()),
+                                  &pFrame->stFrameInfo, nMsec);
+    if (MV_OK != nRet)
+    {
+        return nRet;
+    }
+    pFrame->pBufAddr = m_scratch.data();
+    return MV_OK;
+}
+
+int CSimCamera::FreeImageBuffer(MV_FRAME_OUT* pFrame)
+{
+    Q_UNUSED(pFrame);
+    return MV_OK;
+}
+
+int CSimCamera::GetDeviceInfo(MV_CC_DEVICE_INFO* pstDevInfo)
+{
+    if (MV_NULL == pstDevInfo)
+    {
+        return MV_E_PARAMETER;
+    }
+    *pstDevInfo = m_stDevInfo;
+    return MV_OK;
+}
+
+// 模拟网络统计：注入的丢帧记为丢帧，数据量按已送出帧计算
+int CSimCamera::GetGevAllMatchInfo(MV_MATCH_INFO_NET_DETECT* pMatchInfoNetDetect)
+{
+    if (MV_NULL == pMatchInfoNetDetect)
+    {
+        return MV_E_PARAMETER;
+    }
+    memset(pMatchInfoNetDetect, 0, sizeof(MV_MATCH_INFO_NET_DETECT));
+    pMatchInfoNetDetect->nReceiveDataSize   = m_nDelivered * PayloadSize();
+    pMatchInfoNetDetect->nLostFrameCount    = m_nDropped;
+    pMatchInfoNetDetect->nNetRecvFrameCount = static_cast<unsigned int>(m_nDelivered);
+    return MV_OK;
+}
+
+int CSimCamera::GetOptimalPacketSize(unsigned int* pOptimalPacketSize)
+{
+    if (MV_NULL == pOptimalPacketSize)
+    {
+        return MV_E_PARAMETER;
+    }
+    *pOptimalPacketSize = 8164;
+    return MV_OK;
+}
+
+int CSimCamera::SetResend(unsigned int bEnable, unsigned int nMaxResendPercent, unsigned int nResendTimeout)
+{
+    if (!m_bOpened)
+    {
+        return MV_E_CALLORDER;
+    }
+    if (nMaxResendPercent > 100)
+    {
+        return MV_E_PARAMETER;
+    }
+    Q_UNUSED(nResendTimeout);
+    m_bResend = bEnable != 0;
+    return MV_OK;
+}
+
+int CSimCamera::SetResendMaxRetryTimes(unsigned int nRetryTimes)
+{
+    Q_UNUSED(nRetryTimes);
+    return m_bResend ? MV_OK : MV_E_CALLORDER;
+}
+
+int CSimCamera::SetResendTimeInterval(unsigned int nMillisec)
+{
+    Q_UNUSED(nMillisec);
+    return m_bResend ? MV_OK : MV_E_CALLORDER;
+}
+
+int CSimCamera::GetIntValue(IN const char* strKey, OUT MVCC_INTVALUE_EX* pIntValue)
+{
+    if (MV_NULL == strKey || MV_NULL == pIntValue)
+    {
+        return MV_E_PARAMETER;
+    }
+    if (QLatin1String(strKey) == QLatin1String("PayloadSize"))
+    {
+        memset(pIntValue, 0, sizeof(MVCC_INTVALUE_EX));
+        pIntValue->nCurValue = pIntValue->nMin = pIntValue->nMax = PayloadSize();
+        pIntValue->nInc = 1;
+        return MV_OK;
+    }
+
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_intNodes.constFind(QString::fromLatin1(strKey));
+    if (it == m_intNodes.constEnd())
+    {
+        return MV_E_SUPPORT;
+    }
+    memset(pIntValue, 0, sizeof(MVCC_INTVALUE_EX));
+    pIntValue->nCurValue = it->value;
+    pIntValue->nMin      = it->min;
+    pIntValue->nMax      = it->max;
+    pIntValue->nInc      = it->inc;
+    return MV_OK;
+}
+
+int CSimCamera::SetIntValue(IN const char* strKey, IN int64_t nValue)
+{
+    if (MV_NULL == strKey)
+    {
+        return MV_E_PARAMETER;
+    }
+    const QString key = QString::fromLatin1(strKey);
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_intNodes.find(key);
+    if (it == m_intNodes.end())
+    {
+        // 兼容按 Int 写 Float 节点的调用
+        auto fit = m_floatNodes.find(key);
+        if (fit == m_floatNodes.end())
+        {
+            return MV_E_SUPPORT;
+        }
+        fit->value = qBound(fit->min, float(nValue), fit->max);
+        return MV_OK;
+    }
+    if (key == "PayloadSize" || key == "WidthMax" || key == "HeightMax")
+    {
+        return MV_E_SUPPORT;
+    }
+    // ROI 和合并节点取流时不可写，与真实相机一致
+    const bool binning = key == "BinningHorizontal" || key == "BinningVertical";
+    if (m_bGrabbing && (binning || key == "Width" || key == "Height" || key == "OffsetX" || key == "OffsetY"))
+    {
+        return MV_E_CALLORDER;
+    }
+    if (nValue < it->min || nValue > it->max || (binning && nValue == 3))
+    {
+        return MV_E_PARAMETER;
+    }
+    it->value = nValue - (nValue - it->min) % std::max<int64_t>(1, it->inc);
+    if (binning)
+    {
+        UpdateBinnedGeometry();
+    }
+    return MV_OK;
+}
+
+// 合并倍数改变后更新最大尺寸，并把 ROI 限制在新的范围内
+void CSimCamera::UpdateBinnedGeometry()
+{
+    const int64_t binH = m_intNodes.value("BinningHorizontal").value;
+    const int64_t binV = m_intNodes.value("BinningVertical").value;
+    const int64_t maxW = std::max<int64_t>(2, (m_nSensorWidth / binH) & ~int64_t(1));
+    const int64_t maxH = std::max<int64_t>(1, m_nSensorHeight / binV);
+    m_intNodes["WidthMax"]  = { maxW, maxW, maxW, 1 };
+    m_intNodes["HeightMax"] = { maxH, maxH, maxH, 1 };
+
+    IntNode& width  = m_intNodes["Width"];
+    IntNode& height = m_intNodes["Height"];
+    width.max    = maxW;
+    width.value  = std::min(width.value, maxW);
+    height.max   = maxH;
+    height.value = std::min(height.value, maxH);
+
+    IntNode& offsetX = m_intNodes["OffsetX"];
+    IntNode& offsetY = m_intNodes["OffsetY"];
+    offsetX.max   = maxW - 2;
+    offsetX.value = std::min(offsetX.value, maxW - width.value);
+    offsetY.max   = maxH - 1;
+    offsetY.value = std::min(offsetY.value, maxH - height.value);
+}
+
+int CSimCamera::GetFloatValue(IN const char* strKey, OUT MVCC_FLOATVALUE* pFloatValue)
+{
+    if (MV_NULL == strKey || MV_NULL == pFloatValue)
+    {
+        return MV_E_PARAMETER;
+    }
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_floatNodes.constFind(QString::fromLatin1(strKey));
+    if (it == m_floatNodes.constEnd())
+    {
+        return MV_E_SUPPORT;
+    }
+    memset(pFloatValue, 0, sizeof(MVCC_FLOATVALUE));
+    pFloatValue->fCurValue = it->value;
+    pFloatValue->fMin      = it->min;
+    pFloatValue->fMax      = it->max;
+    return MV_OK;
+}
+
+int CSimCamera::SetFloatValue(IN const char* strKey, IN float fValue)
+{
+    if (MV_NULL == strKey)
+    {
+        return MV_E_PARAMETER;
+    }
+    const QString key = QString::fromLatin1(strKey);
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_floatNodes.find(key);
+    if (it == m_floatNodes.end() || key == "ResultingFrameRate")
+    {
+        return MV_E_SUPPORT;
+    }
+    if (fValue < it->min || fValue > it->max)
+    {
+        return MV_E_PARAMETER;
+    }
+    it->value = fValue;
+    if (key == "AcquisitionFrameRate")
+    {
+        m_floatNodes["ResultingFrameRate"].value = fValue;
+    }
+    return MV_OK;
+}
+
+int CSimCamera::GetBoolValue(IN const char* strKey, OUT bool* pbValue)
+{
+    if (MV_NULL == strKey || MV_NULL == pbValue)
+    {
+        return MV_E_PARAMETER;
+    }
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_boolNodes.constFind(QString::fromLatin1(strKey));
+    if (it == m_boolNodes.constEnd())
+    {
+        return MV_E_SUPPORT;
+    }
+    *pbValue = it.value();
+    return MV_OK;
+}
+
+int CSimCamera::SetBoolValue(IN const char* strKey, IN bool bValue)
+{
+    if (MV_NULL == strKey)
+    {
+        return MV_E_PARAMETER;
+    }
+    QMutexLocker locker(&m_nodeMutex);
+    auto it = m_boolNodes.find(QString::fromLatin1(strKey));
+    if (it == m_boolNodes.end())
+    {
+        return MV_E_SUPPORT;
+    }
+    it.value() = bValue;
+    return MV_OK;
+}
+
+int CSimCamera::GetEnumValue(IN const char* strKey, OUT MVCC_ENUMVALUE* pEnumValue)
+{
+    if (MV_NULL == strKey || MV_NULL == pEnumValue)
+    {
+        return MV_E_PARAMETER;
+    }
+    if (QLatin1String(strKey) != QLatin1String("PixelFormat"))
+    {
+        return MV_E_SUPPORT;
+    }
+    memset(pEnumValue, 0, sizeof(MVCC_ENUMVALUE));
+    pEnumValue->nCurValue = m_enPixelType;
+    pEnumValue->nSupportedNum = 1;
+    pEnumValue->nSupportValue[0] = m_enPixelType;
+    return MV_OK;
+}
+
+int CSimCamera::SetEnumValue(IN const char* strKey, IN unsigned int nValue)
+{
+    if (MV_NULL == strKey)
+    {
+        return MV_E_PARAMETER;
+    }
+    if (QLatin1String(strKey) != QLatin1String("PixelFormat") || m_bGrabbing)
+    {
+        return MV_E_SUPPORT;
+    }
+    m_enPixelType = nValue;
+    return MV_OK;
+}
+
+int CSimCamera::CommandExecute(IN const char* strKey)
+{
+    Q_UNUSED(strKey);
+    return MV_OK;
+}
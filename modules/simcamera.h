@@ -0,0 +1,107 @@
+#ifndef SIM_CAMERA_H
+#define SIM_CAMERA_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "cmvcamera.h"
+
+// 模拟相机配置，读取自 ini 的 [Simulation] 分组
+struct SimCameraConfig {
+    bool    enabled = false;
+    int     count = 1;                  // 模拟相机台数
+    QString source = "chessboard";      // chessboard / 图像目录 / 原始帧文件
+    int     width = 2448;               // 传感器尺寸，图像源会缩放到该尺寸
+    int     height = 2048;
+    QString pixelFormat = "Mono8";      // Mono8/10/12、Mono10Packed/12Packed、Bayer**8
+    double  frameRate = 30.0;
+    double  jitterMs = 0.0;             // 帧间隔抖动(标准差)
+    double  dropRate = 0.0;             // 丢帧概率 0~1
+    int     boardCols = 9;              // 合成棋盘格内角点数
+    int     boardRows = 6;
+
+    // 默认读取应用配置文件；环境变量 UWC_SIM_CONFIG 可指定另一份 ini，
+    // UWC_SIM_CAMERA=1 强制启用（便于在无相机的构建机上跑基准）
+    static SimCameraConfig load();
+    static unsigned int pixelTypeFromName(const QString& name);
+};
+
+// 模拟相机：与 CMvCamera 接口一致，回放图像目录/原始帧文件或生成合成棋盘格，
+// 按设定帧率出图，可注入抖动和丢帧，供无硬件的基准测试和问题复现使用
+class CSimCamera : public CMvCamera
+{
+public:
+    explicit CSimCamera(const SimCameraConfig& config);
+    ~CSimCamera() override;
+
+    // ch:枚举模拟设备，返回的设备信息在下次枚举前有效 | en:Enumerate simulated devices
+    static int EnumDevices(const SimCameraConfig& config, MV_CC_DEVICE_INFO_LIST* pstDevList);
+
+    int Open(MV_CC_DEVICE_INFO* pstDeviceInfo) override;
+    int Close() override;
+    bool IsDeviceConnected() override;
+
+    int StartGrabbing() override;
+    int StopGrabbing() override;
+    int GetImageBuffer(MV_FRAME_OUT* pFrame, int nMsec) override;
+    int FreeImageBuffer(MV_FRAME_OUT* pFrame) override;
+    int GetOneFrameTimeout(unsigned char* pData, unsigned int nDataSize, MV_FRAME_OUT_INFO_EX* pFrameInfo, int nMsec) override;
+
+    int GetDeviceInfo(MV_CC_DEVICE_INFO* pstDevInfo) override;
+    int GetGevAllMatchInfo(MV_MATCH_INFO_NET_DETECT* pMatchInfoNetDetect) override;
+    int GetOptimalPacketSize(unsigned int* pOptimalPacketSize) override;
+    int SetResend(unsigned int bEnable, unsigned int nMaxResendPercent, unsigned int nResendTimeout) override;
+    int SetResendMaxRetryTimes(unsigned int nRetryTimes) override;
+    int SetResendTimeInterval(unsigned int nMillisec) override;
+
+    int GetIntValue(IN const char* strKey, OUT MVCC_INTVALUE_EX *pIntValue) override;
+    int SetIntValue(IN const char* strKey, IN int64_t nValue) override;
+    int GetFloatValue(IN const char* strKey, OUT MVCC_FLOATVALUE *pFloatValue) override;
+    int SetFloatValue(IN const char* strKey, IN float fValue) override;
+    int GetBoolValue(IN const char* strKey, OUT bool *pbValue) override;
+    int SetBoolValue(IN const char* strKey, IN bool bValue) override;
+    int GetEnumValue(IN const char* strKey, OUT MVCC_ENUMVALUE *pEnumValue) override;
+    int SetEnumValue(IN const char* strKey, IN unsigned int nValue) override;
+    int CommandExecute(IN const char* strKey) override;
+
+private:
+    struct IntNode   { int64_t value; int64_t min; int64_t max; int64_t inc; };
+    struct FloatNode { float value; float min; float max; };
+    using Clock = std::chrono::steady_clock;
+
+    bool PrepareFrames();
+    void EncodeFrame(const cv::Mat& gray, std::vector<unsigned char>& out) const;
+    unsigned int PayloadSize() const;
+    int WaitNextFrame(int nMsec, MV_FRAME_OUT_INFO_EX* pFrameInfo);
+    void FillFrame(unsigned char* pDst, const std::vector<unsigned char>& src);
+    void UpdateBinnedGeometry();            // 调用方需持有 m_nodeMutex
+
+    SimCameraConfig m_config;
+    MV_CC_DEVICE_INFO m_stDevInfo;
+    bool m_bOpened;
+    bool m_bGrabbing;
+    bool m_bResend;                         // 仅记录状态，模拟链路不产生丢包
+
+    mutable QMutex m_nodeMutex;
+    QHash<QString, IntNode>   m_intNodes;
+    QHash<QString, FloatNode> m_floatNodes;
+    QHash<QString, bool>      m_boolNodes;
+    int64_t m_nSensorWidth;                 // 全分辨率传感器尺寸；WidthMax/HeightMax 为合并后的尺寸
+    int64_t m_nSensorHeight;
+    unsigned int m_enPixelType;
+
+    // 帧源：已按目标像素格式编码，取流时只做拷贝
+    std::vector<std::vector<unsigned char>> m_frames;
+    std::vector<unsigned char> m_scratch;   // GetImageBuffer 借出的缓存
+    size_t m_nNextFrame;
+    unsigned int m_nFrameNum;
+    unsigned int m_nDropped;
+    int64_t m_nDelivered;
+    Clock::time_point m_nextDue;
+    std::mt19937 m_rng;
+};
+
+#endif // SIM_CAMERA_H
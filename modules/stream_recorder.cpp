@@ -0,0 +1,322 @@
+#include "stream_recorder.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <cstring>
+
+StreamRecorder::StreamRecorder(QObject* parent)
+    : QObject(parent)
+    , m_abort(0)
+    , m_failed(0)
+{}
+
+StreamRecorder::~StreamRecorder()
+{
+    stop();
+}
+
+QString StreamRecorder::indexPathFor(const QString& dataPath)
+{
+    const QFileInfo info(dataPath);
+    return info.dir().filePath(info.completeBaseName() + ".uwcidx");
+}
+
+bool StreamRecorder::start(std::shared_ptr<FrameRing> rawRing, const QString& path, const Options& options)
+{
+    if (!rawRing || m_copyThread) return false;
+
+    m_dataFile.setFileName(path);
+    m_indexFile.setFileName(indexPathFor(path));
+    // 无缓冲：写入块已足够大，直接交给系统顺序写
+    if (!m_dataFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) return false;
+    if (!m_indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_dataFile.close();
+        return false;
+    }
+
+    const quint64 chunkBytes = RawContainer::alignUp(quint64(qMax(options.chunkBytes, int(RawContainer::Alignment))));
+
+    // 文件头：数据文件占满第一页，之后的帧偏移都按页对齐
+    std::vector<char> page(RawContainer::DataHeaderSize, 0);
+    RawContainer::DataHeader* header = reinterpret_cast<RawContainer::DataHeader*>(page.data());
+    memcpy(header->magic, RawContainer::DataMagic, sizeof(header->magic));
+    header->version   = RawContainer::Version;
+    header->alignment = RawContainer::Alignment;
+    header->chunkSize = quint32(chunkBytes);
+    header->createdMs = QDateTime::currentMSecsSinceEpoch();
+    const QByteArray device = options.device.toUtf8().left(int(sizeof(header->device)) - 1);
+    memcpy(header->device, device.constData(), size_t(device.size()));
+
+    RawContainer::IndexHeader indexHeader{};
+    memcpy(indexHeader.magic, RawContainer::IndexMagic, sizeof(indexHeader.magic));
+    indexHeader.version   = RawContainer::Version;
+    indexHeader.entrySize = sizeof(RawContainer::IndexEntry);
+
+    if (!writeAll(m_dataFile, page.data(), qint64(page.size()))
+        || !writeAll(m_indexFile, reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader))) {
+        m_dataFile.close();
+        m_indexFile.close();
+        return false;
+    }
+    m_indexFile.flush();
+    m_nextOffset = RawContainer::DataHeaderSize;
+
+    // 缓存块一次分配，按页对齐
+    m_free.clear();
+    m_full.clear();
+    m_chunks.clear();
+    for (int i = 0; i < qMax(2, options.chunkCount); ++i) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->data = static_cast<unsigned char*>(qMallocAligned(size_t(chunkBytes), RawContainer::Alignment));
+        if (!chunk->data) {
+            releaseChunks();
+            m_dataFile.close();
+            m_indexFile.close();
+            return false;
+        }
+        chunk->capacity = chunkBytes;
+        m_free.append(chunk.get());
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    m_consumerId = rawRing->addConsumer(QStringLiteral("recorder"), FrameRing::DropOldest);
+    if (m_consumerId < 0) {
+        releaseChunks();
+        m_dataFile.close();
+        m_indexFile.close();
+        return false;
+    }
+    m_ring = std::move(rawRing);
+
+    m_abort.storeRelease(0);
+    m_failed.storeRelease(0);
+    m_ioStop = false;
+    m_framesWritten.store(0);
+    m_localDrops.store(0);
+    m_bytesWritten.store(0);
+    m_stalls.store(0);
+    m_chunksWritten.store(0);
+    m_writeNs.store(0);
+    m_maxQueued.store(0);
+    m_ringDropped = 0;
+    m_clock.start();
+
+    m_ioThread = QThread::create([this]() { ioLoop(); });
+    m_copyThread = QThread::create([this]() { copyLoop(); });
+    m_ioThread->start();
+    m_copyThread->start(QThread::HighPriority);
+    return true;
+}
+
+void StreamRecorder::stop()
+{
+    if (!m_copyThread) return;
+
+    // 先停录制线程（它会提交最后一个未满的块），再让 I/O 线程写完队列后退出
+    m_abort.storeRelease(1);
+    m_copyThread->wait();
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_ioStop = true;
+        m_chunkFull.wakeAll();
+    }
+    m_ioThread->wait();
+    delete m_copyThread;
+    delete m_ioThread;
+    m_copyThread = nullptr;
+    m_ioThread = nullptr;
+
+    m_ringDropped = m_ring->stats(m_consumerId).dropped;
+    m_ring->removeConsumer(m_consumerId);
+    m_consumerId = -1;
+    m_ring.reset();
+
+    m_indexFile.close();
+    m_dataFile.close();
+    releaseChunks();
+}
+
+void StreamRecorder::releaseChunks()
+{
+    for (auto& chunk : m_chunks)
+        qFreeAligned(chunk->data);
+    m_chunks.clear();
+    m_free.clear();
+    m_full.clear();
+}
+
+StreamRecorder::Stats StreamRecorder::stats() const
+{
+    Stats out;
+    out.framesWritten = m_framesWritten.load();
+    out.bytesWritten  = m_bytesWritten.load();
+    out.stalls        = m_stalls.load();
+    out.framesDropped = m_localDrops.load()
+                        + (m_ring ? m_ring->stats(m_consumerId).dropped : m_ringDropped);
+    out.maxQueuedChunks = m_maxQueued.load();
+    {
+        QMutexLocker locker(&m_queueMutex);
+        out.queuedChunks = m_full.size();
+    }
+    const quint64 chunks = m_chunksWritten.load();
+    const double writeSec = m_writeNs.load() / 1e9;
+    if (chunks > 0)
+        out.avgChunkWriteMs = writeSec * 1e3 / chunks;
+    if (writeSec > 0)
+        out.writeMBps = out.bytesWritten / writeSec / 1e6;
+    out.elapsedSec = m_clock.isValid() ? m_clock.elapsed() / 1000.0 : 0;
+    return out;
+}
+
+StreamRecorder::Chunk* StreamRecorder::takeFreeChunk(int timeoutMs)
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (m_free.isEmpty()) {
+        m_stalls.fetch_add(1, std::memory_order_relaxed);
+        m_chunkFree.wait(&m_queueMutex, timeoutMs);
+        if (m_free.isEmpty()) return nullptr;
+    }
+    return m_free.takeFirst();
+}
+
+void StreamRecorder::submitChunk(Chunk* chunk)
+{
+    m_nextOffset += chunk->used;
+    QMutexLocker locker(&m_queueMutex);
+    m_full.append(chunk);
+    if (m_full.size() > m_maxQueued.load(std::memory_order_relaxed))
+        m_maxQueued.store(m_full.size(), std::memory_order_relaxed);
+    m_chunkFull.wakeOne();
+}
+
+// 录制线程：取帧并拷入当前块，帧偏移按页对齐，块满后交给 I/O 线程
+void StreamRecorder::copyLoop()
+{
+    Chunk* current = nullptr;
+    while (!m_abort.loadAcquire()) {
+        FrameHandle frame;
+        if (!m_ring->waitPop(m_consumerId, frame, 100)) continue;
+
+        const FrameMeta& meta = frame.meta();
+        const quint64 size = meta.dataSize;
+        if (m_failed.loadAcquire() || size == 0 || size > frame.capacity()) {
+            m_localDrops.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        const quint64 aligned = RawContainer::alignUp(size);
+
+        if (current && current->used + aligned > current->capacity) {
+            submitChunk(current);
+            current = nullptr;
+        }
+        if (!current) {
+            current = takeFreeChunk(50);
+            if (!current) {
+                m_localDrops.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            // 单帧超过块大小时放大该块
+            if (aligned > current->capacity) {
+                unsigned char* data = static_cast<unsigned char*>(qMallocAligned(size_t(aligned), RawContainer::Alignment));
+                if (!data) {
+                    QMutexLocker locker(&m_queueMutex);
+                    m_free.append(current);
+                    current = nullptr;
+                    m_localDrops.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                qFreeAligned(current->data);
+                current->data = data;
+                current->capacity = aligned;
+            }
+            current->used = 0;
+            current->fileOffset = m_nextOffset;
+            current->entries.clear();
+        }
+
+        unsigned char* dst = current->data + current->used;
+        memcpy(dst, frame.data(), size_t(size));
+        if (aligned > size)
+            memset(dst + size, 0, size_t(aligned - size));
+
+        RawContainer::IndexEntry entry{};
+        entry.offset          = current->fileOffset + current->used;
+        entry.size            = quint32(size);
+        entry.frameNumber     = meta.frameNumber;
+        entry.sequence        = meta.sequence;
+        entry.deviceTimestamp = meta.deviceTimestamp;
+        entry.hostTimestamp   = meta.hostTimestamp;
+        entry.pixelType       = meta.pixelType;
+        entry.width           = quint32(meta.width);
+        entry.height          = quint32(meta.height);
+        entry.exposureTime    = meta.exposureTime;
+        entry.gain            = meta.gain;
+        current->entries.push_back(entry);
+        current->used += aligned;
+        frame.reset();      // 尽早归还采集缓存槽
+    }
+    if (current) {
+        if (current->used > 0) {
+            submitChunk(current);
+        } else {
+            QMutexLocker locker(&m_queueMutex);
+            m_free.append(current);
+        }
+    }
+}
+
+// I/O 线程：按提交顺序写块，数据写完后再追加该块的索引
+void StreamRecorder::ioLoop()
+{
+    for (;;) {
+        Chunk* chunk = nullptr;
+        {
+            QMutexLocker locker(&m_queueMutex);
+            while (m_full.isEmpty() && !m_ioStop)
+                m_chunkFull.wait(&m_queueMutex);
+            if (m_full.isEmpty()) break;        // 已停止且队列写完
+            chunk = m_full.takeFirst();
+        }
+
+        if (!m_failed.loadAcquire() && !writeChunk(chunk)) {
+            m_failed.storeRelease(1);
+            emit errorOccurred(tr("录制写入失败: %1").arg(m_dataFile.errorString()));
+        }
+
+        QMutexLocker locker(&m_queueMutex);
+        m_free.append(chunk);
+        m_chunkFree.wakeOne();
+    }
+    m_indexFile.flush();
+}
+
+bool StreamRecorder::writeChunk(Chunk* chunk)
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (!writeAll(m_dataFile, reinterpret_cast<const char*>(chunk->data), qint64(chunk->used)))
+        return false;
+    m_writeNs.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+
+    const qint64 indexBytes = qint64(chunk->entries.size() * sizeof(RawContainer::IndexEntry));
+    if (!writeAll(m_indexFile, reinterpret_cast<const char*>(chunk->entries.data()), indexBytes))
+        return false;
+    m_indexFile.flush();
+
+    m_bytesWritten.fetch_add(chunk->used, std::memory_order_relaxed);
+    m_framesWritten.fetch_add(chunk->entries.size(), std::memory_order_relaxed);
+    m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool StreamRecorder::writeAll(QFile& file, const char* data, qint64 size)
+{
+    while (size > 0) {
+        const qint64 written = file.write(data, size);
+        if (written <= 0) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
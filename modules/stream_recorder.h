@@ -0,0 +1,106 @@
+#ifndef STREAM_RECORDER_H
+#define STREAM_RECORDER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "frame_ring.h"
+#include "raw_container.h"
+
+// 原始帧录制：从采集引擎的原始帧队列取帧（DropOldest，不反压采集），
+// 拷入大块对齐缓存后交给独立 I/O 线程顺序写入容器文件（格式见 raw_container.h）
+// 写盘跟不上时缓存块耗尽，录制线程等待期间队列按策略丢帧，丢帧和等待次数计入统计
+class StreamRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int     chunkBytes = 64 << 20;  // 写入块大小，按 4 KB 对齐；单帧更大时自动放大
+        int     chunkCount = 4;         // 缓存块数，决定能吸收多长的写盘抖动
+        QString device;                 // 写入文件头的设备描述
+    };
+
+    struct Stats {
+        quint64 framesWritten = 0;      // 已落盘（索引已写）的帧
+        quint64 framesDropped = 0;      // 队列丢帧 + 无空闲缓存块时丢弃的帧
+        quint64 bytesWritten = 0;
+        quint64 stalls = 0;             // 等待空闲缓存块的次数
+        int     queuedChunks = 0;       // 待写块数
+        int     maxQueuedChunks = 0;
+        double  avgChunkWriteMs = 0;
+        double  writeMBps = 0;          // 平均写盘吞吐（只计写调用耗时）
+        double  elapsedSec = 0;
+    };
+
+    explicit StreamRecorder(QObject* parent = nullptr);
+    ~StreamRecorder() override;
+
+    // path 为数据文件路径，索引文件见 indexPathFor()
+    bool start(std::shared_ptr<FrameRing> rawRing, const QString& path, const Options& options = Options());
+    // 写完已缓存的数据后关闭文件
+    void stop();
+    bool isRecording() const { return m_copyThread != nullptr; }
+
+    Stats stats() const;
+    QString dataPath() const { return m_dataFile.fileName(); }
+    static QString indexPathFor(const QString& dataPath);
+
+signals:
+    // 在 I/O 线程中发出；发生写错误后录制不再落盘
+    void errorOccurred(const QString& error);
+
+private:
+    struct Chunk {
+        unsigned char* data = nullptr;
+        quint64 capacity = 0;
+        quint64 used = 0;
+        quint64 fileOffset = 0;
+        std::vector<RawContainer::IndexEntry> entries;
+    };
+
+    void copyLoop();
+    void ioLoop();
+    Chunk* takeFreeChunk(int timeoutMs);
+    void submitChunk(Chunk* chunk);
+    bool writeChunk(Chunk* chunk);
+    bool writeAll(QFile& file, const char* data, qint64 size);
+    void releaseChunks();
+
+    std::shared_ptr<FrameRing> m_ring;
+    int        m_consumerId = -1;
+    QThread*   m_copyThread = nullptr;
+    QThread*   m_ioThread = nullptr;
+    QAtomicInt m_abort;
+    QAtomicInt m_failed;
+    QFile      m_dataFile;
+    QFile      m_indexFile;
+    quint64    m_nextOffset = 0;        // 仅录制线程
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    mutable QMutex m_queueMutex;
+    QWaitCondition m_chunkFree;
+    QWaitCondition m_chunkFull;
+    QList<Chunk*>  m_free;
+    QList<Chunk*>  m_full;
+    bool           m_ioStop = false;
+
+    std::atomic<quint64> m_framesWritten{0};
+    std::atomic<quint64> m_localDrops{0};
+    std::atomic<quint64> m_bytesWritten{0};
+    std::atomic<quint64> m_stalls{0};
+    std::atomic<quint64> m_chunksWritten{0};
+    std::atomic<qint64>  m_writeNs{0};
+    std::atomic<int>     m_maxQueued{0};
+    quint64 m_ringDropped = 0;          // 停止时保存队列的丢帧数
+    QElapsedTimer m_clock;
+};
+
+#endif // STREAM_RECORDER_H
@@ -0,0 +1,244 @@
+#include "telemetry.h"
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QtAlgorithms>
+
+/*-------------------------------- LatencyHistogram --------------------------------*/
+LatencyHistogram::LatencyHistogram()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+// 0~3 us 各占一桶，之后每个 2 的幂按次高两位再分 4 桶
+int LatencyHistogram::bucketOf(qint64 us)
+{
+    if (us < 4) return us < 0 ? 0 : int(us);
+    const int msb = 63 - qCountLeadingZeroBits(quint64(us));
+    const int sub = int((us >> (msb - 2)) & 3);
+    return qMin((msb - 1) * 4 + sub, BucketCount - 1);
+}
+
+qint64 LatencyHistogram::bucketUpper(int index)
+{
+    if (index < 4) return index;
+    const int msb = index / 4 + 1;
+    const int sub = index % 4;
+    const qint64 lower = qint64(4 + sub) << (msb - 2);
+    return lower + (qint64(1) << (msb - 2)) - 1;
+}
+
+void LatencyHistogram::record(qint64 us)
+{
+    m_buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(us, std::memory_order_relaxed);
+
+    qint64 previous = m_max.load(std::memory_order_relaxed);
+    while (us > previous && !m_max.compare_exchange_weak(previous, us, std::memory_order_relaxed)) {}
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot out;
+    quint64 counts[BucketCount];
+    for (int i = 0; i < BucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        out.count += counts[i];
+    }
+    if (out.count == 0) return out;
+
+    out.mean = double(m_sum.load(std::memory_order_relaxed)) / out.count;
+    out.max  = m_max.load(std::memory_order_relaxed);
+
+    // 分位数取桶上界，并不超过实测最大值
+    const quint64 rank50 = (out.count * 50 + 99) / 100;
+    const quint64 rank90 = (out.count * 90 + 99) / 100;
+    const quint64 rank99 = (out.count * 99 + 99) / 100;
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (counts[i] == 0) continue;
+        seen += counts[i];
+        const qint64 upper = qMin(bucketUpper(i), out.max);
+        if (!out.p50 && seen >= rank50) out.p50 = upper;
+        if (!out.p90 && seen >= rank90) out.p90 = upper;
+        if (!out.p99 && seen >= rank99) { out.p99 = upper; break; }
+    }
+    return out;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0);
+    m_sum.store(0);
+    m_max.store(0);
+}
+
+/*-------------------------------- StreamTelemetry --------------------------------*/
+StreamTelemetry::StreamTelemetry(int cameraIndex, int historySize)
+    : m_cameraIndex(cameraIndex)
+    , m_history(size_t(qMax(historySize, 16)))
+{}
+
+QString StreamTelemetry::stageName(Stage stage)
+{
+    switch (stage) {
+    case FrameInterval: return QStringLiteral("帧间隔");
+    case Convert:       return QStringLiteral("格式转换");
+    case Analyze:       return QStringLiteral("画面统计");
+    case Dispatch:      return QStringLiteral("分发");
+    case ToPreview:     return QStringLiteral("到达->预览");
+    case ToDisplay:     return QStringLiteral("到达->显示");
+    default:            return QString();
+    }
+}
+
+unsigned int StreamTelemetry::recordFrame(FrameRecord record)
+{
+    // 帧号回退视为相机重启计数，不算跳变
+    record.gap = 0;
+    if (m_hasLastFrame && record.frameNumber > m_lastFrameNumber + 1)
+        record.gap = record.frameNumber - m_lastFrameNumber - 1;
+    m_lastFrameNumber = record.frameNumber;
+    m_hasLastFrame = true;
+
+    if (record.gap) {
+        m_gapEvents.fetch_add(1, std::memory_order_relaxed);
+        m_missingFrames.fetch_add(record.gap, std::memory_order_relaxed);
+    }
+    m_lostPackets.fetch_add(record.lostPackets, std::memory_order_relaxed);
+
+    const qint64 previousHost = m_lastHost.load(std::memory_order_relaxed);
+    if (previousHost > 0)
+        m_stages[FrameInterval].record(record.hostTimestamp - previousHost);
+    else
+        m_firstHost.store(record.hostTimestamp, std::memory_order_relaxed);
+    m_lastHost.store(record.hostTimestamp, std::memory_order_relaxed);
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+
+    // 写入历史环：先把序号置 0，读者据此跳过正在写的槽
+    const quint64 position = m_historyHead.load(std::memory_order_relaxed);
+    HistorySlot& slot = m_history[position % m_history.size()];
+    slot.seq.store(0, std::memory_order_release);
+    slot.record = record;
+    slot.seq.store(position + 1, std::memory_order_release);
+    m_historyHead.store(position + 1, std::memory_order_release);
+    return record.gap;
+}
+
+void StreamTelemetry::recordLocalDrop()
+{
+    m_localDrops.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StreamTelemetry::recordStage(Stage stage, qint64 us)
+{
+    if (stage < 0 || stage >= StageCount) return;
+    m_stages[stage].record(us);
+}
+
+void StreamTelemetry::updateLink(const LinkStats& link)
+{
+    QMutexLocker locker(&m_linkMutex);
+    m_link = link;
+}
+
+StreamTelemetry::Summary StreamTelemetry::summary() const
+{
+    Summary out;
+    out.cameraIndex   = m_cameraIndex;
+    out.frames        = m_frames.load(std::memory_order_relaxed);
+    out.gapEvents     = m_gapEvents.load(std::memory_order_relaxed);
+    out.missingFrames = m_missingFrames.load(std::memory_order_relaxed);
+    out.lostPackets   = m_lostPackets.load(std::memory_order_relaxed);
+    out.localDrops    = m_localDrops.load(std::memory_order_relaxed);
+    out.firstHost     = m_firstHost.load(std::memory_order_relaxed);
+    out.lastHost      = m_lastHost.load(std::memory_order_relaxed);
+    if (out.frames > 1 && out.lastHost > out.firstHost)
+        out.fps = (out.frames - 1) * 1e6 / double(out.lastHost - out.firstHost);
+    for (int i = 0; i < StageCount; ++i)
+        out.stages[i] = m_stages[i].snapshot();
+    {
+        QMutexLocker locker(&m_linkMutex);
+        out.link = m_link;
+    }
+    return out;
+}
+
+QList<StreamTelemetry::FrameRecord> StreamTelemetry::history() const
+{
+    QList<FrameRecord> list;
+    const quint64 head = m_historyHead.load(std::memory_order_acquire);
+    const quint64 size = m_history.size();
+    const quint64 first = head > size ? head - size : 0;
+    list.reserve(int(head - first));
+    for (quint64 position = first; position < head; ++position) {
+        const HistorySlot& slot = m_history[position % size];
+        if (slot.seq.load(std::memory_order_acquire) != position + 1) continue;
+        const FrameRecord record = slot.record;
+        // 复制期间被覆盖则丢弃
+        if (slot.seq.load(std::memory_order_acquire) != position + 1) continue;
+        list.append(record);
+    }
+    return list;
+}
+
+bool StreamTelemetry::exportCsv(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    const Summary s = summary();
+    QTextStream out(&file);
+    out << "# camera," << s.cameraIndex << "\n";
+    out << "# exported," << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    out << "# frames," << s.frames << ",fps," << QString::number(s.fps, 'f', 2) << "\n";
+    out << "# gap_events," << s.gapEvents << ",missing_frames," << s.missingFrames
+        << ",lost_packets_in_frames," << s.lostPackets << ",local_drops," << s.localDrops << "\n";
+    if (s.link.valid) {
+        out << "# link," << (s.link.gige ? "GigE" : "U3V")
+            << ",received_bytes," << s.link.receivedBytes
+            << ",received_frames," << s.link.receivedFrames
+            << ",lost_frames," << s.link.lostFrames
+            << ",lost_packets," << s.link.lostPackets
+            << ",resend_requests," << s.link.resendRequests
+            << ",resends," << s.link.resends
+            << ",error_frames," << s.link.errorFrames << "\n";
+    }
+    out << "# stage,count,mean_us,p50_us,p90_us,p99_us,max_us\n";
+    for (int i = 0; i < StageCount; ++i) {
+        const LatencyHistogram::Snapshot& h = s.stages[i];
+        out << "# " << stageName(Stage(i)) << "," << h.count << "," << QString::number(h.mean, 'f', 1)
+            << "," << h.p50 << "," << h.p90 << "," << h.p99 << "," << h.max << "\n";
+    }
+
+    out << "sequence,frame_number,gap,lost_packets,device_timestamp,host_timestamp_us,convert_us,dispatch_us\n";
+    for (const FrameRecord& r : history()) {
+        out << r.sequence << "," << r.frameNumber << "," << r.gap << "," << r.lostPackets << ","
+            << r.deviceTimestamp << "," << r.hostTimestamp << "," << r.convertUs << "," << r.dispatchUs << "\n";
+    }
+    return out.status() == QTextStream::Ok;
+}
+
+void StreamTelemetry::reset()
+{
+    for (auto& stage : m_stages)
+        stage.reset();
+    m_frames.store(0);
+    m_gapEvents.store(0);
+    m_missingFrames.store(0);
+    m_lostPackets.store(0);
+    m_localDrops.store(0);
+    m_firstHost.store(0);
+    m_lastHost.store(0);
+    m_hasLastFrame = false;
+    m_lastFrameNumber = 0;
+    for (auto& slot : m_history)
+        slot.seq.store(0);
+    m_historyHead.store(0);
+    QMutexLocker locker(&m_linkMutex);
+    m_link = LinkStats();
+}
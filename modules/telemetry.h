@@ -0,0 +1,139 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+
+// 延迟直方图：对数分桶（每个 2 的幂分 4 个子桶，相对误差 < 25%），单位 us
+// record() 只做原子累加，可在任意线程无锁调用；snapshot() 读取时再统计分位数
+class LatencyHistogram
+{
+public:
+    static const int BucketCount = 96;      // 覆盖到约 2^24 us (16 s)，更大的计入最后一桶
+
+    struct Snapshot {
+        quint64 count = 0;
+        double  mean = 0;
+        qint64  p50 = 0;
+        qint64  p90 = 0;
+        qint64  p99 = 0;
+        qint64  max = 0;
+    };
+
+    LatencyHistogram();
+    void record(qint64 us);
+    Snapshot snapshot() const;
+    void reset();
+
+    static int bucketOf(qint64 us);
+    static qint64 bucketUpper(int index);
+
+private:
+    std::atomic<quint64> m_buckets[BucketCount];
+    std::atomic<quint64> m_count{0};
+    std::atomic<qint64>  m_sum{0};
+    std::atomic<qint64>  m_max{0};
+};
+
+// 单路相机的采集遥测：逐帧记录设备帧号/时间戳、主机到达时间、帧号跳变和各阶段耗时，
+// 并定期采样 SDK 链路统计（丢包、重发）。逐帧数据写入定长历史环，可导出为日志
+class StreamTelemetry
+{
+public:
+    enum Stage {
+        FrameInterval,      // 相邻两帧主机到达间隔
+        Convert,            // 像素格式转换
+        Analyze,            // 画面统计
+        Dispatch,           // 分发到帧队列和各消费者
+        ToPreview,          // 到达 -> 预览缩放完成
+        ToDisplay,          // 到达 -> 界面显示
+        StageCount
+    };
+
+    struct FrameRecord {
+        quint64      sequence = 0;
+        unsigned int frameNumber = 0;
+        unsigned int gap = 0;               // 与上一帧之间缺失的设备帧数
+        unsigned int lostPackets = 0;       // 本帧丢包数 (nLostPacket)
+        quint64      deviceTimestamp = 0;
+        qint64       hostTimestamp = 0;     // 主机到达时间(us)
+        qint32       convertUs = 0;
+        qint32       dispatchUs = 0;
+    };
+
+    // SDK 链路统计（GigE: MV_MATCH_INFO_NET_DETECT，U3V: MV_MATCH_INFO_USB_DETECT）
+    struct LinkStats {
+        bool    valid = false;
+        bool    gige = false;
+        qint64  receivedBytes = 0;
+        qint64  lostPackets = 0;
+        quint32 lostFrames = 0;
+        quint32 receivedFrames = 0;
+        quint32 errorFrames = 0;            // 仅 U3V
+        qint64  resendRequests = 0;         // 仅 GigE
+        qint64  resends = 0;                // 仅 GigE
+        qint64  sampledAt = 0;              // 采样时间(us)
+    };
+
+    struct Summary {
+        int     cameraIndex = -1;
+        quint64 frames = 0;
+        quint64 gapEvents = 0;              // 帧号跳变次数
+        quint64 missingFrames = 0;          // 跳过的设备帧总数
+        quint64 lostPackets = 0;            // 逐帧丢包累计
+        quint64 localDrops = 0;             // 本程序丢弃的帧
+        double  fps = 0;
+        qint64  firstHost = 0;
+        qint64  lastHost = 0;
+        LinkStats link;
+        LatencyHistogram::Snapshot stages[StageCount];
+    };
+
+    explicit StreamTelemetry(int cameraIndex, int historySize = 4096);
+
+    int cameraIndex() const { return m_cameraIndex; }
+    static QString stageName(Stage stage);
+
+    // 以下由抓图线程（单生产者）调用；返回值为帧号跳变数
+    unsigned int recordFrame(FrameRecord record);
+    void updateLink(const LinkStats& link);
+    // 已从 SDK 取到但被本程序丢弃的帧（转换缓存耗尽等），用于区分网络/SDK/本程序丢帧
+    void recordLocalDrop();
+    // 任意线程
+    void recordStage(Stage stage, qint64 us);
+
+    Summary summary() const;
+    QList<FrameRecord> history() const;
+    bool exportCsv(const QString& path) const;
+    void reset();
+
+private:
+    struct HistorySlot {
+        std::atomic<quint64> seq{0};        // 写入完成时为 位置+1，写入中为 0
+        FrameRecord          record;
+    };
+
+    const int m_cameraIndex;
+    LatencyHistogram m_stages[StageCount];
+
+    std::atomic<quint64> m_frames{0};
+    std::atomic<quint64> m_gapEvents{0};
+    std::atomic<quint64> m_missingFrames{0};
+    std::atomic<quint64> m_lostPackets{0};
+    std::atomic<quint64> m_localDrops{0};
+    std::atomic<qint64>  m_firstHost{0};
+    std::atomic<qint64>  m_lastHost{0};
+    unsigned int         m_lastFrameNumber = 0;     // 仅抓图线程
+    bool                 m_hasLastFrame = false;
+
+    std::vector<HistorySlot> m_history;
+    std::atomic<quint64> m_historyHead{0};
+
+    mutable QMutex m_linkMutex;             // 链路统计约 1 Hz 更新，加锁即可
+    LinkStats m_link;
+};
+
+#endif // TELEMETRY_H
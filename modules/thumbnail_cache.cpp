@@ -0,0 +1,173 @@
+#include "thumbnail_cache.h"
+#include "image_loader.h"
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QThread>
+#include <algorithm>
+
+// 磁盘缓存上限，超出时按最近使用时间（文件修改时间）删除最旧的四分之一
+static const qint64 MAX_DISK_CACHE_BYTES = qint64(256) << 20;
+// 内容键读取文件首尾各这么多字节
+static const qint64 KEY_SAMPLE_BYTES = 64 * 1024;
+
+ThumbnailCache::ThumbnailCache(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_pending(std::make_shared<std::atomic<int>>(0))
+{
+    m_directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+    QDir().mkpath(m_directory);
+    // 解码线程与界面、标定共用 CPU，只占一半
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    m_pool.start([this]() { prune(); });
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_generation.ref();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void ThumbnailCache::request(const QList<DatasetFramePtr>& frames)
+{
+    const int generation = m_generation.loadAcquire();
+    const Counter pending = m_pending;
+    for (const DatasetFramePtr& frame : frames) {
+        if (!frame || frame->hasThumbnail()) continue;
+        std::weak_ptr<const DatasetFrame> weak = frame;
+        pending->fetch_add(1);
+        m_pool.start([this, weak, generation, pending]() { generate(weak, generation, pending); });
+    }
+}
+
+void ThumbnailCache::cancel()
+{
+    m_generation.ref();
+    m_pool.clear();             // 未开始的任务直接丢弃，正在生成的任务不再计入新的计数
+    m_pending = std::make_shared<std::atomic<int>>(0);
+}
+
+ThumbnailCache::Stats ThumbnailCache::stats() const
+{
+    Stats out;
+    out.diskHits  = m_diskHits.load();
+    out.generated = m_generated.load();
+    out.failed    = m_failed.load();
+    out.pending   = m_pending->load();
+    return out;
+}
+
+void ThumbnailCache::generate(const std::weak_ptr<const DatasetFrame>& weak, int generation, const Counter& pending)
+{
+    if (generation != m_generation.loadAcquire()) {
+        pending->fetch_sub(1);
+        return;
+    }
+
+    DatasetFramePtr frame = weak.lock();        // 帧已删除时跳过
+    QImage thumbnail;
+    if (frame) {
+        thumbnail = frame->thumbnail();
+        if (thumbnail.isNull()) {
+            if (!frame->sourcePath().isEmpty())
+                thumbnail = fromFile(frame->sourcePath());
+            else
+                thumbnail = ImageLoader::thumbnail(frame->image(), m_width);
+            if (thumbnail.isNull())
+                m_failed.fetch_add(1, std::memory_order_relaxed);
+            else
+                frame->setThumbnail(thumbnail);
+        }
+    }
+    pending->fetch_sub(1);
+    if (generation != m_generation.loadAcquire()) return;
+    if (!thumbnail.isNull())
+        emit thumbnailReady(frame->id(), thumbnail);
+}
+
+QImage ThumbnailCache::fromFile(const QString& path)
+{
+    const QByteArray key = ThumbnailCache::key(path, m_width);
+    if (key.isEmpty()) return QImage();
+    const QString dir  = m_directory + "/" + QString::fromLatin1(key.left(2));
+    const QString file = dir + "/" + QString::fromLatin1(key) + ".png";
+
+    QImage cached;
+    if (cached.load(file, "PNG")) {
+        // 修改时间记录最近使用，供清理时排序
+        QFile touch(file);
+        if (touch.open(QIODevice::ReadWrite))
+            touch.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        m_diskHits.fetch_add(1, std::memory_order_relaxed);
+        return cached.convertToFormat(QImage::Format_Grayscale8);
+    }
+
+    const cv::Mat small = ImageLoader::decodeThumbnail(path, m_width);
+    if (small.empty()) return QImage();
+    QImage thumbnail = ImageLoader::grayView(small).copy();
+    if (thumbnail.isNull()) return QImage();
+
+    // 先写临时文件再改名，其他进程不会读到写了一半的缓存
+    QDir().mkpath(dir);
+    const QString temp = file + QString(".%1.tmp").arg(quintptr(QThread::currentThreadId()));
+    if (!thumbnail.save(temp, "PNG") || !QFile::rename(temp, file))
+        QFile::remove(temp);        // 写入失败或其他线程已生成同一张
+    m_generated.fetch_add(1, std::memory_order_relaxed);
+    return thumbnail;
+}
+
+QByteArray ThumbnailCache::key(const QString& path, int width)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    const QFileInfo info(path);
+    const qint64 size = file.size();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    // 先拼成 QByteArray：addData(const char*, int) 在 Qt 6.4 起已弃用
+    QByteArray header;
+    header.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    header.append(reinterpret_cast<const char*>(&modified), sizeof(modified));
+    header.append(reinterpret_cast<const char*>(&width), sizeof(width));
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(header);
+    hash.addData(file.read(KEY_SAMPLE_BYTES));
+    if (size > KEY_SAMPLE_BYTES) {
+        file.seek(qMax(KEY_SAMPLE_BYTES, size - KEY_SAMPLE_BYTES));
+        hash.addData(file.read(KEY_SAMPLE_BYTES));
+    }
+    return hash.result().toHex();
+}
+
+void ThumbnailCache::prune()
+{
+    struct Entry {
+        QString path;
+        qint64  size;
+        qint64  used;
+    };
+    std::vector<Entry> entries;
+    qint64 total = 0;
+    QDirIterator it(m_directory, { "*.png", "*.tmp" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        entries.push_back({ info.filePath(), info.size(), info.lastModified().toMSecsSinceEpoch() });
+        total += info.size();
+    }
+    if (total <= MAX_DISK_CACHE_BYTES) return;
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& e : entries) {
+        if (total <= MAX_DISK_CACHE_BYTES * 3 / 4) break;
+        if (QFile::remove(e.path))
+            total -= e.size;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QImage>
+#include <QString>
+#include <QAtomicInt>
+#include <atomic>
+#include <memory>
+#include "dataset_store.h"
+
+// 后台缩略图生成 + 磁盘缓存：
+//   图像文件按内容键（文件大小、修改时间、首尾各 64 KB 的 SHA-1）在缓存目录中查找，
+//   未命中时降分辨率解码（JPEG 在解码阶段直接缩小）生成并写入缓存，重新打开同一数据集时直接读缓存
+//   录制帧从映射区缩小，不写磁盘
+// 每张完成即在工作线程中发出 thumbnailReady，界面逐张显示图标
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 diskHits = 0;
+        quint64 generated = 0;
+        quint64 failed = 0;
+        int     pending = 0;
+    };
+
+    explicit ThumbnailCache(QObject* parent = nullptr);
+    ~ThumbnailCache() override;
+
+    void setWidth(int width) { m_width = width; }
+    int  width() const { return m_width; }
+    QString directory() const { return m_directory; }
+
+    // 已有缩略图的帧直接跳过；请求按顺序执行
+    void request(const QList<DatasetFramePtr>& frames);
+    void cancel();
+    Stats stats() const;
+
+    // 可在任意线程调用；文件无法读取时返回空
+    static QByteArray key(const QString& path, int width);
+
+signals:
+    // 在工作线程中发出
+    void thumbnailReady(quint64 frameId, const QImage& thumbnail);
+
+private:
+    using Counter = std::shared_ptr<std::atomic<int>>;
+
+    void generate(const std::weak_ptr<const DatasetFrame>& weak, int generation, const Counter& pending);
+    QImage fromFile(const QString& path);
+    void prune();
+
+    QThreadPool m_pool;
+    QString     m_directory;
+    int         m_width = 160;
+    QAtomicInt  m_generation;
+    // 当前一代排队和正在生成的任务数；取消时换新的计数，旧任务只减旧计数（只在界面线程中替换）
+    Counter     m_pending;
+    std::atomic<quint64> m_diskHits{0};
+    std::atomic<quint64> m_generated{0};
+    std::atomic<quint64> m_failed{0};
+};
+
+#endif // THUMBNAIL_CACHE_H
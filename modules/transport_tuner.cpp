@@ -0,0 +1,207 @@
+#include "transport_tuner.h"
+#include <QThread>
+#include <QElapsedTimer>
+
+// 标准以太网 MTU 对应的包长，探测失败时的保底值
+static const int DEFAULT_PACKET_SIZE = 1500;
+// GevSCPSPacketSize 包含 IP(20) + UDP(8) + GVSP(8) 包头
+static const int GVSP_HEADER_BYTES = 36;
+static const int DEFAULT_LINK_SPEED_MBPS = 1000;
+static const qint64 DEFAULT_TICK_FREQUENCY = 1000000000;    // 海康 GigE 相机 GevSCPD 单位为 ns
+
+// 按节点的范围和步长取整
+static int64_t alignToNode(int64_t value, const MVCC_INTVALUE_EX& node)
+{
+    if (node.nMax > node.nMin)
+        value = qBound<int64_t>(node.nMin, value, node.nMax);
+    if (node.nInc > 1)
+        value = node.nMin + (value - node.nMin) / node.nInc * node.nInc;
+    return value;
+}
+
+QString TransportTuner::Result::summary() const
+{
+    QString text = QString("包长 %1%2，包间延时 %3，重传%4")
+                       .arg(packetSize)
+                       .arg(jumbo ? QString("(巨型帧)") : QString())
+                       .arg(packetDelay)
+                       .arg(resendEnabled ? QString("开启") : QString("关闭"));
+    if (rejectedPacketSize > 0)
+        text += QString("（相机拒绝包长 %1，已退回）").arg(rejectedPacketSize);
+    if (camerasOnLink > 1)
+        text += QString("，同网口 %1 台相机").arg(camerasOnLink);
+    if (verified) {
+        text += QString("；实测 %1 MB/s (可用 %2 MB/s)，%3 帧，丢包率 %4%，重传 %5 包")
+                    .arg(achievedMBps, 0, 'f', 1)
+                    .arg(linkShareMBps, 0, 'f', 1)
+                    .arg(frames)
+                    .arg(packetLossRate * 100.0, 0, 'f', 3)
+                    .arg(resendPackets);
+        if (lostFrames)
+            text += QString("，丢帧 %1").arg(lostFrames);
+    }
+    if (!error.isEmpty())
+        text += QString("；%1").arg(error);
+    return text;
+}
+
+qint64 TransportTuner::packetDelayTicks(int packetSize, int camerasOnLink, int linkSpeedMbps, qint64 tickFrequency)
+{
+    if (camerasOnLink <= 1 || packetSize <= 0 || linkSpeedMbps <= 0 || tickFrequency <= 0)
+        return 0;
+    // 一个包在线路上的时间 (s) = 包长(bit) / 链路速率(bit/s)
+    const double packetSeconds = packetSize * 8.0 / (linkSpeedMbps * 1e6);
+    return qint64(packetSeconds * (camerasOnLink - 1) * tickFrequency * 1.1 + 0.5);
+}
+
+TransportTuner::Result TransportTuner::tune(CMvCamera* camera, const Options& options)
+{
+    Result result;
+    result.camerasOnLink = qMax(1, options.camerasOnLink);
+    if (!camera || !camera->IsDeviceConnected()) {
+        result.error = QString("设备未打开");
+        return result;
+    }
+
+    int ret = applyPacketSize(camera, result);
+    if (ret != MV_OK) {
+        result.error = QString("设置包长失败: 0x%1").arg(static_cast<unsigned int>(ret), 0, 16);
+        return result;
+    }
+    result.ok = true;
+
+    ret = applyPacketDelay(camera, options, result);
+    if (ret != MV_OK && result.error.isEmpty())
+        result.error = QString("设置包间延时失败: 0x%1").arg(static_cast<unsigned int>(ret), 0, 16);
+
+    // 重传次数和间隔必须在开启重传之后设置
+    ret = camera->SetResend(1, options.resendPercent, options.resendTimeoutMs);
+    if (ret == MV_OK) {
+        result.resendEnabled = true;
+        camera->SetResendMaxRetryTimes(options.resendRetries);
+        camera->SetResendTimeInterval(options.resendIntervalMs);
+    } else if (result.error.isEmpty()) {
+        result.error = QString("开启重传失败: 0x%1").arg(static_cast<unsigned int>(ret), 0, 16);
+    }
+
+    if (options.verifyMs > 0 && !m_abort.loadAcquire())
+        verify(camera, options, result);
+    return result;
+}
+
+// 优先用 SDK 探测的最佳包长（网卡开启巨型帧时大于 1500），失败或写入被拒时退回 1500
+int TransportTuner::applyPacketSize(CMvCamera* camera, Result& result)
+{
+    unsigned int optimal = 0;
+    if (camera->GetOptimalPacketSize(&optimal) != MV_OK || optimal == 0)
+        optimal = DEFAULT_PACKET_SIZE;
+
+    MVCC_INTVALUE_EX node{};
+    const bool hasRange = camera->GetIntValue("GevSCPSPacketSize", &node) == MV_OK;
+    int64_t packetSize = hasRange ? alignToNode(optimal, node) : int64_t(optimal);
+
+    int ret = camera->SetIntValue("GevSCPSPacketSize", packetSize);
+    if (ret != MV_OK && packetSize != DEFAULT_PACKET_SIZE) {
+        result.rejectedPacketSize = int(packetSize);
+        packetSize = hasRange ? alignToNode(DEFAULT_PACKET_SIZE, node) : DEFAULT_PACKET_SIZE;
+        ret = camera->SetIntValue("GevSCPSPacketSize", packetSize);
+    }
+    if (ret != MV_OK) return ret;
+
+    result.packetSize = int(packetSize);
+    result.jumbo = packetSize > DEFAULT_PACKET_SIZE;
+    return MV_OK;
+}
+
+int TransportTuner::applyPacketDelay(CMvCamera* camera, const Options& options, Result& result)
+{
+    MVCC_INTVALUE_EX value{};
+    result.linkSpeedMbps = options.linkSpeedMbps;
+    if (result.linkSpeedMbps <= 0)
+        result.linkSpeedMbps = camera->GetIntValue("GevLinkSpeed", &value) == MV_OK && value.nCurValue > 0
+                                   ? int(value.nCurValue) : DEFAULT_LINK_SPEED_MBPS;
+
+    qint64 tickFrequency = DEFAULT_TICK_FREQUENCY;
+    if (camera->GetIntValue("GevTimestampTickFrequency", &value) == MV_OK && value.nCurValue > 0)
+        tickFrequency = value.nCurValue;
+
+    int64_t delay = packetDelayTicks(result.packetSize, result.camerasOnLink, result.linkSpeedMbps, tickFrequency);
+    MVCC_INTVALUE_EX node{};
+    if (camera->GetIntValue("GevSCPD", &node) == MV_OK)
+        delay = alignToNode(delay, node);
+
+    const int ret = camera->SetIntValue("GevSCPD", delay);
+    if (ret == MV_OK)
+        result.packetDelay = delay;
+    return ret;
+}
+
+// 短时取流：统计收到的字节和帧数，并用 SDK 链路统计的前后差值得到丢包和重传
+void TransportTuner::verify(CMvCamera* camera, const Options& options, Result& result)
+{
+    int ret = camera->StartGrabbing();
+    if (ret != MV_OK) {
+        result.error = QString("验证取流失败: 0x%1").arg(static_cast<unsigned int>(ret), 0, 16);
+        return;
+    }
+
+    // 链路统计在 Start/Stop 之间累计，取流开始后立即取基准
+    MV_MATCH_INFO_NET_DETECT before{};
+    const bool hasMatchInfo = camera->GetGevAllMatchInfo(&before) == MV_OK;
+
+    FramePool* pool = camera->GetFramePool();
+    qint64 firstFrameBytes = 0, frameLostPackets = 0;
+    qint64 firstAtNs = -1, lastAtNs = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < options.verifyMs && !m_abort.loadAcquire()) {
+        FrameHandle buffer = pool->acquire();
+        if (buffer.isNull()) {
+            QThread::usleep(500);
+            continue;
+        }
+        MV_FRAME_OUT_INFO_EX info{};
+        ret = camera->GetOneFrameTimeout(buffer.data(), static_cast<unsigned int>(buffer.capacity()), &info, 100);
+        if (ret != MV_OK) continue;
+
+        const qint64 now = timer.nsecsElapsed();
+        if (firstAtNs < 0) {
+            firstAtNs = now;
+            firstFrameBytes = info.nFrameLen;
+        }
+        lastAtNs = now;
+        ++result.frames;
+        result.bytes += info.nFrameLen;
+        frameLostPackets += info.nLostPacket;
+    }
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    MV_MATCH_INFO_NET_DETECT after{};
+    const bool hasAfter = hasMatchInfo && camera->GetGevAllMatchInfo(&after) == MV_OK;
+    camera->StopGrabbing();
+
+    // 吞吐按首帧到末帧计算，排除启动取流的等待时间
+    if (result.frames >= 2 && lastAtNs > firstAtNs)
+        result.achievedMBps = (result.bytes - firstFrameBytes) / ((lastAtNs - firstAtNs) / 1e9) / 1e6;
+    else if (result.elapsedMs > 0)
+        result.achievedMBps = result.bytes / (result.elapsedMs / 1e3) / 1e6;
+    result.linkShareMBps = result.linkSpeedMbps / 8.0 / result.camerasOnLink;
+
+    // 每帧另有 leader/trailer 两个包
+    const int payloadPerPacket = qMax(1, result.packetSize - GVSP_HEADER_BYTES);
+    result.packets = (result.bytes + payloadPerPacket - 1) / payloadPerPacket + 2 * qint64(result.frames);
+    if (hasAfter) {
+        result.lostPackets   = qMax<int64_t>(0, after.nLostPacketCount - before.nLostPacketCount);
+        result.resendPackets = qMax<int64_t>(0, after.nResendPacketCount - before.nResendPacketCount);
+        result.lostFrames    = after.nLostFrameCount >= before.nLostFrameCount
+                                   ? after.nLostFrameCount - before.nLostFrameCount : 0;
+    } else {
+        result.lostPackets = frameLostPackets;
+    }
+    if (result.packets + result.lostPackets > 0)
+        result.packetLossRate = double(result.lostPackets) / double(result.packets + result.lostPackets);
+
+    result.verified = result.frames > 0;
+    if (!result.verified && result.error.isEmpty() && !m_abort.loadAcquire())
+        result.error = QString("验证取流 %1 ms 内未收到图像").arg(options.verifyMs);
+}
@@ -0,0 +1,67 @@
+#ifndef TRANSPORT_TUNER_H
+#define TRANSPORT_TUNER_H
+
+#include <QString>
+#include <QAtomicInt>
+#include "cmvcamera.h"
+
+// GigE 传输参数自动调优：探测最佳包长（网卡支持时用巨型帧），按共享同一网口的相机数
+// 设置包间延时 GevSCPD，开启并设定丢包重传，最后短时取流验证实际吞吐和丢包率
+// 所有步骤都是阻塞的 SDK 调用（验证取流默认约 1.5 s），应在工作线程中执行，且须在开始采集之前
+class TransportTuner
+{
+public:
+    struct Options {
+        int          camerasOnLink = 1;     // 共享同一主机网口的相机数（含本机）
+        int          linkSpeedMbps = 0;     // 链路速率，0 表示读取 GevLinkSpeed，读不到按千兆
+        unsigned int resendPercent = 10;    // 最大重传包比例 (%)
+        unsigned int resendTimeoutMs = 50;  // 等待重传包的超时
+        unsigned int resendRetries = 3;
+        unsigned int resendIntervalMs = 10;
+        int          verifyMs = 1500;       // 验证取流时长，0 表示不验证
+    };
+
+    struct Result {
+        bool    ok = false;                 // 包长已设置成功
+        int     packetSize = 0;             // GevSCPSPacketSize（含 IP/UDP/GVSP 包头）
+        bool    jumbo = false;
+        int     rejectedPacketSize = 0;     // 相机拒绝的探测包长（已退回 1500），0 表示未退回
+        qint64  packetDelay = 0;            // GevSCPD (tick)
+        int     linkSpeedMbps = 0;
+        int     camerasOnLink = 1;
+        bool    resendEnabled = false;
+
+        bool    verified = false;
+        quint32 frames = 0;
+        qint64  bytes = 0;
+        double  elapsedMs = 0;
+        double  achievedMBps = 0;
+        double  linkShareMBps = 0;          // 本相机可用的链路带宽
+        qint64  packets = 0;                // 估算的收包数
+        qint64  lostPackets = 0;
+        qint64  resendPackets = 0;
+        quint32 lostFrames = 0;
+        double  packetLossRate = 0;         // lostPackets / (packets + lostPackets)
+
+        QString error;                      // 非空时为第一个失败步骤的说明
+        QString summary() const;
+    };
+
+    TransportTuner() : m_abort(0) {}
+
+    Result tune(CMvCamera* camera, const Options& options);
+    // 任意线程调用，验证取流会尽快结束
+    void abort() { m_abort.storeRelease(1); }
+
+    // 包间延时：让出 (N-1) 个包的线路时间给其余相机，并留 10% 余量；单台相机为 0
+    static qint64 packetDelayTicks(int packetSize, int camerasOnLink, int linkSpeedMbps, qint64 tickFrequency);
+
+private:
+    int applyPacketSize(CMvCamera* camera, Result& result);
+    int applyPacketDelay(CMvCamera* camera, const Options& options, Result& result);
+    void verify(CMvCamera* camera, const Options& options, Result& result);
+
+    QAtomicInt m_abort;
+};
+
+#endif // TRANSPORT_TUNER_H